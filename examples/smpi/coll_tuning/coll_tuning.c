@@ -0,0 +1,80 @@
+/* Times a collective operation over increasing message sizes */
+
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+/* This benchmark is the one run by tools/simgrid_tune_collectives.py: with smpi/coll-selector:automatic and
+   smpi/coll-table-output set, SMPI writes which algorithm was the fastest for each call, and the resulting decision
+   table can then be given to smpi/coll-table, for smpi/coll-selector:table or smpi/<collective>:table. */
+
+static void run_collective(const char* coll, char* sbuf, char* rbuf, int count, int size)
+{
+  if (strcmp(coll, "bcast") == 0)
+    MPI_Bcast(sbuf, count, MPI_CHAR, 0, MPI_COMM_WORLD);
+  else if (strcmp(coll, "reduce") == 0)
+    MPI_Reduce(sbuf, rbuf, count, MPI_CHAR, MPI_MAX, 0, MPI_COMM_WORLD);
+  else if (strcmp(coll, "allreduce") == 0)
+    MPI_Allreduce(sbuf, rbuf, count, MPI_CHAR, MPI_MAX, MPI_COMM_WORLD);
+  else if (strcmp(coll, "gather") == 0)
+    MPI_Gather(sbuf, count, MPI_CHAR, rbuf, count, MPI_CHAR, 0, MPI_COMM_WORLD);
+  else if (strcmp(coll, "scatter") == 0)
+    MPI_Scatter(sbuf, count, MPI_CHAR, rbuf, count, MPI_CHAR, 0, MPI_COMM_WORLD);
+  else if (strcmp(coll, "allgather") == 0)
+    MPI_Allgather(sbuf, count, MPI_CHAR, rbuf, count, MPI_CHAR, MPI_COMM_WORLD);
+  else if (strcmp(coll, "alltoall") == 0)
+    MPI_Alltoall(sbuf, count, MPI_CHAR, rbuf, count, MPI_CHAR, MPI_COMM_WORLD);
+  else if (strcmp(coll, "reduce_scatter") == 0) {
+    int* rcounts = malloc(size * sizeof(int));
+    for (int i = 0; i < size; i++)
+      rcounts[i] = count;
+    MPI_Reduce_scatter(sbuf, rbuf, rcounts, MPI_CHAR, MPI_MAX, MPI_COMM_WORLD);
+    free(rcounts);
+  } else
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (argc != 3) {
+    if (rank == 0)
+      printf("Usage: %s <collective> <max message size>\n", argv[0]);
+    MPI_Finalize();
+    return 1;
+  }
+  const char* coll = argv[1];
+  int max_size     = atoi(argv[2]);
+
+  /* The buffers are large enough for the collectives that send one message of the given size to each rank */
+  char* sbuf = calloc((size_t)max_size * size, 1);
+  char* rbuf = calloc((size_t)max_size * size, 1);
+  /* The first call of some algorithms is slower as they build sub-communicators: do it once before timing anything */
+  run_collective(coll, sbuf, rbuf, 1, size);
+  for (int count = 1; count <= max_size; count *= 4) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    run_collective(coll, sbuf, rbuf, count, size);
+    double elapsed = MPI_Wtime() - start;
+    double max_elapsed;
+    MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    if (rank == 0)
+      printf("%s of %d bytes on %d ranks: %f\n", coll, count, size, max_elapsed);
+  }
+  free(sbuf);
+  free(rbuf);
+  MPI_Finalize();
+  return 0;
+}
@@ -135,6 +135,12 @@ public:
 
   virtual ~Action();
 
+  /* The actions are created and destroyed at a high pace, so their memory is recycled in pools of similar sizes */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr, std::size_t size);
+  /** @brief Free the memory pools of the actions, once all actions are destroyed (at the end of the simulation) */
+  static void free_pools();
+
   /**
    * @brief Mark that the action is now finished
    *
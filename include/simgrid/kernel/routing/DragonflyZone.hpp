@@ -92,6 +92,8 @@ public:
   /** @brief Set the characteristics of links inside the Dragonfly zone */
   void set_link_characteristics(double bw, double lat, s4u::Link::SharingPolicy sharing_policy) override;
   Coords rankId_to_coords(unsigned long rank_id) const;
+  /** @brief The group, chassis and blade of a node */
+  std::vector<unsigned long> get_location(const NetPoint* elm) const override;
 
 private:
   void generate_routers(const s4u::ClusterCallbacks& set_callbacks);
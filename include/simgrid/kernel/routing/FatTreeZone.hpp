@@ -158,6 +158,8 @@ public:
    */
   void build_upper_levels(const s4u::ClusterCallbacks& set_callbacks);
   void generate_dot_file(const std::string& filename = "fat_tree.dot") const;
+  /** @brief The subtrees containing a processing node, from the one below the topmost switches to the lowest switch */
+  std::vector<unsigned long> get_location(const NetPoint* elm) const override;
 };
 } // namespace routing
 } // namespace kernel
@@ -160,6 +160,14 @@ public:
   /** @brief Gets the netpoint associated to this netzone */
   kernel::routing::NetPoint* get_netpoint() const { return netpoint_; }
 
+  /** @brief Location of a component (host or netzone) of this netzone in its internal topology
+   *
+   * The location is given from the outermost to the innermost level of the topology, such as the group, the chassis and
+   * the blade of a dragonfly. Components whose locations share a longer prefix are closer to each other. Netzones with
+   * no internal hierarchy return an empty location.
+   */
+  virtual std::vector<unsigned long> get_location(const NetPoint* /*elm*/) const { return {}; }
+
   std::vector<s4u::Host*> get_all_hosts() const;
   size_t get_host_count() const;
 
@@ -48,6 +48,14 @@ XBT_PUBLIC void* xbt_mallocator_get(xbt_mallocator_t mallocator);
 XBT_PUBLIC void xbt_mallocator_release(xbt_mallocator_t mallocator, void* object);
 
 XBT_PUBLIC void xbt_mallocator_initialization_is_done(int protect);
+
+/** @brief Activity of a mallocator since its creation */
+typedef struct {
+  unsigned long requests; /**< number of calls to xbt_mallocator_get() */
+  unsigned long hits;     /**< number of these calls served with a recycled object */
+  int peak_footprint;     /**< maximal number of objects allocated at the same time (in use or stored) */
+} s_xbt_mallocator_stats_t;
+XBT_PUBLIC s_xbt_mallocator_stats_t xbt_mallocator_get_stats(xbt_mallocator_t mallocator);
 /** @} */
 
 SG_END_DECL
@@ -18,6 +18,8 @@
  * It is placed in this file so that it's visible from mmalloc and MC without sharing anythin of xbt in mmalloc
  */
 #define MC_ENV_SOCKET_FD "SIMGRID_MC_SOCKET_FD"
+/** File descriptor of the shared memory segment carrying the messages, with model-check/transport:shm */
+#define MC_ENV_SHM_FD "SIMGRID_MC_SHM_FD"
 
 #include <stdio.h>     /* for NULL */
 #include <sys/types.h> /* for size_t */
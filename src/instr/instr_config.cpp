@@ -12,7 +12,10 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <deque>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -25,6 +28,7 @@ std::map<const simgrid::instr::Container*, std::ofstream*> tracing_files; // TI
 constexpr char OPT_TRACING_BASIC[]             = "tracing/basic";
 constexpr char OPT_TRACING_COMMENT_FILE[]      = "tracing/comment-file";
 constexpr char OPT_TRACING_DISABLE_DESTROY[]   = "tracing/disable-destroy";
+constexpr char OPT_TRACING_FORMAT_TI_FOLD[]    = "tracing/smpi/format/ti-fold";
 constexpr char OPT_TRACING_FORMAT_TI_ONEFILE[] = "tracing/smpi/format/ti-one-file";
 constexpr char OPT_TRACING_SMPI[]              = "tracing/smpi";
 constexpr char OPT_TRACING_TOPOLOGY[]          = "tracing/platform/topology";
@@ -196,6 +200,9 @@ void TRACE_help()
              "  By default, each process outputs to a separate file, inside a filename_files folder\n"
              "  By setting this option to yes, all processes will output to only one file\n"
              "  This is meant to avoid opening thousands of files with large simulations");
+  print_line(OPT_TRACING_FORMAT_TI_FOLD, "Fold the loops of the TI traces (maximal length of the loop bodies)",
+             "  Sequences of identical actions repeated at least 3 times in a row are written once,\n"
+             "  after a '<rank> loop <iterations> <lines>' line. Loops may be nested. 0 disables it.");
   print_line(OPT_TRACING_TOPOLOGY, "Register the platform topology as a graph",
              "  This option (enabled by default) can be used to disable the tracing of\n"
              "  the platform topology in the trace file. Sometimes, such task is really\n"
@@ -257,6 +264,128 @@ static void on_container_destruction_paje(const Container& c)
   }
 }
 
+/** Online folding of the loops of a TI trace (see tracing/smpi/format/ti-fold).
+ *
+ * The units (lines or folded loops) of a container are kept in a window until they are known not to start a loop.
+ * When the last units of the window are two copies of the same sequence, that sequence becomes the body of a loop, and
+ * is matched against the following units. A loop of at least 3 iterations is written as "<rank> loop <iterations>
+ * <lines>" followed by its body, while a loop of only 2 iterations is unfolded back into the window, where it may be
+ * part of a longer body.
+ *
+ * Each folder gives its output to the folder of the next nesting level, that folds the loops made of lines and of
+ * loops folded by the previous levels.
+ */
+class TILoopFolder {
+  static constexpr int MAX_NESTING = 4;
+
+  std::ofstream* out_;
+  size_t max_length_;
+  std::unique_ptr<TILoopFolder> next_level_;
+  std::deque<std::string> pending_; // Units not given to the next level yet
+  std::vector<std::string> body_;   // Body of the current loop, if any
+  unsigned long iterations_ = 0;
+  size_t matched_           = 0; // Units of the next iteration already matched
+
+  void emit(const std::string& unit);
+  void push(const std::string& unit);
+  void end_loop();
+
+public:
+  TILoopFolder(std::ofstream* out, size_t max_length, int level = 1) : out_(out), max_length_(max_length)
+  {
+    if (level < MAX_NESTING)
+      next_level_ = std::make_unique<TILoopFolder>(out, max_length, level + 1);
+  }
+  void add(const std::string& unit);
+  void flush();
+};
+
+void TILoopFolder::emit(const std::string& unit)
+{
+  if (next_level_)
+    next_level_->add(unit);
+  else
+    *out_ << unit << '\n';
+}
+
+void TILoopFolder::add(const std::string& unit)
+{
+  if (body_.empty()) {
+    push(unit);
+    return;
+  }
+  if (unit == body_[matched_]) {
+    matched_++;
+    if (matched_ == body_.size()) {
+      iterations_++;
+      matched_ = 0;
+    }
+    return;
+  }
+  // The loop is over: the beginning of its last, incomplete iteration goes through the detection again
+  std::vector<std::string> rest(body_.begin(), body_.begin() + matched_);
+  end_loop();
+  rest.push_back(unit);
+  for (auto const& u : rest)
+    add(u);
+}
+
+void TILoopFolder::push(const std::string& unit)
+{
+  pending_.push_back(unit);
+  size_t size = pending_.size();
+  for (size_t length = 1; length <= max_length_ && 2 * length <= size; length++) {
+    if (std::equal(pending_.end() - length, pending_.end(), pending_.end() - 2 * length)) {
+      body_.assign(pending_.end() - length, pending_.end());
+      pending_.erase(pending_.end() - 2 * length, pending_.end());
+      iterations_ = 2;
+      matched_    = 0;
+      return;
+    }
+  }
+  while (pending_.size() > 2 * max_length_) {
+    emit(pending_.front());
+    pending_.pop_front();
+  }
+}
+
+void TILoopFolder::end_loop()
+{
+  if (iterations_ > 2) {
+    size_t lines = 0;
+    for (auto const& u : body_)
+      lines += std::count(u.begin(), u.end(), '\n') + 1;
+    std::string loop = body_.front().substr(0, body_.front().find(' ')) + " loop " + std::to_string(iterations_) +
+                       " " + std::to_string(lines);
+    for (auto const& u : body_)
+      loop += '\n' + u;
+    for (auto const& u : pending_)
+      emit(u);
+    pending_.clear();
+    emit(loop);
+  } else {
+    for (int i = 0; i < 2; i++)
+      pending_.insert(pending_.end(), body_.begin(), body_.end());
+  }
+  body_.clear();
+}
+
+void TILoopFolder::flush()
+{
+  if (not body_.empty()) {
+    std::vector<std::string> rest(body_.begin(), body_.begin() + matched_);
+    end_loop();
+    pending_.insert(pending_.end(), rest.begin(), rest.end());
+  }
+  for (auto const& u : pending_)
+    emit(u);
+  pending_.clear();
+  if (next_level_)
+    next_level_->flush();
+}
+
+static std::map<const Container*, TILoopFolder> ti_folders;
+
 static void on_container_creation_ti(const Container& c)
 {
   XBT_DEBUG("%s: event_type=%u, timestamp=%f", __func__, static_cast<unsigned>(PajeEventType::CreateContainer),
@@ -279,10 +408,16 @@ static void on_container_creation_ti(const Container& c)
     tracing_file << filename << '\n';
   }
   tracing_files.insert({&c, ti_unique_file});
+  if (int fold = simgrid::config::get_value<int>(OPT_TRACING_FORMAT_TI_FOLD); fold > 0)
+    ti_folders.try_emplace(&c, ti_unique_file, fold);
 }
 
 static void on_container_destruction_ti(const Container& c)
 {
+  if (auto folder = ti_folders.find(&c); folder != ti_folders.end()) {
+    folder->second.flush();
+    ti_folders.erase(folder);
+  }
   if (not trace_disable_destroy && &c != Container::get_root()) {
     if (not simgrid::config::get_value<bool>("tracing/smpi/format/ti-one-file") || tracing_files.size() == 1) {
       tracing_files.at(&c)->close();
@@ -321,8 +456,15 @@ static void on_event_destruction(const PajeEvent& event)
 
 static void on_state_event_destruction(const StateEvent& event)
 {
-  if (event.has_extra())
+  if (not event.has_extra())
+    return;
+  if (auto folder = ti_folders.find(event.get_container()); folder != ti_folders.end()) {
+    std::istringstream lines(event.stream_.str());
+    for (std::string line; std::getline(lines, line);)
+      folder->second.add(line);
+  } else {
     *tracing_files.at(event.get_container()) << event.stream_.str() << '\n';
+  }
 }
 
 static void on_type_creation(const Type& type, PajeEventType event_type)
@@ -446,6 +588,10 @@ void init()
 
   config::declare_flag<bool>(OPT_TRACING_FORMAT_TI_ONEFILE,
                              "(smpi only) For replay format only : output to one file only", false);
+  config::declare_flag<int>(OPT_TRACING_FORMAT_TI_FOLD,
+                            "(smpi only) For replay format only : fold the loops whose body has at most that amount of "
+                            "actions (0: disabled)",
+                            0);
   config::declare_flag<std::string>("tracing/comment", "Add a comment line to the top of the trace file.", "");
   config::declare_flag<std::string>(OPT_TRACING_COMMENT_FILE,
                                     "Add the contents of a file as comments to the top of the trace.", "");
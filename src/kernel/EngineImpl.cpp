@@ -275,6 +275,8 @@ void EngineImpl::shutdown()
 
   delete instance_;
   instance_ = nullptr;
+
+  resource::Action::free_pools();
 }
 
 void EngineImpl::seal_platform() const
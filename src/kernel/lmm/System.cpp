@@ -9,7 +9,10 @@
 #include "src/kernel/lmm/bmf.hpp"
 #endif
 #include <boost/core/demangle.hpp>
+#include <algorithm>
 #include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(ker_lmm, kernel, "Kernel Linear Max-Min solver");
 
@@ -280,9 +283,9 @@ void System::expand(Constraint* cnst, Variable* var, double consumption_weight,
   modified_ = true;
 
   auto elem_it =
-      std::find_if(begin(var->cnsts_), end(var->cnsts_), [&cnst](Element const& x) { return x.constraint == cnst; });
+      std::find_if(var->cnsts_.begin(), var->cnsts_.end(), [&cnst](Element const& x) { return x.constraint == cnst; });
 
-  bool reuse_elem = elem_it != end(var->cnsts_) && not force_creation;
+  bool reuse_elem = elem_it != var->cnsts_.end() && not force_creation;
   if (reuse_elem && var->sharing_penalty_ != 0.0) {
     /* before changing it, decreases concurrency on constraint, it'll be added back later */
     elem_it->decrease_concurrency();
@@ -314,6 +317,103 @@ void System::expand(Constraint* cnst, Variable* var, double consumption_weight,
   check_concurrency();
 }
 
+/* Below that size, looking for the element of a given constraint is faster with a linear search than with a map */
+static constexpr size_t SMALL_ELEMENT_LIST = 16;
+
+static size_t count_distinct_constraints(const System::ElementList& elements)
+{
+  if (elements.size() <= SMALL_ELEMENT_LIST) {
+    size_t count = 0;
+    for (auto it = elements.begin(); it != elements.end(); ++it)
+      if (std::none_of(elements.begin(), it, [it](auto const& prev) { return prev.first == it->first; }))
+        count++;
+    return count;
+  }
+  std::unordered_set<const Constraint*> distinct;
+  for (auto const& [cnst, _] : elements)
+    distinct.insert(cnst);
+  return distinct.size();
+}
+
+void System::expand(Variable* var, const ElementList& elements, bool force_creation)
+{
+  if (elements.empty())
+    return;
+  modified_ = true;
+
+  /* Position in var->cnsts_ of the element on each constraint, only built for the long lists */
+  std::unordered_map<const Constraint*, size_t> positions;
+  bool use_map = not force_creation && var->cnsts_.size() + elements.size() > SMALL_ELEMENT_LIST;
+  if (use_map)
+    for (size_t i = 0; i < var->cnsts_.size(); i++)
+      positions.try_emplace(var->cnsts_[i].constraint, i);
+  auto find_elem = [var, use_map, &positions](const Constraint* cnst) -> Element* {
+    if (use_map) {
+      auto pos = positions.find(cnst);
+      return pos == positions.end() ? nullptr : &var->cnsts_[pos->second];
+    }
+    auto elem_it =
+        std::find_if(var->cnsts_.begin(), var->cnsts_.end(), [cnst](Element const& x) { return x.constraint == cnst; });
+    return elem_it == var->cnsts_.end() ? nullptr : &*elem_it;
+  };
+
+  /* Create or update all elements first, without taking care of the concurrency */
+  const size_t first_new = var->cnsts_.size();
+  std::vector<Element*> reused; // the elements that were already there before this call, and that we modify
+  for (auto const& [cnst, consumption_weight] : elements) {
+    Element* elem = force_creation ? nullptr : find_elem(cnst);
+    if (elem == nullptr) {
+      expand_create_elem(cnst, var, consumption_weight);
+      if (use_map)
+        positions.try_emplace(cnst, var->cnsts_.size() - 1);
+      continue;
+    }
+    if (static_cast<size_t>(elem - var->cnsts_.data()) < first_new &&
+        std::find(reused.begin(), reused.end(), elem) == reused.end()) {
+      /* before changing it, decreases concurrency on constraint, it'll be added back later */
+      if (var->sharing_penalty_ != 0.0)
+        elem->decrease_concurrency();
+      reused.push_back(elem);
+    }
+    expand_add_to_elem(*elem, cnst, consumption_weight);
+  }
+  for (size_t i = first_new; i < var->cnsts_.size(); i++)
+    reused.push_back(&var->cnsts_[i]);
+
+  /* Then increase the concurrency of the constraints, and disable the variable if one of them is over its limit */
+  if (var->sharing_penalty_ != 0) {
+    bool over_limit = false;
+    for (Element* elem : reused) {
+      elem->increase_concurrency(false);
+      over_limit = over_limit || elem->constraint->get_concurrency_slack() < 0;
+    }
+    if (over_limit) {
+      double penalty = var->sharing_penalty_;
+      disable_var(var);
+      for (Element const& elem : var->cnsts_)
+        on_disabled_var(elem.constraint);
+      var->staged_sharing_penalty_ = penalty;
+      xbt_assert(not var->sharing_penalty_);
+    }
+  }
+
+  /* update modified constraint set accordingly */
+  for (Element const* elem : reused)
+    if (elem->consumption_weight > 0 || var->sharing_penalty_ > 0)
+      update_modified_cnst_set(elem->constraint);
+
+  check_concurrency();
+}
+
+Variable* System::variable_new_with_elements(resource::Action* id, double sharing_penalty, double bound,
+                                             const ElementList& elements, size_t extra_constraints)
+{
+  /* The elements cannot move once they are linked to their constraint, so reserve the exact room they need */
+  Variable* var = variable_new(id, sharing_penalty, bound, count_distinct_constraints(elements) + extra_constraints);
+  expand(var, elements);
+  return var;
+}
+
 Variable* Constraint::get_variable(const Element** elem) const
 {
   if (*elem == nullptr) {
@@ -14,11 +14,13 @@
 #include "xbt/ex.h"
 #include "xbt/mallocator.h"
 
+#include <boost/container/small_vector.hpp>
 #include <boost/intrusive/list.hpp>
 #include <cmath>
 #include <limits>
 #include <memory>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace simgrid::kernel::lmm {
@@ -376,7 +378,10 @@ public:
   boost::intrusive::list_member_hook<> variable_set_hook_;
   boost::intrusive::list_member_hook<> saturated_variable_set_hook_;
 
-  std::vector<Element> cnsts_;
+  /* Most variables use a few constraints only (a CPU, or the links of a short route): store their elements inline so
+   * that recycling a variable never hits the heap. The elements must not move once linked, see System::expand(). */
+  static constexpr size_t INLINE_ELEMENTS = 8;
+  boost::container::small_vector<Element, INLINE_ELEMENTS> cnsts_;
 
   // sharing_penalty: variable's impact on the resource during the sharing
   //   if == 0, the variable is not considered by LMM
@@ -460,6 +465,9 @@ public:
   /** @brief Free all variables */
   void variable_free_all();
 
+  /** @brief Get the activity of the pool recycling the variables (requests, hits and peak footprint) */
+  s_xbt_mallocator_stats_t get_variable_pool_stats() const { return xbt_mallocator_get_stats(variable_mallocator_); }
+
   /**
    * @brief Associate a variable to a constraint with a coefficient
    * @param cnst A constraint
@@ -471,6 +479,28 @@ public:
    */
   void expand(Constraint* cnst, Variable* var, double value, bool force_creation = false);
 
+  /** @brief A list of constraints with the coefficient of a variable in each of them */
+  using ElementList = std::vector<std::pair<Constraint*, double>>;
+
+  /**
+   * @brief Associate a variable to several constraints at once
+   *
+   * This is equivalent to calling expand() on each element of the list, but the concurrency of the constraints and the
+   * modified constraint set are only updated once. The elements on the same constraint are merged as in expand().
+   */
+  void expand(Variable* var, const ElementList& elements, bool force_creation = false);
+
+  /**
+   * @brief Create a new Linear MaxMin variable and associate it to the given constraints
+   * @param id Data associated to the variable (e.g.: a network communication)
+   * @param sharing_penalty The weight of the variable (0.0 if not used)
+   * @param bound The maximum value of the variable (-1.0 if no maximum value)
+   * @param elements The constraints of the variable, with the coefficient of the variable in each of them
+   * @param extra_constraints Amount of constraints that will be added later on with expand()
+   */
+  Variable* variable_new_with_elements(resource::Action* id, double sharing_penalty, double bound,
+                                       const ElementList& elements, size_t extra_constraints = 0);
+
   /** @brief Update the bound of a variable */
   void update_variable_bound(Variable * var, double bound);
 
@@ -21,9 +21,9 @@ void simgrid::kernel::lmm::FairBottleneck::do_solve()
   for (Variable& var : variable_set) {
     var.value_ = 0.0;
     XBT_DEBUG("Handling variable %p", &var);
-    if (var.sharing_penalty_ > 0.0 && std::find_if(begin(var.cnsts_), end(var.cnsts_), [](Element const& x) {
+    if (var.sharing_penalty_ > 0.0 && std::find_if(std::begin(var.cnsts_), std::end(var.cnsts_), [](Element const& x) {
                                         return x.consumption_weight != 0.0;
-                                      }) != end(var.cnsts_)) {
+                                      }) != std::end(var.cnsts_)) {
       saturated_variable_set.push_back(var);
     } else {
       XBT_DEBUG("Err, finally, there is no need to take care of variable %p", &var);
@@ -3,6 +3,7 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include "simgrid/config.h"
 #include "src/include/catch.hpp"
 #include "src/kernel/lmm/maxmin.hpp"
 #include "src/surf/surf_interface.hpp"
@@ -464,4 +465,111 @@ TEST_CASE("kernel::lmm shared systems with crosstraffic", "[kernel-lmm-shared-cr
   }
 
   Sys.variable_free_all();
-}
\ No newline at end of file
+}
+
+TEST_CASE("kernel::lmm variables created with all their elements at once", "[kernel-lmm-bulk-expand]")
+{
+  lmm::MaxMin Sys(false);
+
+  SECTION("Same system as with expand()")
+  {
+    /*
+     * Same system as "3 flows, 3 resource: crosstraffic", but built with variable_new_with_elements().
+     * The elements of rho1 on the second constraint are given in two parts, that must be merged.
+     */
+    lmm::Constraint* sys_cnst  = Sys.constraint_new(nullptr, 1);
+    lmm::Constraint* sys_cnst2 = Sys.constraint_new(nullptr, 1);
+
+    double epsilon       = 0.05;
+    lmm::Variable* rho_1 = Sys.variable_new_with_elements(
+        nullptr, 1, -1, {{sys_cnst, 1.0}, {sys_cnst2, epsilon / 2}, {sys_cnst2, epsilon / 2}});
+    lmm::Variable* rho_2 = Sys.variable_new_with_elements(nullptr, 1, -1, {{sys_cnst, 1.0}, {sys_cnst2, epsilon}});
+    lmm::Variable* rho_3 = Sys.variable_new_with_elements(nullptr, 1, -1, {{sys_cnst2, 1.0}, {sys_cnst, epsilon}});
+    Sys.solve();
+
+    REQUIRE(rho_1->get_number_of_constraint() == 2);
+    REQUIRE(double_equals(rho_1->get_constraint_weight(1), epsilon, sg_maxmin_precision));
+    REQUIRE(double_equals(rho_1->get_value(), 1.0 / (2.0 + epsilon), sg_maxmin_precision));
+    REQUIRE(double_equals(rho_2->get_value(), 1.0 / (2.0 + epsilon), sg_maxmin_precision));
+    REQUIRE(double_equals(rho_3->get_value(), 1.0 / (2.0 + epsilon), sg_maxmin_precision));
+  }
+
+  SECTION("Long element lists")
+  {
+    /*
+     * A variable going twice through 20 constraints gets one element on each of them
+     *
+     * In details:
+     *   o System:  2 * \rho1 < C_i for each of the 20 constraints, with C_i = i+1
+     *
+     * Expectations
+     *   o rho1 = C_0 / 2
+     */
+    lmm::System::ElementList elements;
+    for (int i = 0; i < 20; i++)
+      elements.emplace_back(Sys.constraint_new(nullptr, i + 1), 1.0);
+    elements.insert(elements.end(), elements.begin(), elements.end());
+
+    lmm::Variable* rho_1 = Sys.variable_new_with_elements(nullptr, 1, -1, elements);
+    Sys.solve();
+
+    REQUIRE(rho_1->get_number_of_constraint() == 20);
+    REQUIRE(double_equals(rho_1->get_value(), 0.5, sg_maxmin_precision));
+  }
+
+  SECTION("Concurrency limit")
+  {
+    /*
+     * The second variable cannot use a constraint of concurrency 1 that is already used: it is staged until the first
+     * variable terminates.
+     */
+    lmm::Constraint* sys_cnst  = Sys.constraint_new(nullptr, 1);
+    lmm::Constraint* sys_cnst2 = Sys.constraint_new(nullptr, 1);
+    sys_cnst2->set_concurrency_limit(1);
+
+    lmm::Variable* rho_1 = Sys.variable_new_with_elements(nullptr, 1, -1, {{sys_cnst, 1.0}, {sys_cnst2, 1.0}});
+    lmm::Variable* rho_2 = Sys.variable_new_with_elements(nullptr, 1, -1, {{sys_cnst, 1.0}, {sys_cnst2, 1.0}});
+    Sys.solve();
+
+    REQUIRE(double_equals(rho_1->get_value(), 1, sg_maxmin_precision));
+    REQUIRE(double_equals(rho_2->get_value(), 0, sg_maxmin_precision));
+    REQUIRE(rho_2->get_penalty() == 0);
+
+    Sys.variable_free(rho_1);
+    Sys.solve();
+    REQUIRE(double_equals(rho_2->get_value(), 1, sg_maxmin_precision));
+  }
+
+  Sys.variable_free_all();
+}
+
+TEST_CASE("kernel::lmm pool of the variables", "[kernel-lmm-pool]")
+{
+  xbt_mallocator_initialization_is_done(0); // Done by the engine in a simulation
+  lmm::MaxMin Sys(false);
+  lmm::Constraint* sys_cnst = Sys.constraint_new(nullptr, 1);
+
+  std::vector<lmm::Variable*> vars;
+  for (int i = 0; i < 10; i++)
+    vars.push_back(Sys.variable_new_with_elements(nullptr, 1, -1, {{sys_cnst, 1.0}}));
+  s_xbt_mallocator_stats_t stats = Sys.get_variable_pool_stats();
+  REQUIRE(stats.requests == 10);
+#if SIMGRID_HAVE_MALLOCATOR
+  REQUIRE(stats.peak_footprint >= 10);
+#endif
+  int peak_footprint = stats.peak_footprint;
+
+  /* The freed variables are given back by the next requests, without allocating more of them */
+  for (lmm::Variable* var : vars)
+    Sys.variable_free(var);
+  for (int i = 0; i < 10; i++)
+    Sys.variable_new_with_elements(nullptr, 1, -1, {{sys_cnst, 1.0}});
+  stats = Sys.get_variable_pool_stats();
+  REQUIRE(stats.requests == 20);
+#if SIMGRID_HAVE_MALLOCATOR
+  REQUIRE(stats.hits >= 10);
+#endif
+  REQUIRE(stats.peak_footprint == peak_footprint);
+
+  Sys.variable_free_all();
+}
@@ -8,12 +8,69 @@
 #include "src/kernel/EngineImpl.hpp"
 #include "src/kernel/lmm/maxmin.hpp"
 #include "src/surf/surf_interface.hpp"
+#include "xbt/mallocator.h"
+
+#include <array>
+#include <utility>
 
 XBT_LOG_NEW_CATEGORY(kernel, "SimGrid internals");
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(ker_resource, kernel, "Resources, modeling the platform performance");
 
 namespace simgrid::kernel::resource {
 
+/* The actions of the different models have different sizes, so recycle them in pools of blocks of a few size classes.
+ * Larger actions are directly allocated. */
+static constexpr std::size_t ACTION_SIZE_CLASS   = 64;
+static constexpr std::size_t ACTION_SIZE_CLASSES = 16;
+static constexpr int ACTION_POOL_SIZE            = 4096;
+static std::array<xbt_mallocator_t, ACTION_SIZE_CLASSES> action_pools;
+static bool action_pools_created = false; // Reset by free_pools(), for the pools to be recreated by the next engine
+
+template <std::size_t N> static void* action_block_new()
+{
+  return ::operator new((N + 1) * ACTION_SIZE_CLASS);
+}
+static void action_block_free(void* block)
+{
+  ::operator delete(block);
+}
+template <std::size_t... N> static bool action_pools_create(std::index_sequence<N...>)
+{
+  ((action_pools[N] = xbt_mallocator_new(ACTION_POOL_SIZE, action_block_new<N>, action_block_free, nullptr)), ...);
+  return true;
+}
+
+void* Action::operator new(std::size_t size)
+{
+  if (not action_pools_created)
+    action_pools_created = action_pools_create(std::make_index_sequence<ACTION_SIZE_CLASSES>());
+  std::size_t size_class = (size - 1) / ACTION_SIZE_CLASS;
+  if (size_class >= ACTION_SIZE_CLASSES || action_pools[size_class] == nullptr)
+    return ::operator new(size);
+  return xbt_mallocator_get(action_pools[size_class]);
+}
+
+void Action::operator delete(void* ptr, std::size_t size)
+{
+  std::size_t size_class = (size - 1) / ACTION_SIZE_CLASS;
+  if (size_class >= ACTION_SIZE_CLASSES || action_pools[size_class] == nullptr)
+    ::operator delete(ptr);
+  else
+    xbt_mallocator_release(action_pools[size_class], ptr);
+}
+
+void Action::free_pools()
+{
+  for (std::size_t i = 0; i < ACTION_SIZE_CLASSES; i++) {
+    if (action_pools[i] != nullptr) {
+      XBT_VERB("Free the pool of the actions of %zu bytes", (i + 1) * ACTION_SIZE_CLASS);
+      xbt_mallocator_free(action_pools[i]);
+      action_pools[i] = nullptr;
+    }
+  }
+  action_pools_created = false;
+}
+
 Action::Action(Model* model, double cost, bool failed) : Action(model, cost, failed, nullptr) {}
 
 Action::Action(Model* model, double cost, bool failed, lmm::Variable* var)
@@ -97,18 +97,17 @@ double FactorSet::operator()(double size) const
   if (factors_.empty())
     return default_value_;
 
-  for (long unsigned i = 0; i < factors_.size(); i++) {
-    auto const& fact = factors_[i];
-
-    if (size <= fact.factor) { // Too large already, use the previous value
-      if (i == 0) { // Before the first boundary: use the default value
-        XBT_DEBUG("%s: %f <= %zu return default %f", name_.c_str(), size, fact.factor, default_value_);
-        return default_value_;
-      }
-      double val = lambda_(factors_[i - 1].values, size);
-      XBT_DEBUG("%s: %f <= %zu return %f", name_.c_str(), size, fact.factor, val);
-      return val;
+  // The boundaries are sorted: find the first one that is too large already, and use the previous value
+  auto fact = std::lower_bound(factors_.begin(), factors_.end(), size,
+                               [](const s_smpi_factor_t& f, double s) { return static_cast<double>(f.factor) < s; });
+  if (fact != factors_.end()) {
+    if (fact == factors_.begin()) { // Before the first boundary: use the default value
+      XBT_DEBUG("%s: %f <= %zu return default %f", name_.c_str(), size, fact->factor, default_value_);
+      return default_value_;
     }
+    double val = lambda_(std::prev(fact)->values, size);
+    XBT_DEBUG("%s: %f <= %zu return %f", name_.c_str(), size, fact->factor, val);
+    return val;
   }
   double val = lambda_(factors_.back().values, size);
 
@@ -29,6 +29,7 @@ protected:
 
   Metric latency_   = {0.0, 1, nullptr};
   Metric bandwidth_ = {1.0, 1, nullptr};
+  unsigned long metrics_version_ = 0; // To be incremented when the latency or the bandwidth changes
 
 public:
   void destroy(); // Must be called instead of the destructor
@@ -49,6 +50,9 @@ public:
   /** @brief Get the latency in seconds of current Link */
   double get_latency() const override { return latency_.peak * latency_.scale; }
 
+  /** @brief Get a counter of the changes of the latency and of the bandwidth, to check what was computed from them */
+  unsigned long get_metrics_version() const { return metrics_version_; }
+
   routing::NetZoneImpl* get_englobing_zone() const { return englobing_zone_; }
   /** @brief Set the NetZone in which this Link is included */
   StandardLinkImpl* set_englobing_zone(routing::NetZoneImpl* netzone_p);
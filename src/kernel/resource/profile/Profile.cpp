@@ -5,8 +5,10 @@
 
 #include "src/kernel/resource/profile/Profile.hpp"
 #include "xbt/asserts.h"
+#include "xbt/log.h"
 #include "src/kernel/resource/profile/Event.hpp"
 #include "src/kernel/resource/profile/FutureEvtSet.hpp"
+#include "src/kernel/resource/profile/ProfileReader.hpp"
 #include "src/kernel/resource/profile/StochasticDatedValue.hpp"
 #include "src/surf/surf_interface.hpp"
 
@@ -20,6 +22,8 @@
 #include <vector>
 #include <string>
 
+XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(ker_profile);
+
 static std::unordered_map<std::string, simgrid::kernel::profile::Profile*> trace_list;
 
 namespace simgrid::kernel::profile {
@@ -36,8 +40,12 @@ Event* Profile::schedule(FutureEvtSet* fes, resource::Resource* resource)
 
   fes_ = fes;
 
+  if (first_idx_ > 0)
+    rewind();
   if (get_enough_events(0)) {
     fes_->add_event(event_list[0].date_, event);
+    if (window_ > 0)
+      cursors_.insert(0);
   } else {
     event->free_me  = true;
     tmgr_trace_event_unref(&event);
@@ -50,23 +58,58 @@ DatedValue Profile::next(Event* event)
 {
   double event_date  = fes_->next_date();
 
-  DatedValue dateVal = event_list.at(event->idx);
+  DatedValue dateVal = event_list.at(event->idx - first_idx_);
 
   event->idx++;
 
   if (get_enough_events(event->idx)) {
-    const DatedValue& nextDateVal = event_list[event->idx];
+    const DatedValue& nextDateVal = event_list[event->idx - first_idx_];
     xbt_assert(nextDateVal.date_>=0);
     xbt_assert(nextDateVal.value_>=0);
     fes_->add_event(event_date +nextDateVal.date_, event);
   } else {
     event->free_me = true;
   }
+  if (window_ > 0)
+    move_cursor(event->idx - 1, event);
   return dateVal;
 }
 
-Profile::Profile(const std::string& name, const std::function<ProfileBuilder::UpdateCb>& cb, double repeat_delay)
-    : name(name), cb(cb), repeat_delay(repeat_delay)
+/** @brief Track the position of an event in a streamed profile, discarding the events that nobody needs anymore */
+void Profile::move_cursor(unsigned int from, const Event* event)
+{
+  cursors_.erase(cursors_.find(from));
+  if (not event->free_me)
+    cursors_.insert(event->idx);
+
+  size_t consumed = (cursors_.empty() ? first_idx_ + event_list.size() : *cursors_.begin()) - first_idx_;
+  if (consumed >= window_) {
+    event_list.erase(event_list.begin(), event_list.begin() + consumed);
+    first_idx_ += consumed;
+  }
+}
+
+/** @brief Reload a streamed profile from its beginning, for a resource using it once its first events were discarded
+ *
+ * The events up to the furthest position already read are decoded again, so that the other resources keep their
+ * position. They are discarded again once the new resource catches up with the others.
+ */
+void Profile::rewind()
+{
+  auto* stream = cb.target<StreamingUpdateCb>();
+  xbt_assert(stream != nullptr, "Cannot rewind the profile %s", name.c_str());
+  size_t end = first_idx_ + event_list.size();
+  XBT_DEBUG("Rewinding the streamed profile %s for a new resource (%zu events to reload)", name.c_str(), end);
+  event_list.clear();
+  first_idx_ = 0;
+  stream->rewind();
+  while (event_list.size() < end && get_enough_events(event_list.size()))
+    ;
+}
+
+Profile::Profile(const std::string& name, const std::function<ProfileBuilder::UpdateCb>& cb, double repeat_delay,
+                 size_t window)
+    : name(name), cb(cb), repeat_delay(repeat_delay), window_(window)
 {
   xbt_assert(trace_list.find(name) == trace_list.end(), "Refusing to define trace %s twice", name.c_str());
   trace_list.try_emplace(name, this);
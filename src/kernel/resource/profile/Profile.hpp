@@ -12,6 +12,7 @@
 #include "src/kernel/resource/profile/StochasticDatedValue.hpp"
 
 #include <queue>
+#include <set>
 #include <vector>
 #include <string>
 
@@ -35,15 +36,20 @@ public:
    * @param cb A callback object/function that populates the profile.
    * @param repeat_delay If strictly negative, it is ignored and the callback is called when an event reached the end of
    * the event_list. If zero or positive, the initial set repeats after the provided delay.
+   * @param window If positive, the profile is streamed: the callback appends a few events at a time, and the events
+   * that were consumed by every resource using this profile are discarded once they exceed that amount.
    */
-  explicit Profile(const std::string& name, const std::function<ProfileBuilder::UpdateCb>& cb, double repeat_delay);
+  explicit Profile(const std::string& name, const std::function<ProfileBuilder::UpdateCb>& cb, double repeat_delay,
+                   size_t window = 0);
   virtual ~Profile()=default;
   Event* schedule(FutureEvtSet* fes, resource::Resource* resource);
   DatedValue next(Event* event);
 
+  /** @brief The events currently in memory. For streamed profiles, this is only a sliding window over the profile. */
   const std::vector<DatedValue>& get_event_list() const { return event_list; }
   const std::string& get_name() const { return name; }
   bool is_repeating() const { return repeat_delay>=0;}
+  bool is_streamed() const { return window_ > 0; }
   double get_repeat_delay() const { return repeat_delay;}
 
 private:
@@ -52,13 +58,18 @@ private:
   std::vector<DatedValue> event_list;
   FutureEvtSet* fes_  = nullptr;
   double repeat_delay;
+  size_t window_    = 0;
+  size_t first_idx_ = 0;                // Index in the whole profile of event_list[0], once the window slid
+  std::multiset<unsigned int> cursors_; // Position of the pending events of a streamed profile
 
   bool get_enough_events(size_t index)
   {
-    if (index >= event_list.size() && cb)
+    if (index - first_idx_ >= event_list.size() && cb)
       cb(event_list);
-    return index < event_list.size();
+    return index - first_idx_ < event_list.size();
   }
+  void move_cursor(unsigned int from, const Event* event);
+  void rewind();
 };
 
 } // namespace simgrid::kernel::profile
@@ -6,9 +6,10 @@
 #include "simgrid/kernel/ProfileBuilder.hpp"
 #include "simgrid/forward.h"
 #include "src/kernel/resource/profile/Profile.hpp"
+#include "src/kernel/resource/profile/ProfileReader.hpp"
 #include "src/kernel/resource/profile/StochasticDatedValue.hpp"
 #include "src/surf/surf_interface.hpp"
-#include "xbt/file.hpp"
+#include "xbt/config.hpp"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/intrusive/options.hpp>
@@ -17,8 +18,18 @@
 #include <sstream>
 #include <string_view>
 
+XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(ker_profile);
+
 namespace simgrid::kernel::profile {
 
+static config::Flag<int> cfg_stream_window{
+    "profile/stream-window",
+    "Amount of events of the textual profile files kept in memory at once (0: load the whole profiles).", 0,
+    [](int val) { xbt_assert(val >= 0, "profile/stream-window must be positive or null"); }};
+
+/* Window used for binary profiles when profile/stream-window does not specify it */
+constexpr size_t DEFAULT_STREAM_WINDOW = 4096;
+
 bool DatedValue::operator==(DatedValue const& e2) const
 {
   return (fabs(date_ - e2.date_) < 0.0001) && (fabs(value_ - e2.value_) < 0.0001);
@@ -226,14 +237,16 @@ Profile* ProfileBuilder::from_string(const std::string& name, const std::string&
 Profile* ProfileBuilder::from_file(const std::string& filename)
 {
   xbt_assert(not filename.empty(), "Cannot parse a trace from an empty filename");
-  auto f = std::unique_ptr<std::ifstream>(simgrid::xbt::path_ifsopen(filename));
-  xbt_assert(not f->fail(), "Cannot open file '%s' (path=%s)", filename.c_str(),
-             simgrid::xbt::path_to_string().c_str());
+  auto file = ProfileFile::open(filename);
 
-  std::stringstream buffer;
-  buffer << f->rdbuf();
+  /* Binary profiles are always streamed, textual ones only on demand */
+  if (file->is_binary() || (cfg_stream_window > 0 && file->is_streamable())) {
+    size_t window = cfg_stream_window > 0 ? static_cast<size_t>(cfg_stream_window) : DEFAULT_STREAM_WINDOW;
+    XBT_DEBUG("Streaming profile %s by windows of %zu events", filename.c_str(), window);
+    return new Profile(filename, StreamingUpdateCb(file, window), file->get_repeat_delay(), window);
+  }
 
-  LegacyUpdateCb cb(buffer.str(), -1);
+  LegacyUpdateCb cb(file->get_content(), -1);
   return new Profile(filename, cb, cb.get_repeat_delay());
 }
 
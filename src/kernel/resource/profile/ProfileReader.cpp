@@ -0,0 +1,270 @@
+/* Copyright (c) 2004-2023. The SimGrid Team. All rights reserved.          */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/kernel/resource/profile/ProfileReader.hpp"
+#include "xbt/asserts.h"
+#include "xbt/file.hpp"
+#include "xbt/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <utility>
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(ker_profile, kernel, "Streaming of the profile files");
+
+namespace simgrid::kernel::profile {
+
+/* All mapped files, indexed by device and inode so that all profiles reading the same file share the mapping */
+static std::map<std::pair<dev_t, ino_t>, std::weak_ptr<ProfileFile>> mapped_files;
+
+std::shared_ptr<ProfileFile> ProfileFile::open(const std::string& filename)
+{
+  FILE* f = simgrid::xbt::path_fopen(filename, "rb");
+  xbt_assert(f != nullptr, "Cannot open file '%s' (path=%s)", filename.c_str(),
+             simgrid::xbt::path_to_string().c_str());
+  struct stat st;
+  xbt_assert(fstat(fileno(f), &st) == 0, "Cannot stat file '%s': %s", filename.c_str(), strerror(errno));
+
+  auto known = mapped_files.find({st.st_dev, st.st_ino});
+  if (known != mapped_files.end()) {
+    if (auto file = known->second.lock()) {
+      fclose(f);
+      return file;
+    }
+  }
+
+  auto size        = static_cast<std::size_t>(st.st_size);
+  const char* data = "";
+  if (size > 0) {
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    xbt_assert(map != MAP_FAILED, "Cannot map file '%s': %s", filename.c_str(), strerror(errno));
+    madvise(map, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(map);
+  }
+  fclose(f);
+
+  std::shared_ptr<ProfileFile> file(new ProfileFile(filename, data, size, st.st_dev, st.st_ino));
+  mapped_files[{st.st_dev, st.st_ino}] = file;
+  return file;
+}
+
+ProfileFile::ProfileFile(const std::string& name, const char* data, std::size_t size, dev_t dev, ino_t ino)
+    : name_(name), data_(data), size_(size), dev_(dev), ino_(ino)
+{
+  if (size_ >= sizeof(BinaryProfileHeader) && memcmp(data_, BinaryProfileHeader::MAGIC, 8) == 0) {
+    BinaryProfileHeader header;
+    memcpy(&header, data_, sizeof header);
+    xbt_assert(size_ >= sizeof header + header.count * 2 * sizeof(double),
+               "Binary profile '%s' is truncated: %llu records announced but the file is only %zu bytes long",
+               name_.c_str(), static_cast<unsigned long long>(header.count), size_);
+    binary_       = true;
+    count_        = header.count;
+    repeat_delay_ = header.repeat_delay;
+    scanned_      = true;
+  }
+  XBT_DEBUG("Mapped %s profile '%s' (%zu bytes)", binary_ ? "binary" : "textual", name_.c_str(), size_);
+}
+
+ProfileFile::~ProfileFile()
+{
+  if (size_ > 0)
+    munmap(const_cast<char*>(data_), size_);
+  auto known = mapped_files.find({dev_, ino_});
+  if (known != mapped_files.end() && known->second.expired())
+    mapped_files.erase(known);
+}
+
+/* Iterate over the lines of [begin, end), calling fun(line_start, line_end) on every trimmed non-empty line. */
+template <class F> static void for_each_line(const char* begin, const char* end, F fun)
+{
+  while (begin < end) {
+    const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+    const char* next = eol ? eol + 1 : end;
+    if (not eol)
+      eol = end;
+    while (begin < eol && isspace(static_cast<unsigned char>(*begin)))
+      begin++;
+    while (eol > begin && isspace(static_cast<unsigned char>(eol[-1])))
+      eol--;
+    if (begin < eol && not fun(begin, eol, next))
+      return;
+    begin = next;
+  }
+}
+
+static bool is_comment(const char* line)
+{
+  return *line == '#' || *line == '%';
+}
+
+/** Data lines start with a number, directives and stochastic laws with a keyword */
+static bool is_directive(const char* line)
+{
+  return isalpha(static_cast<unsigned char>(*line));
+}
+
+/* Parse "<date> <value>" into the provided pair. The line is copied because the mapping is not NUL-terminated. */
+static void parse_data_line(const ProfileFile* file, const char* begin, const char* end, double& date, double& value)
+{
+  char buffer[128];
+  auto len = std::min<std::size_t>(end - begin, sizeof buffer - 1);
+  memcpy(buffer, begin, len);
+  buffer[len] = '\0';
+  xbt_assert(sscanf(buffer, "%lg %lg", &date, &value) == 2, "%s: Invalid profile line: %s", file->get_name().c_str(),
+             buffer);
+}
+
+/* The directives of the legacy syntax may appear anywhere in the file, so look for them before streaming.
+ * This only checks the first character of most lines, which is much cheaper than parsing the events. */
+void ProfileFile::scan_text_directives()
+{
+  if (scanned_)
+    return;
+  scanned_ = true;
+
+  bool loop              = false;
+  double periodicity     = -1;
+  double loop_delay      = 0;
+  const char* last_begin = nullptr;
+  const char* last_end   = nullptr;
+  for_each_line(data_, data_ + size_, [&](const char* begin, const char* end, const char*) {
+    if (is_comment(begin))
+      return true;
+    if (not is_directive(begin)) {
+      last_begin = begin;
+      last_end   = end;
+      return true;
+    }
+    std::string line(begin, end);
+    if (sscanf(line.c_str(), "PERIODICITY %lg", &periodicity) == 1 ||
+        sscanf(line.c_str(), "LOOPAFTER %lg", &loop_delay) == 1) {
+      loop = true;
+      return true;
+    }
+    /* STOCHASTIC profiles and laws (NORM, UNIF, ...) need the legacy parser */
+    streamable_ = false;
+    return false;
+  });
+
+  if (not streamable_ || not loop)
+    return;
+  if (periodicity > 0) {
+    xbt_assert(loop_delay == 0, "%s: Cannot use both PERIODICITY and LOOPAFTER", name_.c_str());
+    double last_date = 0;
+    double value;
+    if (last_begin != nullptr)
+      parse_data_line(this, last_begin, last_end, last_date, value);
+    loop_delay = periodicity - last_date;
+  }
+  xbt_assert(loop_delay >= 0, "%s: Profile loop conditions are not realizable!", name_.c_str());
+  repeat_delay_ = loop_delay;
+}
+
+bool ProfileFile::is_streamable()
+{
+  scan_text_directives();
+  return streamable_;
+}
+
+double ProfileFile::get_repeat_delay()
+{
+  scan_text_directives();
+  return repeat_delay_;
+}
+
+std::size_t ProfileFile::read_text_events(Cursor& cursor, std::size_t max_count, std::vector<DatedValue>& out) const
+{
+  std::size_t count = 0;
+  for_each_line(data_ + cursor.offset, data_ + size_, [&](const char* begin, const char* end, const char* next) {
+    if (count == max_count)
+      return false;
+    cursor.offset = next - data_;
+    if (is_comment(begin) || is_directive(begin))
+      return true;
+    double date;
+    double value;
+    parse_data_line(this, begin, end, date, value);
+    xbt_assert(date >= 0, "%s: Profile time value is negative, why?", name_.c_str());
+    xbt_assert(cursor.last_date <= date, "%s: Invalid trace: Events must be sorted, but time %g > time %g.",
+               name_.c_str(), cursor.last_date, date);
+    out.emplace_back(date - cursor.last_date, value);
+    cursor.last_date = date;
+    count++;
+    return true;
+  });
+  if (count < max_count)
+    cursor.offset = size_;
+  return count;
+}
+
+std::size_t ProfileFile::read_events(Cursor& cursor, std::size_t max_count, std::vector<DatedValue>& out) const
+{
+  if (not binary_)
+    return read_text_events(cursor, max_count, out);
+
+  std::size_t count = std::min<std::size_t>(max_count, count_ - cursor.offset);
+  const char* records = data_ + sizeof(BinaryProfileHeader) + cursor.offset * 2 * sizeof(double);
+  out.reserve(out.size() + count);
+  for (std::size_t i = 0; i < count; i++) {
+    double record[2];
+    memcpy(record, records + i * sizeof record, sizeof record);
+    out.emplace_back(record[0], record[1]);
+  }
+  cursor.offset += count;
+  return count;
+}
+
+void StreamingUpdateCb::operator()(std::vector<DatedValue>& event_list) const
+{
+  std::size_t initial_size = event_list.size();
+  if (file_->read_events(*cursor_, window_, event_list) > 0)
+    return;
+  if (file_->get_repeat_delay() < 0)
+    return;
+
+  /* End of a repeating profile: start over, delaying the first event of the new iteration */
+  rewind();
+  if (file_->read_events(*cursor_, window_, event_list) > 0)
+    event_list.at(initial_size).date_ += file_->get_repeat_delay();
+}
+
+void write_binary_profile(const std::string& input, const std::string& output)
+{
+  auto file = ProfileFile::open(input);
+  xbt_assert(file->is_streamable(), "%s: Only deterministic profiles can be converted to the binary format",
+             input.c_str());
+
+  std::ofstream out(output, std::ios::binary | std::ios::trunc);
+  xbt_assert(out.good(), "Cannot open '%s' for writing: %s", output.c_str(), strerror(errno));
+  BinaryProfileHeader header;
+  memcpy(header.magic, BinaryProfileHeader::MAGIC, sizeof header.magic);
+  header.count        = 0;
+  header.repeat_delay = file->get_repeat_delay();
+  out.write(reinterpret_cast<const char*>(&header), sizeof header);
+
+  ProfileFile::Cursor cursor;
+  std::vector<DatedValue> events;
+  while (file->read_events(cursor, 4096, events) > 0) {
+    for (auto const& dv : events) {
+      double record[2] = {dv.date_, dv.value_};
+      out.write(reinterpret_cast<const char*>(record), sizeof record);
+    }
+    header.count += events.size();
+    events.clear();
+  }
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof header);
+  xbt_assert(out.good(), "Error while writing '%s'", output.c_str());
+  XBT_DEBUG("Wrote %llu events to '%s'", static_cast<unsigned long long>(header.count), output.c_str());
+}
+
+} // namespace simgrid::kernel::profile
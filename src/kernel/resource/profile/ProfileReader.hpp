@@ -0,0 +1,102 @@
+/* Copyright (c) 2004-2023. The SimGrid Team. All rights reserved.          */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_KERNEL_PROFILE_PROFILEREADER_HPP
+#define SIMGRID_KERNEL_PROFILE_PROFILEREADER_HPP
+
+#include "simgrid/forward.h"
+#include "simgrid/kernel/ProfileBuilder.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace simgrid::kernel::profile {
+
+/** @brief Header of the binary profile files, directly followed by the records
+ *
+ * Each record is a pair of doubles {delay since the previous record, value}, in the byte order of the host that
+ * produced the file. A profile repeats if repeat_delay is positive or null, exactly as textual profiles with a
+ * LOOPAFTER or PERIODICITY directive.
+ */
+struct BinaryProfileHeader {
+  static constexpr char MAGIC[8] = {'S', 'G', 'P', 'R', 'O', 'F', '\0', '\1'};
+  char magic[8];
+  std::uint64_t count;
+  double repeat_delay;
+};
+
+/** @brief A read-only memory mapping of a profile file (textual or binary).
+ *
+ * The mappings are shared: opening twice the same file (even through different paths) returns the same object.
+ * Nothing is parsed in advance, the events are decoded on demand by read_events().
+ */
+class XBT_PUBLIC ProfileFile {
+public:
+  /** Position of a reader in the file */
+  struct Cursor {
+    std::size_t offset = 0; // in bytes for textual files, in records for binary ones
+    double last_date   = 0; // absolute date of the last event read from a textual file
+  };
+
+  static std::shared_ptr<ProfileFile> open(const std::string& filename);
+  ProfileFile(const ProfileFile&) = delete;
+  ProfileFile& operator=(const ProfileFile&) = delete;
+  ~ProfileFile();
+
+  const std::string& get_name() const { return name_; }
+  bool is_binary() const { return binary_; }
+  /** Whether the profile can be decoded incrementally (stochastic textual profiles cannot) */
+  bool is_streamable();
+  double get_repeat_delay();
+
+  /** Decode at most max_count events from the cursor position, appending them to out (dates are relative to the
+   * previous event, as in Profile). Returns the amount of decoded events, which is 0 at the end of the file. */
+  std::size_t read_events(Cursor& cursor, std::size_t max_count, std::vector<DatedValue>& out) const;
+
+  /** Return the whole content of a textual file, for the legacy in-memory parser */
+  std::string get_content() const { return std::string(data_, size_); }
+
+private:
+  ProfileFile(const std::string& name, const char* data, std::size_t size, dev_t dev, ino_t ino);
+  void scan_text_directives();
+  std::size_t read_text_events(Cursor& cursor, std::size_t max_count, std::vector<DatedValue>& out) const;
+
+  std::string name_;
+  const char* data_;
+  std::size_t size_;
+  dev_t dev_;
+  ino_t ino_;
+  bool binary_           = false;
+  std::uint64_t count_   = 0; // binary files only
+  bool scanned_          = false;
+  bool streamable_       = true;
+  double repeat_delay_   = -1.0;
+};
+
+/** @brief UpdateCb materializing the events of a ProfileFile window by window
+ *
+ * Each call appends the next window of events to the profile, rewinding the file when the profile repeats.
+ */
+class StreamingUpdateCb {
+  std::shared_ptr<ProfileFile> file_;
+  std::shared_ptr<ProfileFile::Cursor> cursor_ = std::make_shared<ProfileFile::Cursor>();
+  std::size_t window_;
+
+public:
+  StreamingUpdateCb(std::shared_ptr<ProfileFile> file, std::size_t window) : file_(std::move(file)), window_(window) {}
+  void operator()(std::vector<DatedValue>& event_list) const;
+  /** Restart from the beginning of the file, for the profile to decode its events again */
+  void rewind() const { *cursor_ = ProfileFile::Cursor(); }
+};
+
+/** @brief Convert a deterministic profile file (textual or binary) into the binary format */
+XBT_PUBLIC void write_binary_profile(const std::string& input, const std::string& output);
+
+} // namespace simgrid::kernel::profile
+
+#endif
@@ -8,14 +8,19 @@
 #include "src/kernel/resource/Resource.hpp"
 #include "src/kernel/resource/profile/Event.hpp"
 #include "simgrid/kernel/ProfileBuilder.hpp"
+#include "src/kernel/resource/profile/ProfileReader.hpp"
 #include "src/kernel/resource/profile/StochasticDatedValue.hpp"
 #include "src/surf/surf_interface.hpp"
 
+#include "xbt/config.hpp"
 #include "xbt/log.h"
 #include "xbt/misc.h"
 #include "xbt/random.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(unit, "Unit tests of the Trace Manager");
 
@@ -34,12 +39,10 @@ public:
 
 double MockedResource::the_date;
 
-static std::vector<simgrid::kernel::profile::DatedValue> trace2vector(const char* str)
+static std::vector<simgrid::kernel::profile::DatedValue> profile2vector(simgrid::kernel::profile::Profile* trace,
+                                                                       size_t* max_in_memory = nullptr)
 {
   std::vector<simgrid::kernel::profile::DatedValue> res;
-  simgrid::kernel::profile::Profile* trace = simgrid::kernel::profile::ProfileBuilder::from_string("TheName", str, 0);
-  XBT_VERB("---------------------------------------------------------");
-  XBT_VERB("data>>\n%s<<data\n", str);
   for (auto const& evt : trace->get_event_list())
     XBT_VERB("event: d:%lg v:%lg", evt.date_, evt.value_);
 
@@ -62,11 +65,42 @@ static std::vector<simgrid::kernel::profile::DatedValue> trace2vector(const char
       XBT_DEBUG("%.1f: ignore an event (idx: %u)\n", MockedResource::the_date, it->idx);
     }
     resource->apply_event(it, value);
+    if (max_in_memory)
+      *max_in_memory = std::max(*max_in_memory, trace->get_event_list().size());
   }
   tmgr_finalize();
   return res;
 }
 
+static std::vector<simgrid::kernel::profile::DatedValue> trace2vector(const char* str)
+{
+  simgrid::kernel::profile::Profile* trace = simgrid::kernel::profile::ProfileBuilder::from_string("TheName", str, 0);
+  XBT_VERB("---------------------------------------------------------");
+  XBT_VERB("data>>\n%s<<data\n", str);
+  return profile2vector(trace);
+}
+
+/* Load the profile from a temporary file, streaming it by windows of 2 events */
+static std::vector<simgrid::kernel::profile::DatedValue> file2vector(const char* str, bool binary,
+                                                                     size_t* max_in_memory)
+{
+  std::string filename = "profile_test.txt";
+  std::ofstream(filename) << str;
+  if (binary) {
+    simgrid::kernel::profile::write_binary_profile(filename, "profile_test.bprof");
+    std::remove(filename.c_str());
+    filename = "profile_test.bprof";
+  }
+  simgrid::config::set_value("profile/stream-window", 2);
+  simgrid::kernel::profile::Profile* trace = simgrid::kernel::profile::ProfileBuilder::from_file(filename);
+  simgrid::config::set_value("profile/stream-window", 0);
+  REQUIRE(trace->is_streamed());
+
+  auto res = profile2vector(trace, max_in_memory);
+  std::remove(filename.c_str());
+  return res;
+}
+
 TEST_CASE("kernel::profile: Resource profiles, defining the external load", "kernel::profile")
 {
   SECTION("No event, no loop")
@@ -211,4 +245,63 @@ TEST_CASE("kernel::profile: Resource profiles, defining the external load", "ker
 
     REQUIRE(want == got);
   }
+
+  SECTION("Streamed textual profile, looping")
+  {
+    const char* str = "# Comments are ignored\n"
+                      "1 1\n"
+                      "2 2\n"
+                      "3 3\n"
+                      "5 4\n"
+                      "LOOPAFTER 2\n";
+    std::vector<simgrid::kernel::profile::DatedValue> want = trace2vector(str);
+    size_t max_in_memory = 0;
+    std::vector<simgrid::kernel::profile::DatedValue> got = file2vector(str, false, &max_in_memory);
+
+    REQUIRE(want == got);
+    REQUIRE(max_in_memory <= 4);
+  }
+
+  SECTION("Streamed binary profile, no loop")
+  {
+    const char* str = "0 1\n"
+                      "2 0.5\n"
+                      "3 0.25\n"
+                      "7 0.75\n"
+                      "8.5 1";
+    std::vector<simgrid::kernel::profile::DatedValue> want = trace2vector(str);
+    size_t max_in_memory = 0;
+    std::vector<simgrid::kernel::profile::DatedValue> got = file2vector(str, true, &max_in_memory);
+
+    REQUIRE(want == got);
+    REQUIRE(max_in_memory <= 4);
+  }
+
+  SECTION("Streamed profile, scheduled again once its first events were discarded")
+  {
+    std::string filename = "profile_test.txt";
+    std::ofstream(filename) << "0 1\n1 2\n2 3\n3 4\n4 5\n5 6\n";
+    simgrid::config::set_value("profile/stream-window", 2);
+    simgrid::kernel::profile::Profile* trace = simgrid::kernel::profile::ProfileBuilder::from_file(filename);
+    simgrid::config::set_value("profile/stream-window", 0);
+    std::remove(filename.c_str());
+
+    MockedResource first;
+    MockedResource second;
+    simgrid::kernel::profile::FutureEvtSet fes;
+    trace->schedule(&fes, &first);
+    for (int i = 0; i < 4; i++) {
+      double value;
+      simgrid::kernel::resource::Resource* resource;
+      simgrid::kernel::profile::Event* it = fes.pop_leq(fes.next_date(), &value, &resource);
+      REQUIRE(value == i + 1);
+      resource->apply_event(it, value);
+    }
+    REQUIRE(trace->get_event_list().front().value_ > 1);
+
+    trace->schedule(&fes, &second);
+    REQUIRE(trace->get_event_list().front() == simgrid::kernel::profile::DatedValue(0, 1));
+    REQUIRE(trace->get_event_list().size() >= 5);
+    tmgr_finalize();
+  }
 }
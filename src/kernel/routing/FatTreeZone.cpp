@@ -468,6 +468,16 @@ s4u::FatTreeParams FatTreeZone::parse_topo_parameters(const std::string& topo_pa
   return s4u::FatTreeParams(n_lev, down, up, count);
 }
 
+std::vector<unsigned long> FatTreeZone::get_location(const NetPoint* elm) const
+{
+  auto node = compute_nodes_.find(elm->id());
+  if (elm->is_router() || node == compute_nodes_.end() || node->second->label.empty())
+    return {};
+  // The leaves of the subtree of a switch at level l share the label digits l to levels_-1 (see is_in_sub_tree)
+  const auto& label = node->second->label;
+  return std::vector<unsigned long>(label.rbegin(), label.rend() - 1);
+}
+
 void FatTreeZone::generate_dot_file(const std::string& filename) const
 {
   std::ofstream file;
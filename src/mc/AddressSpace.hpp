@@ -8,6 +8,7 @@
 
 #include "src/mc/mc_forward.hpp"
 #include "src/mc/remote/RemotePtr.hpp"
+#include "xbt/misc.h"
 
 namespace simgrid::mc {
 
@@ -105,6 +106,19 @@ public:
   virtual void* read_bytes(void* buffer, std::size_t size, RemotePtr<void> address,
                            ReadOptions options = ReadOptions::none()) const = 0;
 
+  /** Read whole memory pages from the address space
+   *
+   *  This is used to take snapshots: implementations may read large spans with fewer system calls than read_bytes().
+   *
+   *  @param buffer        target buffer for the data (`page_count` pages)
+   *  @param page_count    number of pages to read
+   *  @param address       remote address of the first page (must be at the beginning of a page)
+   */
+  virtual void read_pages(void* buffer, std::size_t page_count, RemotePtr<void> address) const
+  {
+    this->read_bytes(buffer, page_count << xbt_pagebits, address);
+  }
+
   /** Read a given data structure from the address space */
   template <class T> inline void read(T* buffer, RemotePtr<T> ptr) const { this->read_bytes(buffer, sizeof(T), ptr); }
 
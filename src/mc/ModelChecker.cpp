@@ -34,6 +34,7 @@ namespace simgrid::mc {
 ModelChecker::ModelChecker(std::unique_ptr<RemoteProcess> remote_simulation, int sockfd)
     : checker_side_(sockfd), remote_process_(std::move(remote_simulation))
 {
+  page_store_.set_budget(static_cast<std::size_t>(_sg_mc_page_store_budget.get()) << 20);
 }
 
 void ModelChecker::start()
@@ -79,7 +80,8 @@ void ModelChecker::start()
 
   errno = 0;
 #ifdef __linux__
-  ptrace(PTRACE_SETOPTIONS, pid, nullptr, PTRACE_O_TRACEEXIT);
+  // With model-check/fork-checkpoint, the copies of the application are traced too
+  ptrace(PTRACE_SETOPTIONS, pid, nullptr, PTRACE_O_TRACEEXIT | (_sg_mc_fork_checkpoint > 0 ? PTRACE_O_TRACEFORK : 0));
   ptrace(PTRACE_CONT, pid, 0, 0);
 #elif defined BSD
   ptrace(PT_CONTINUE, pid, (caddr_t)1, 0);
@@ -132,6 +134,8 @@ void ModelChecker::shutdown()
     kill(process.pid(), SIGKILL);
     process.terminate();
   }
+  while (not forks_.empty())
+    kill_app(*forks_.begin());
 }
 
 void ModelChecker::resume()
@@ -313,6 +317,13 @@ void ModelChecker::handle_waitpid()
         XBT_DEBUG("Child process is over");
         this->get_remote_process().terminate();
       }
+    } else if (WIFSTOPPED(status)) {
+      // The paused copies of the application (model-check/fork-checkpoint) must not stay stopped
+#ifdef __linux__
+      ptrace(PTRACE_CONT, pid, 0, 0);
+#elif defined BSD
+      ptrace(PT_CONTINUE, pid, (caddr_t)1, 0);
+#endif
     }
   }
 }
@@ -348,11 +359,106 @@ Transition* ModelChecker::handle_simcall(aid_t aid, int times_considered, bool n
 
   if (new_transition) {
     std::stringstream stream(answer.buffer.data());
-    return deserialize_transition(aid, times_considered, stream);
+    Transition* transition  = deserialize_transition(aid, times_considered, stream);
+    if (not _sg_mc_frontier_file.get().empty()) // Only kept to save the exploration frontier
+      transition->serialized_ = answer.buffer.data();
+    return transition;
   } else
     return nullptr;
 }
 
+void ModelChecker::replay_simcalls(std::vector<std::pair<aid_t, int>> const& simcalls)
+{
+  for (size_t first = 0; first < simcalls.size(); first += MC_REPLAY_BATCH_SIZE) {
+    size_t count = std::min<size_t>(simcalls.size() - first, MC_REPLAY_BATCH_SIZE);
+    std::vector<s_mc_message_replay_one_t> transitions(count);
+    for (size_t i = 0; i < count; i++)
+      transitions[i] = {simcalls[first + i].first, simcalls[first + i].second};
+
+    s_mc_message_replay_t m;
+    memset(&m, 0, sizeof(m));
+    m.type  = MessageType::REPLAY;
+    m.count = static_cast<int>(count);
+    xbt_assert(checker_side_.get_channel().send(m) == 0 &&
+                   checker_side_.get_channel().send(transitions.data(), count * sizeof(transitions[0])) == 0,
+               "Could not send the transitions to replay");
+
+    this->remote_process_->clear_cache();
+    if (this->remote_process_->running())
+      checker_side_.dispatch(); // Until the WAITING message sent once the whole sequence is replayed
+  }
+}
+
+std::pair<pid_t, int> ModelChecker::fork_app(pid_t pid, Channel const& channel)
+{
+#ifdef __linux__
+  xbt_assert(channel.send(MessageType::FORK) == 0, "Could not ask the application to fork");
+
+  // The application stops on PTRACE_EVENT_FORK, and the new copy starts with a SIGSTOP: let both of them go
+  int status;
+  pid_t child = -1;
+  while (child == -1) {
+    xbt_assert(waitpid(pid, &status, __WALL) == pid && WIFSTOPPED(status), "The application died while forking");
+    if (status >> 8 == (SIGTRAP | (PTRACE_EVENT_FORK << 8))) {
+      unsigned long msg;
+      xbt_assert(ptrace(PTRACE_GETEVENTMSG, pid, 0, &msg) != -1, "Could not get the pid of the forked application");
+      child = static_cast<pid_t>(msg);
+      ptrace(PTRACE_CONT, pid, 0, 0);
+    } else
+      ptrace(PTRACE_CONT, pid, 0, WSTOPSIG(status));
+  }
+  xbt_assert(waitpid(child, &status, __WALL) == child && WIFSTOPPED(status), "Could not wait the forked application");
+  ptrace(PTRACE_CONT, child, 0, 0);
+  forks_.insert(child);
+
+  s_mc_message_int_t answer;
+  int socket = -1;
+  ssize_t s  = channel.receive_with_fd(&answer, sizeof(answer), &socket);
+  xbt_assert(s == sizeof(answer) && answer.type == MessageType::FORK_REPLY && answer.value == (uint64_t)child &&
+                 socket != -1,
+             "Received unexpected message %s (%i, size=%i) expected MessageType::FORK_REPLY (%i, size=%i)",
+             to_c_str(answer.type), (int)answer.type, (int)s, (int)MessageType::FORK_REPLY, (int)sizeof(answer));
+  XBT_DEBUG("Application %d forked into %d", pid, child);
+  return {child, socket};
+#else
+  xbt_die("Forking the application is only implemented on Linux");
+#endif
+}
+
+static void kill_and_reap(pid_t pid)
+{
+  kill(pid, SIGKILL);
+  // Reap it, as it may still stop on PTRACE_EVENT_EXIT
+  int status;
+  while (waitpid(pid, &status, WAITPID_CHECKED_FLAGS) == pid && WIFSTOPPED(status)) {
+#ifdef __linux__
+    ptrace(PTRACE_CONT, pid, 0, 0);
+#elif defined BSD
+    ptrace(PT_CONTINUE, pid, (caddr_t)1, 0);
+#endif
+  }
+}
+
+void ModelChecker::kill_app(pid_t pid)
+{
+  // The copies still alive at shutdown() are killed before the destruction of their checkpoints. Their pid may then
+  // have been reused by an unrelated process.
+  if (forks_.erase(pid) == 0)
+    return;
+  kill_and_reap(pid);
+}
+
+void ModelChecker::switch_app(pid_t pid, int socket)
+{
+  // The current application is either a copy, or the application started by the model checker
+  forks_.erase(remote_process_->pid());
+  kill_and_reap(remote_process_->pid());
+  checker_side_.replace_socket(socket);
+  remote_process_->reattach(pid);
+  // The content of the new copy is not the one of the last snapshot or restore
+  live_regions_.clear();
+}
+
 void ModelChecker::finalize_app(bool terminate_asap)
 {
   s_mc_message_int_t m;
@@ -8,10 +8,17 @@
 
 #include "src/mc/remote/CheckerSide.hpp"
 #include "src/mc/remote/RemotePtr.hpp"
+#include "src/mc/sosp/ChunkedData.hpp"
 #include "src/mc/sosp/PageStore.hpp"
 #include "xbt/base.h"
 
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace simgrid::mc {
 
@@ -28,6 +35,22 @@ class ModelChecker {
 
   unsigned long visited_states_ = 0;
 
+public:
+  /** Time spent capturing each snapshotted region (data segment of each object, heap) */
+  struct RegionStats {
+    unsigned long snapshots = 0;
+    std::size_t pages       = 0;
+    double time             = 0.0;
+  };
+
+private:
+  std::map<std::string, RegionStats, std::less<>> region_stats_; // by full path of the object, or "heap"
+  /** Content of the snapshotted regions in the application as of the last snapshot or restore, by start address
+   *  (only with model-check/soft-dirty) */
+  std::unordered_map<std::uintptr_t, ChunkedData> live_regions_;
+  /** Copies of the application forked with fork_app() and not killed yet (model-check/fork-checkpoint) */
+  std::unordered_set<pid_t> forks_;
+
 public:
   ModelChecker(ModelChecker const&) = delete;
   ModelChecker& operator=(ModelChecker const&) = delete;
@@ -44,18 +67,45 @@ public:
 
   /** Let the application take a transition. A new Transition is created iff the last parameter is true */
   Transition* handle_simcall(aid_t aid, int times_considered, bool new_transition);
+  /** Let the application take a sequence of transitions (given as actor and times considered), with one round trip
+   *  per MC_REPLAY_BATCH_SIZE transitions instead of two per transition */
+  void replay_simcalls(std::vector<std::pair<aid_t, int>> const& simcalls);
 
   /* Interactions with the simcall observer */
   XBT_ATTRIB_NORETURN void exit(int status);
 
   void finalize_app(bool terminate_asap = false);
 
+  /** Ask the given copy of the application to fork, and return the pid of the new copy with the socket to talk to it
+   *  (model-check/fork-checkpoint) */
+  std::pair<pid_t, int> fork_app(pid_t pid, Channel const& channel);
+  /** Kill a copy of the application created with fork_app(), unless it was already killed */
+  void kill_app(pid_t pid);
+  /** Kill the current application, and go on with the given copy instead */
+  void switch_app(pid_t pid, int socket);
+
   Exploration* get_exploration() const { return exploration_; }
   void set_exploration(Exploration* exploration) { exploration_ = exploration; }
 
   unsigned long get_visited_states() const { return visited_states_; }
   void inc_visited_states() { visited_states_++; }
 
+  void add_region_snapshot(const std::string& region, std::size_t pages, double time)
+  {
+    RegionStats& stats = region_stats_[region];
+    stats.snapshots++;
+    stats.pages += pages;
+    stats.time += time;
+  }
+  const std::map<std::string, RegionStats, std::less<>>& get_region_stats() const { return region_stats_; }
+
+  const ChunkedData* get_live_region(RemotePtr<void> start) const
+  {
+    auto it = live_regions_.find(start.address());
+    return it == live_regions_.end() ? nullptr : &it->second;
+  }
+  void set_live_region(RemotePtr<void> start, const ChunkedData& chunks) { live_regions_[start.address()] = chunks; }
+
   void dot_output(const char* fmt, ...) XBT_ATTRIB_PRINTF(2, 3);
   void dot_output_flush()
   {
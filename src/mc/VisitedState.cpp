@@ -10,6 +10,7 @@
 
 #include <unistd.h>
 #include <sys/wait.h>
+#include <algorithm>
 #include <memory>
 #include <boost/range/algorithm.hpp>
 
@@ -25,6 +26,19 @@ VisitedState::VisitedState(unsigned long state_number, unsigned int actor_count)
   this->system_state = std::make_shared<simgrid::mc::Snapshot>(state_number);
 }
 
+void VisitedStates::index(simgrid::mc::VisitedState* state)
+{
+  content_index_.emplace(state->system_state->get_content_hash(), state);
+}
+
+void VisitedStates::unindex(const simgrid::mc::VisitedState* state)
+{
+  auto [first, last] = content_index_.equal_range(state->system_state->get_content_hash());
+  auto it = std::find_if(first, last, [state](auto const& entry) { return entry.second == state; });
+  xbt_assert(it != last, "Visited state %ld is not indexed", state->num);
+  content_index_.erase(it);
+}
+
 void VisitedStates::prune()
 {
   while (states_.size() > (std::size_t)_sg_mc_max_visited_states) {
@@ -34,11 +48,38 @@ void VisitedStates::prune()
                     const std::unique_ptr<simgrid::mc::VisitedState>& b) { return a->num < b->num; });
     xbt_assert(min_element != states_.end());
     // and drop it:
+    unindex(min_element->get());
     states_.erase(min_element);
     XBT_DEBUG("Remove visited state (maximum number of stored states reached)");
   }
 }
 
+/** Replace a stored state with the new state found equal to it, and return the old one */
+std::unique_ptr<simgrid::mc::VisitedState>
+VisitedStates::replace(std::unique_ptr<simgrid::mc::VisitedState>& visited_state,
+                       std::unique_ptr<simgrid::mc::VisitedState> new_state)
+{
+  std::unique_ptr<simgrid::mc::VisitedState> old_state = std::move(visited_state);
+
+  if (old_state->original_num == -1) // I'm the copy of an original process
+    new_state->original_num = old_state->num;
+  else // I'm the copy of a copy
+    new_state->original_num = old_state->original_num;
+
+  XBT_DEBUG("State %ld already visited ! (equal to state %ld (state %ld in dot_output))", new_state->num,
+            old_state->num, new_state->original_num);
+
+  /* Replace the old state with the new one (with a bigger num)
+      (when the max number of visited states is reached,  the oldest
+      one is removed according to its number (= with the min number) */
+  XBT_DEBUG("Replace visited state %ld with the new visited state %ld", old_state->num, new_state->num);
+
+  unindex(old_state.get());
+  index(new_state.get());
+  visited_state = std::move(new_state);
+  return old_state;
+}
+
 /** @brief Checks whether a given state has already been visited by the algorithm. */
 std::unique_ptr<simgrid::mc::VisitedState> VisitedStates::addVisitedState(unsigned long state_number,
                                                                           simgrid::mc::State* graph_state)
@@ -48,36 +89,30 @@ std::unique_ptr<simgrid::mc::VisitedState> VisitedStates::addVisitedState(unsign
   XBT_DEBUG("Snapshot %p of visited state %ld (exploration stack state %ld)", new_state->system_state.get(),
             new_state->num, graph_state->get_num());
 
+  // First look for a state with exactly the same memory, which is much cheaper than comparing the states
+  auto [first, last] = content_index_.equal_range(new_state->system_state->get_content_hash());
+  for (auto it = first; it != last; ++it) {
+    if (it->second->actor_count_ == new_state->actor_count_ &&
+        it->second->system_state->same_content(*new_state->system_state)) {
+      const simgrid::mc::VisitedState* found = it->second;
+      auto visited_state = boost::range::find_if(states_, [found](auto const& state) { return state.get() == found; });
+      XBT_DEBUG("State %ld is an exact copy of state %ld", new_state->num, found->num);
+      return replace(*visited_state, std::move(new_state));
+    }
+  }
+
   auto [range_begin, range_end] = boost::range::equal_range(states_, new_state.get(), [](auto const& a, auto const& b) {
     return std::make_pair(a->actor_count_, a->heap_bytes_used) < std::make_pair(b->actor_count_, b->heap_bytes_used);
   });
 
   for (auto i = range_begin; i != range_end; ++i) {
     auto& visited_state = *i;
-    if (*visited_state->system_state.get() == *new_state->system_state.get()) {
-      // The state has been visited:
-
-      std::unique_ptr<simgrid::mc::VisitedState> old_state = std::move(visited_state);
-
-      if (old_state->original_num == -1) // I'm the copy of an original process
-        new_state->original_num = old_state->num;
-      else // I'm the copy of a copy
-        new_state->original_num = old_state->original_num;
-
-      XBT_DEBUG("State %ld already visited ! (equal to state %ld (state %ld in dot_output))", new_state->num,
-                old_state->num, new_state->original_num);
-
-      /* Replace the old state with the new one (with a bigger num)
-          (when the max number of visited states is reached,  the oldest
-          one is removed according to its number (= with the min number) */
-      XBT_DEBUG("Replace visited state %ld with the new visited state %ld", old_state->num, new_state->num);
-
-      visited_state = std::move(new_state);
-      return old_state;
-    }
+    if (*visited_state->system_state.get() == *new_state->system_state.get()) // The state has been visited
+      return replace(visited_state, std::move(new_state));
   }
 
   XBT_DEBUG("Insert new visited state %ld (total : %lu)", new_state->num, (unsigned long)states_.size());
+  index(new_state.get());
   states_.insert(range_begin, std::move(new_state));
   this->prune();
   return nullptr;
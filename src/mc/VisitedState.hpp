@@ -11,6 +11,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <unordered_map>
 
 namespace simgrid::mc {
 
@@ -27,13 +28,24 @@ public:
 
 class XBT_PRIVATE VisitedStates {
   std::vector<std::unique_ptr<simgrid::mc::VisitedState>> states_;
+  /** The stored states by hash of their memory content, to find the exact copies without comparing the states */
+  std::unordered_multimap<hash_type, simgrid::mc::VisitedState*> content_index_;
+
 public:
-  void clear() { states_.clear(); }
+  void clear()
+  {
+    states_.clear();
+    content_index_.clear();
+  }
   std::unique_ptr<simgrid::mc::VisitedState> addVisitedState(unsigned long state_number,
                                                              simgrid::mc::State* graph_state);
 
 private:
   void prune();
+  void index(simgrid::mc::VisitedState* state);
+  void unindex(const simgrid::mc::VisitedState* state);
+  std::unique_ptr<simgrid::mc::VisitedState> replace(std::unique_ptr<simgrid::mc::VisitedState>& visited_state,
+                                                     std::unique_ptr<simgrid::mc::VisitedState> new_state);
 };
 
 } // namespace simgrid::mc
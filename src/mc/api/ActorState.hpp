@@ -56,6 +56,7 @@ public:
     return times_considered_++;
   }
   unsigned int get_times_considered() const { return times_considered_; }
+  unsigned int get_max_consider() const { return max_consider_; }
   aid_t get_aid() const { return aid_; }
 
   /* returns whether the actor is marked as enabled in the application side */
@@ -71,6 +72,15 @@ public:
     this->times_considered_ = 0;
   }
   void set_done() { this->state_ = InterleavingType::done; }
+
+  /* Exploration status, as saved with the exploration frontier (model-check/frontier-file) */
+  unsigned char get_status() const { return static_cast<unsigned char>(this->state_); }
+  void set_status(unsigned char status, unsigned int times_considered)
+  {
+    xbt_assert(status <= static_cast<unsigned char>(InterleavingType::done), "Invalid actor status %u", status);
+    this->state_            = static_cast<InterleavingType>(status);
+    this->times_considered_ = times_considered;
+  }
 };
 
 } // namespace simgrid::mc
@@ -26,6 +26,8 @@
 #include <string>
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #ifdef __linux__
 #include <sys/prctl.h>
 #endif
@@ -42,7 +44,7 @@ static simgrid::config::Flag<std::string> _sg_mc_setenv{
 
 namespace simgrid::mc {
 
-static void run_child_process(int socket, const std::vector<char*>& args)
+static void run_child_process(int socket, int shm_fd, const std::vector<char*>& args)
 {
   /* On startup, simix_global_init() calls simgrid::mc::Client::initialize(), which checks whether the MC_ENV_SOCKET_FD
    * env variable is set. If so, MC mode is assumed, and the client is setup from its side
@@ -63,6 +65,14 @@ static void run_child_process(int socket, const std::vector<char*>& args)
 
   setenv(MC_ENV_SOCKET_FD, std::to_string(socket).c_str(), 1);
 
+  if (shm_fd != -1) {
+    fdflags = fcntl(shm_fd, F_GETFD, 0);
+    xbt_assert(fdflags != -1 && fcntl(shm_fd, F_SETFD, fdflags & ~FD_CLOEXEC) != -1,
+               "Could not remove CLOEXEC for the shared memory segment");
+    setenv(MC_ENV_SHM_FD, std::to_string(shm_fd).c_str(), 1);
+  } else
+    unsetenv(MC_ENV_SHM_FD);
+
   /* Setup the tokenizer that parses the cfg:model-check/setenv parameter */
   using Tokenizer = boost::tokenizer<boost::char_separator<char>>;
   boost::char_separator<char> semicol_sep(";");
@@ -112,12 +122,33 @@ RemoteApp::RemoteApp(const std::vector<char*>& args)
   int sockets[2];
   xbt_assert(socketpair(AF_LOCAL, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != -1, "Could not create socketpair");
 
+#ifdef __linux__
+  if (_sg_mc_fork_checkpoint > 0) {
+    xbt_assert(_sg_mc_transport.get() == "socket", "model-check/fork-checkpoint requires model-check/transport:socket");
+    // Adopt the copies of the application orphaned when the copy that forked them is killed, to reap them
+    xbt_assert(prctl(PR_SET_CHILD_SUBREAPER, 1) == 0, "Could not PR_SET_CHILD_SUBREAPER");
+  }
+#else
+  xbt_assert(_sg_mc_fork_checkpoint == 0, "model-check/fork-checkpoint is only implemented on Linux");
+#endif
+
+  // With model-check/transport:shm, the messages go through a shared memory segment inherited by the application
+  int shm_fd = -1;
+  if (_sg_mc_transport.get() == "shm") {
+#ifdef __linux__
+    shm_fd = memfd_create("simgrid-mc", MFD_CLOEXEC);
+#endif
+    xbt_assert(shm_fd != -1, "Could not create the shared memory segment: %s", strerror(errno));
+    xbt_assert(ftruncate(shm_fd, Channel::shared_memory_size()) == 0, "Could not size the shared memory segment: %s",
+               strerror(errno));
+  }
+
   pid_t pid = fork();
   xbt_assert(pid >= 0, "Could not fork model-checked process");
 
   if (pid == 0) { // Child
     ::close(sockets[1]);
-    run_child_process(sockets[0], args);
+    run_child_process(sockets[0], shm_fd, args);
     DIE_IMPOSSIBLE;
   }
 
@@ -129,6 +160,13 @@ RemoteApp::RemoteApp(const std::vector<char*>& args)
   auto process   = std::make_unique<simgrid::mc::RemoteProcess>(pid);
   model_checker_ = std::make_unique<simgrid::mc::ModelChecker>(std::move(process), sockets[1]);
 
+  if (shm_fd != -1) {
+    void* memory = mmap(nullptr, Channel::shared_memory_size(), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    xbt_assert(memory != MAP_FAILED, "Could not map the shared memory segment: %s", strerror(errno));
+    ::close(shm_fd);
+    model_checker_->channel().use_shared_memory(memory, true);
+  }
+
   mc_model_checker = model_checker_.get();
   model_checker_->start();
 
@@ -152,6 +190,25 @@ void RemoteApp::restore_initial_state() const
   this->initial_snapshot_->restore(&model_checker_->get_remote_process());
 }
 
+ForkCheckpoint::~ForkCheckpoint()
+{
+  if (mc_model_checker != nullptr)
+    mc_model_checker->kill_app(pid_);
+}
+
+std::unique_ptr<ForkCheckpoint> RemoteApp::take_fork_checkpoint() const
+{
+  auto [pid, socket] =
+      model_checker_->fork_app(model_checker_->get_remote_process().pid(), model_checker_->channel());
+  return std::make_unique<ForkCheckpoint>(pid, socket);
+}
+
+void RemoteApp::restore_fork_checkpoint(const ForkCheckpoint& checkpoint) const
+{
+  auto [pid, socket] = model_checker_->fork_app(checkpoint.get_pid(), checkpoint.get_channel());
+  model_checker_->switch_app(pid, socket);
+}
+
 unsigned long RemoteApp::get_maxpid() const
 {
   return model_checker_->get_remote_process().get_maxpid();
@@ -12,9 +12,31 @@
 #include "src/mc/remote/RemotePtr.hpp"
 
 #include <functional>
+#include <memory>
 
 namespace simgrid::mc {
 
+/** A paused copy of the application, forked at some point of the exploration (model-check/fork-checkpoint)
+ *
+ *  New copies can be forked from it to come back to that point without replaying the path from the initial state.
+ *  The copy is killed when this object is destroyed.
+ */
+class XBT_PRIVATE ForkCheckpoint {
+  pid_t pid_;
+  Channel channel_;
+
+public:
+  ForkCheckpoint(pid_t pid, int socket) : pid_(pid), channel_(socket) {}
+  ~ForkCheckpoint();
+
+  // No copy:
+  ForkCheckpoint(ForkCheckpoint const&) = delete;
+  ForkCheckpoint& operator=(ForkCheckpoint const&) = delete;
+
+  pid_t get_pid() const { return pid_; }
+  Channel const& get_channel() const { return channel_; }
+};
+
 /** High-level view of the verified application, from the model-checker POV
  *
  *  This is expected to become the interface used by model-checking
@@ -46,6 +68,11 @@ public:
 
   void restore_initial_state() const;
 
+  /** Fork a paused copy of the application in its current state */
+  std::unique_ptr<ForkCheckpoint> take_fork_checkpoint() const;
+  /** Replace the application with a new copy of the given checkpoint */
+  void restore_fork_checkpoint(const ForkCheckpoint& checkpoint) const;
+
   /** Ask to the application to check for a deadlock. If so, do an error message and throw a DeadlockError. */
   void check_deadlock() const;
 
@@ -6,7 +6,9 @@
 #include "src/mc/api/State.hpp"
 #include "src/mc/mc_config.hpp"
 
+#include <algorithm>
 #include <boost/range/algorithm.hpp>
+#include <iterator>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_state, mc, "Logging specific to MC states");
 
@@ -25,6 +27,44 @@ State::State(const RemoteApp& remote_app) : num_(++expended_states_)
   }
 }
 
+void State::inherit_sleep_set(const State& parent)
+{
+  const Transition* incoming = parent.get_transition();
+  for (auto const& [aid, transitions] : parent.sleep_set_) {
+    if (aid == incoming->aid_) // Its transitions are not the same anymore
+      continue;
+    std::vector<std::shared_ptr<Transition>> independent;
+    std::copy_if(transitions.begin(), transitions.end(), std::back_inserter(independent),
+                 [incoming](std::shared_ptr<Transition> const& t) { return not incoming->depends(t.get()); });
+    if (independent.size() != transitions.size())
+      XBT_DEBUG("%zu transitions of actor %ld wake up, as they depend on >>%s<<",
+                transitions.size() - independent.size(), aid, incoming->to_string().c_str());
+    if (independent.empty())
+      continue;
+    sleep_set_.try_emplace(aid, std::move(independent));
+    /* Actors whose transitions all sleep are marked as done, so that they are not explored */
+    if (auto actor = actors_to_run_.find(aid); actor != actors_to_run_.end() && is_asleep_from(aid, 0))
+      actor->second.set_done();
+  }
+}
+
+bool State::is_asleep(aid_t actor, unsigned int times_considered) const
+{
+  auto sleeping = sleep_set_.find(actor);
+  return sleeping != sleep_set_.end() &&
+         std::any_of(sleeping->second.begin(), sleeping->second.end(), [times_considered](auto const& t) {
+           return t->times_considered_ == static_cast<int>(times_considered);
+         });
+}
+
+bool State::is_asleep_from(aid_t actor, unsigned int times_considered) const
+{
+  for (unsigned int i = times_considered; i < actors_to_run_.at(actor).get_max_consider(); i++)
+    if (not is_asleep(actor, i))
+      return false;
+  return true;
+}
+
 std::size_t State::count_todo() const
 {
   return boost::range::count_if(this->actors_to_run_, [](auto& pair) { return pair.second.is_todo(); });
@@ -50,7 +90,13 @@ aid_t State::next_transition() const
 void State::execute_next(aid_t next)
 {
   /* This actor is ready to be executed. Prepare its execution when simcall_handle will be called on it */
-  const unsigned times_considered = actors_to_run_.at(next).do_consider();
+  ActorState& actor         = actors_to_run_.at(next);
+  unsigned times_considered = actor.do_consider();
+  /* Skip its sleeping transitions. It is done once the remaining ones all sleep, so a transition is always found. */
+  while (is_asleep(next, times_considered) && not actor.is_done())
+    times_considered = actor.do_consider();
+  if (not actor.is_done() && is_asleep_from(next, actor.get_times_considered()))
+    actor.set_done();
 
   XBT_DEBUG("Let's run actor %ld (times_considered = %u)", next, times_considered);
 
@@ -59,4 +105,19 @@ void State::execute_next(aid_t next)
   transition_.reset(mc_model_checker->handle_simcall(next, times_considered, true));
   mc_model_checker->wait_for_requests();
 }
+
+void State::execute_saved(aid_t aid, int times_considered)
+{
+  Transition::executed_transitions_++;
+  transition_.reset(mc_model_checker->handle_simcall(aid, times_considered, true));
+  mc_model_checker->wait_for_requests();
+}
+
+void State::restore_actor(aid_t actor, unsigned char status, unsigned int times_considered)
+{
+  auto state = actors_to_run_.find(actor);
+  xbt_assert(state != actors_to_run_.end(), "Actor %ld of the saved exploration does not exist in state %ld", actor,
+             num_);
+  state->second.set_status(status, times_considered);
+}
 } // namespace simgrid::mc
@@ -18,7 +18,7 @@ class XBT_PRIVATE State : public xbt::Extendable<State> {
   static long expended_states_; /* Count total amount of states, for stats */
 
   /* Outgoing transition: what was the last transition that we took to leave this state? */
-  std::unique_ptr<Transition> transition_;
+  std::shared_ptr<Transition> transition_;
 
   /** Sequential state ID (used for debugging) */
   long num_ = 0;
@@ -29,6 +29,16 @@ class XBT_PRIVATE State : public xbt::Extendable<State> {
   /** Snapshot of system state (if needed) */
   std::shared_ptr<Snapshot> system_state_;
 
+  /** Paused copy of the application in this state (if any, with model-check/fork-checkpoint) */
+  std::unique_ptr<ForkCheckpoint> fork_checkpoint_;
+
+  /** Sleep set (model-check/reduction:sdpor): the transitions of each actor that need not be explored from here. An
+   *  actor may have several transitions (one per times_considered, e.g. for WaitAny), which sleep independently. */
+  std::map<aid_t, std::vector<std::shared_ptr<Transition>>> sleep_set_;
+
+  /* Whether the transitions of the actor are all asleep, from the given times_considered on */
+  bool is_asleep_from(aid_t actor, unsigned int times_considered) const;
+
 public:
   explicit State(const RemoteApp& remote_app);
 
@@ -37,6 +47,9 @@ public:
 
   /* Explore a new path; the parameter must be the result of a previous call to next_transition() */
   void execute_next(aid_t next);
+  /* Take again a transition saved with the exploration frontier, without changing the status of its actor */
+  void execute_saved(aid_t aid, int times_considered);
+  void restore_actor(aid_t actor, unsigned char status, unsigned int times_considered);
 
   long get_num() const { return num_; }
   std::size_t count_todo() const;
@@ -52,6 +65,21 @@ public:
   Snapshot* get_system_state() const { return system_state_.get(); }
   void set_system_state(std::shared_ptr<Snapshot> state) { system_state_ = std::move(state); }
 
+  const ForkCheckpoint* get_fork_checkpoint() const { return fork_checkpoint_.get(); }
+  void set_fork_checkpoint(std::unique_ptr<ForkCheckpoint> checkpoint) { fork_checkpoint_ = std::move(checkpoint); }
+
+  /* Put the outgoing transition in the sleep set, once its subtree is explored */
+  void add_sleep_set() { add_sleep_set(transition_); }
+  void add_sleep_set(std::shared_ptr<Transition> transition)
+  {
+    aid_t aid = transition->aid_;
+    sleep_set_[aid].push_back(std::move(transition));
+  }
+  std::map<aid_t, std::vector<std::shared_ptr<Transition>>> const& get_sleep_set() const { return sleep_set_; }
+  bool is_asleep(aid_t actor, unsigned int times_considered) const;
+  /* Inherit the sleep set of the parent state, keeping the transitions independent of the incoming one */
+  void inherit_sleep_set(const State& parent);
+
   /* Returns the total amount of states created so far (for statistics) */
   static long get_expanded_states() { return expended_states_; }
 };
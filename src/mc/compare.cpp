@@ -11,6 +11,13 @@
 #include "xbt/ex.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_compare, mc, "Logging specific to mc_compare in mc");
 
@@ -62,6 +69,84 @@ public:
   void initHeapInformation(const s_xbt_mheap_t* heap, const std::vector<IgnoredHeapRegion>& i);
 };
 
+/** Threads comparing the memory pages of the snapshots (see StateComparator::compare_pages)
+ *
+ *  This is a plain pool of system threads, as the model checker has no simulation engine to create contexts. The
+ *  calling thread takes part to each job, so there are threads_count - 1 workers. They are kept between the jobs.
+ */
+class PageComparisonWorkers {
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable job_ready_;
+  std::condition_variable job_done_;
+  const std::function<void(std::size_t)>* job_ = nullptr;
+  std::size_t job_count_                        = 0;
+  std::atomic<std::size_t> next_index_{0};
+  unsigned long generation_ = 0; // incremented for each job, so that the workers run each of them once
+  unsigned busy_            = 0; // amount of workers still running the current job
+  bool stopping_            = false;
+
+  void run_job()
+  {
+    for (std::size_t i = next_index_++; i < job_count_; i = next_index_++)
+      (*job_)(i);
+  }
+
+  void worker_main()
+  {
+    unsigned long seen = 0;
+    std::unique_lock lock(mutex_);
+    while (true) {
+      job_ready_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+      if (stopping_)
+        return;
+      seen = generation_;
+      lock.unlock();
+      run_job();
+      lock.lock();
+      if (--busy_ == 0)
+        job_done_.notify_one();
+    }
+  }
+
+public:
+  explicit PageComparisonWorkers(unsigned threads_count)
+  {
+    for (unsigned i = 1; i < threads_count; i++)
+      threads_.emplace_back([this] { worker_main(); });
+  }
+  PageComparisonWorkers(PageComparisonWorkers const&) = delete;
+  PageComparisonWorkers& operator=(PageComparisonWorkers const&) = delete;
+  ~PageComparisonWorkers()
+  {
+    {
+      std::scoped_lock lock(mutex_);
+      stopping_ = true;
+    }
+    job_ready_.notify_all();
+    for (std::thread& thread : threads_)
+      thread.join();
+  }
+
+  /** Call job(i) for each i in [0, count), and return once all of them are done */
+  void apply(const std::function<void(std::size_t)>& job, std::size_t count)
+  {
+    {
+      std::scoped_lock lock(mutex_);
+      job_       = &job;
+      job_count_ = count;
+      next_index_ = 0;
+      busy_       = static_cast<unsigned>(threads_.size());
+      generation_++;
+    }
+    job_ready_.notify_all();
+    run_job();
+    std::unique_lock lock(mutex_);
+    job_done_.wait(lock, [this] { return busy_ == 0; });
+    job_ = nullptr;
+  }
+};
+
 class StateComparator {
 public:
   s_xbt_mheap_t std_heap_copy;
@@ -71,6 +156,12 @@ public:
   std::unordered_set<std::pair<const void*, const void*>, simgrid::xbt::hash<std::pair<const void*, const void*>>>
       compared_pointers;
 
+  /** Whether each page of the heap region holds the same bytes in both snapshots (see compare_pages) */
+  std::vector<unsigned char> unchanged_heap_pages;
+  const char* heap_start = nullptr;
+  /** Threads comparing the pages, created on the first parallel comparison and kept for the next ones */
+  std::unique_ptr<PageComparisonWorkers> workers;
+
   void clear()
   {
     compared_pointers.clear();
@@ -123,6 +214,23 @@ public:
   }
 
   void match_equals(const HeapLocationPairs* list);
+
+  bool compare_pages(const Snapshot& snapshot1, const Snapshot& snapshot2);
+
+  /** Check whether an area of the heap holds the same bytes in both snapshots */
+  bool unchanged(const void* area, std::size_t size) const
+  {
+    if (size == 0)
+      return true;
+    if (static_cast<const char*>(area) < heap_start)
+      return false;
+    std::size_t offset = static_cast<const char*>(area) - heap_start;
+    std::size_t first  = offset >> xbt_pagebits;
+    std::size_t last   = (offset + size - 1) >> xbt_pagebits;
+    return last < unchanged_heap_pages.size() &&
+           std::all_of(unchanged_heap_pages.begin() + first, unchanged_heap_pages.begin() + last + 1,
+                       [](unsigned char unchanged) { return unchanged != 0; });
+  }
 };
 
 } // namespace simgrid::mc
@@ -167,6 +275,79 @@ void StateComparator::match_equals(const HeapLocationPairs* list)
   }
 }
 
+/** Find the regions and the heap pages holding the same bytes in both snapshots
+ *
+ *  Pages with the same index in the PageStore are identical without looking at them. The other ones are compared on
+ *  the model-check/comparison-threads workers. Only the whole result matters for the data regions, so their remaining
+ *  pages are skipped on the first difference. The result of each page is kept for the heap (so its pages are all
+ *  compared, even after a difference): the deep comparison skips reading the bytes of the unchanged areas.
+ *
+ *  @return whether all the regions are unchanged
+ */
+bool StateComparator::compare_pages(const Snapshot& snapshot1, const Snapshot& snapshot2)
+{
+  struct PagePair {
+    std::size_t region;
+    std::size_t page;
+    const void* data1;
+    const void* data2;
+  };
+  std::size_t regions_count = snapshot1.snapshot_regions_.size();
+  std::vector<std::atomic_bool> changed(regions_count);
+  std::vector<PagePair> pairs;
+  std::size_t heap_index = regions_count;
+  unchanged_heap_pages.clear();
+  heap_start = nullptr;
+
+  for (std::size_t k = 0; k != regions_count; ++k) {
+    const Region* region1      = snapshot1.snapshot_regions_[k].get();
+    const Region* region2      = snapshot2.snapshot_regions_[k].get();
+    ChunkedData const& chunks1 = region1->get_chunks();
+    ChunkedData const& chunks2 = region2->get_chunks();
+    std::size_t page_count     = std::min(chunks1.page_count(), chunks2.page_count());
+    changed[k] = region1->start() != region2->start() || chunks1.page_count() != chunks2.page_count();
+    if (region1->region_type() == RegionType::Heap) {
+      heap_index = k;
+      heap_start = static_cast<const char*>(region1->start().local());
+      unchanged_heap_pages.assign(region1->start() == region2->start() ? page_count : 0, 0);
+    } else if (changed[k])
+      continue;
+    for (std::size_t i = 0; i != page_count; ++i) {
+      if (chunks1.pageno(i) != chunks2.pageno(i))
+        // Evicted pages are loaded here: get_page() is not thread-safe
+        pairs.push_back(PagePair{k, i, chunks1.page(i), chunks2.page(i)});
+      else if (k == heap_index && i < unchanged_heap_pages.size())
+        unchanged_heap_pages[i] = 1;
+    }
+  }
+
+  // The pairs are given out by batches, which are skipped once the difference of their data region is known
+  constexpr std::size_t batch_size = 64;
+  std::function<void(std::size_t)> compare = [&](std::size_t batch) {
+    std::size_t begin = batch * batch_size;
+    for (std::size_t i = begin; i != std::min(begin + batch_size, pairs.size()); ++i) {
+      PagePair const& pair = pairs[i];
+      if (pair.region != heap_index && changed[pair.region])
+        continue;
+      if (memcmp(pair.data1, pair.data2, xbt_pagesize) != 0)
+        changed[pair.region] = true;
+      else if (pair.region == heap_index && pair.page < unchanged_heap_pages.size())
+        unchanged_heap_pages[pair.page] = 1;
+    }
+  };
+  std::size_t batches_count = (pairs.size() + batch_size - 1) / batch_size;
+  if (_sg_mc_comparison_threads > 1 && batches_count > 1) {
+    if (workers == nullptr)
+      workers = std::make_unique<PageComparisonWorkers>(_sg_mc_comparison_threads);
+    workers->apply(compare, batches_count);
+  } else {
+    for (std::size_t batch = 0; batch < batches_count; batch++)
+      compare(batch);
+  }
+
+  return std::none_of(changed.begin(), changed.end(), [](std::atomic_bool const& c) { return c.load(); });
+}
+
 void ProcessComparisonState::initHeapInformation(const s_xbt_mheap_t* heap, const std::vector<IgnoredHeapRegion>& i)
 {
   auto heaplimit  = heap->heaplimit;
@@ -461,6 +642,10 @@ static bool heap_area_differ_without_type(const RemoteProcess& process, StateCom
                                           const void* real_area2, const Snapshot& snapshot1, const Snapshot& snapshot2,
                                           HeapLocationPairs* previous, int size, int check_ignore)
 {
+  // Same bytes at the same place: no byte differs, so there is no pointer to follow
+  if (real_area1 == real_area2 && size > 0 && state.unchanged(real_area1, size))
+    return false;
+
   const Region* heap_region1  = MC_get_heap_region(snapshot1);
   const Region* heap_region2  = MC_get_heap_region(snapshot2);
 
@@ -506,6 +691,15 @@ static bool heap_area_differ_without_type(const RemoteProcess& process, StateCom
   return false;
 }
 
+/** Compare the bytes of two heap areas, without reading them when they lie on unchanged pages */
+static bool heap_bytes_differ(const StateComparator& state, const void* area1, const Region* region1,
+                              const void* area2, const Region* region2, int size)
+{
+  if (area1 == area2 && size > 0 && state.unchanged(area1, size))
+    return false;
+  return MC_snapshot_region_memcmp(area1, region1, area2, region2, size) != 0;
+}
+
 /**
  *
  * @param state
@@ -566,13 +760,13 @@ static bool heap_area_differ_with_type(const simgrid::mc::RemoteProcess& process
         if (area_size != -1 && type->byte_size != area_size)
           return false;
         else
-          return MC_snapshot_region_memcmp(real_area1, heap_region1, real_area2, heap_region2, type->byte_size) != 0;
+          return heap_bytes_differ(state, real_area1, heap_region1, real_area2, heap_region2, type->byte_size);
       }
 
     case DW_TAG_enumeration_type:
       if (area_size != -1 && type->byte_size != area_size)
         return false;
-      return MC_snapshot_region_memcmp(real_area1, heap_region1, real_area2, heap_region2, type->byte_size) != 0;
+      return heap_bytes_differ(state, real_area1, heap_region1, real_area2, heap_region2, type->byte_size);
 
     case DW_TAG_typedef:
     case DW_TAG_const_type:
@@ -1205,6 +1399,14 @@ static bool local_variables_differ(const simgrid::mc::RemoteProcess& process, si
 namespace simgrid::mc {
 
 bool Snapshot::operator==(const Snapshot& other)
+{
+  bool equal = equals_to(other);
+  // The comparison may have loaded many evicted pages back, which are not used anymore
+  mc_model_checker->page_store().trim();
+  return equal;
+}
+
+bool Snapshot::equals_to(const Snapshot& other)
 {
   // TODO, make this a field of ModelChecker or something similar
   static StateComparator state_comparator;
@@ -1218,6 +1420,16 @@ bool Snapshot::operator==(const Snapshot& other)
   }
   XBT_VERB("(%ld - %ld) Same hash: 0x%" PRIx64, this->num_state_, other.num_state_, this->hash_);
 
+  size_t regions_count = this->snapshot_regions_.size();
+  if (regions_count != other.snapshot_regions_.size())
+    return false;
+
+  /* Quick pass over the memory pages, to skip the deep comparison of the unchanged areas */
+  if (state_comparator.compare_pages(*this, other)) {
+    XBT_VERB("(%ld - %ld) Same memory pages", this->num_state_, other.num_state_);
+    return true;
+  }
+
   /* TODO: re-enable the quick filter of counting enabled processes in each snapshots */
 
   /* Compare size of stacks */
@@ -1253,10 +1465,6 @@ bool Snapshot::operator==(const Snapshot& other)
     }
   }
 
-  size_t regions_count = this->snapshot_regions_.size();
-  if (regions_count != other.snapshot_regions_.size())
-    return false;
-
   for (size_t k = 0; k != regions_count; ++k) {
     Region* region1 = this->snapshot_regions_[k].get();
     Region* region2 = other.snapshot_regions_[k].get();
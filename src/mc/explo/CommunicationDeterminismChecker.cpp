@@ -320,14 +320,17 @@ void CommDetExtension::handle_comm_pattern(const Transition* transition)
       }
  */
 
-Exploration* create_communication_determinism_checker(const std::vector<char*>& args, bool with_dpor)
+Exploration* create_communication_determinism_checker(const std::vector<char*>& args, ReductionMode mode)
 {
   CommDetExtension::EXTENSION_ID = simgrid::mc::Exploration::extension_create<CommDetExtension>();
   StateCommDet::EXTENSION_ID     = simgrid::mc::State::extension_create<StateCommDet>();
 
   XBT_DEBUG("********* Start communication determinism verification *********");
+  xbt_assert(_sg_mc_frontier_file.get().empty(),
+             "The communication determinism exploration cannot be saved with model-check/frontier-file, as it depends "
+             "on the communication patterns of the first explored path");
 
-  auto base      = new DFSExplorer(args, with_dpor);
+  auto base      = new DFSExplorer(args, mode);
   auto extension = new CommDetExtension(*base);
 
   DFSExplorer::on_exploration_start([extension](RemoteApp const&) {
@@ -9,15 +9,22 @@
 #include "src/mc/mc_exit.hpp"
 #include "src/mc/mc_private.hpp"
 #include "src/mc/mc_record.hpp"
+#include "src/mc/mc_serialization.hpp"
 #include "src/mc/transition/Transition.hpp"
 
 #include "src/xbt/mmalloc/mmprivate.h"
 #include "xbt/log.h"
 #include "xbt/string.hpp"
 #include "xbt/sysdep.h"
+#include "xbt/xbt_os_time.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 
 #include <memory>
 #include <string>
@@ -84,11 +91,146 @@ void DFSExplorer::log_state() // override
            "visited overall)",
            State::get_expanded_states(), backtrack_count_, mc_model_checker->get_visited_states(),
            Transition::get_replayed_transitions());
+  if (reduction_mode_ == ReductionMode::sdpor)
+    XBT_INFO("Source-DPOR: %ld races reversed; %ld states blocked by the sleep sets", race_count_,
+             sleep_blocked_count_);
+}
+
+using namespace serialization;
+
+namespace {
+/* The exploration frontier is saved in a compact binary file (see mc_serialization.hpp):
+ *
+ *  - the magic string, the command line of the application and the reduction mode, to check the resume
+ *  - the counters of backtracks, reversed races and sleep-blocked states
+ *  - the stack depth, then for each state of the stack:
+ *    - the outgoing transition (actor and times_considered), or -1 for the last state
+ *    - the exploration status of each actor (actor, status and times_considered)
+ *    - the sleep set (actor, then times_considered and description of each transition)
+ */
+constexpr Magic frontier_magic{{'S', 'G', 'M', 'C', 'F', 'R', 'N', '1'}};
+} // namespace
+
+/** Save the stack of the exploration in model-check/frontier-file, to resume it later with model-check/resume
+ *
+ *  The file is written next to its previous version, and renamed over it once complete.
+ */
+void DFSExplorer::save_frontier() const
+{
+  std::string const& path = _sg_mc_frontier_file.get();
+  std::string temp_path   = path + ".tmp";
+  std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+  xbt_assert(out.good(), "Cannot open %s to save the exploration frontier", temp_path.c_str());
+
+  write_magic(out, frontier_magic);
+  write_string(out, command_line_);
+  write_value<std::uint8_t>(out, static_cast<std::uint8_t>(reduction_mode_));
+  write_value<std::int64_t>(out, backtrack_count_);
+  write_value<std::int64_t>(out, race_count_);
+  write_value<std::int64_t>(out, sleep_blocked_count_);
+
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(stack_.size()));
+  for (auto const& state : stack_) {
+    const Transition* transition = state == stack_.back() ? nullptr : state->get_transition();
+    write_value<std::int64_t>(out, transition ? transition->aid_ : -1);
+    write_value<std::int32_t>(out, transition ? transition->times_considered_ : 0);
+
+    write_value<std::uint32_t>(out, static_cast<std::uint32_t>(state->get_actors_list().size()));
+    for (auto const& [aid, actor] : state->get_actors_list()) {
+      write_value<std::int64_t>(out, aid);
+      write_value<std::uint8_t>(out, actor.get_status());
+      write_value<std::uint32_t>(out, actor.get_times_considered());
+    }
+
+    write_value<std::uint32_t>(out, static_cast<std::uint32_t>(state->get_sleep_set().size()));
+    for (auto const& [aid, transitions] : state->get_sleep_set()) {
+      write_value<std::int64_t>(out, aid);
+      write_value<std::uint32_t>(out, static_cast<std::uint32_t>(transitions.size()));
+      for (auto const& t : transitions) {
+        write_value<std::int32_t>(out, t->times_considered_);
+        write_string(out, t->serialized_);
+      }
+    }
+  }
+  out.close();
+  xbt_assert(out.good(), "Cannot write the exploration frontier in %s", temp_path.c_str());
+  xbt_assert(std::rename(temp_path.c_str(), path.c_str()) == 0, "Cannot rename %s into %s: %s", temp_path.c_str(),
+             path.c_str(), strerror(errno));
+  XBT_VERB("Exploration frontier saved in %s (depth %zu)", path.c_str(), stack_.size());
+}
+
+/** Rebuild the stack of an exploration saved in model-check/frontier-file, from the initial state of the application
+ *
+ *  The saved transitions are taken again to reach each state of the stack. The status of their actors and their
+ *  sleep sets are then restored, so that the exploration goes on where it was saved.
+ */
+void DFSExplorer::load_frontier()
+{
+  std::string const& path = _sg_mc_frontier_file.get();
+  std::ifstream in(path, std::ios::binary);
+  xbt_assert(in.good(), "Cannot open the exploration frontier %s to resume it", path.c_str());
+
+  xbt_assert(read_magic(in, frontier_magic), "%s is not an exploration frontier", path.c_str());
+  std::string command_line = read_string(in);
+  xbt_assert(command_line == command_line_, "The exploration saved in %s was run on another application: %s",
+             path.c_str(), command_line.c_str());
+  auto mode = static_cast<ReductionMode>(read_value<std::uint8_t>(in));
+  xbt_assert(mode == reduction_mode_, "The exploration saved in %s used the %s reduction, not %s", path.c_str(),
+             to_c_str(mode), to_c_str(reduction_mode_));
+  backtrack_count_     = read_value<std::int64_t>(in);
+  race_count_          = read_value<std::int64_t>(in);
+  sleep_blocked_count_ = read_value<std::int64_t>(in);
+
+  auto depth = read_value<std::uint32_t>(in);
+  xbt_assert(in.good(), "The exploration frontier %s is truncated", path.c_str());
+  if (depth == 0) {
+    XBT_INFO("The exploration saved in %s is already complete", path.c_str());
+    stack_.clear();
+    return;
+  }
+  for (std::uint32_t i = 0; i < depth; i++) {
+    State* state = stack_.back().get();
+    auto aid     = static_cast<aid_t>(read_value<std::int64_t>(in));
+    auto times   = read_value<std::int32_t>(in);
+
+    for (auto actors = read_value<std::uint32_t>(in); actors > 0; actors--) {
+      auto actor  = static_cast<aid_t>(read_value<std::int64_t>(in));
+      auto status = read_value<std::uint8_t>(in);
+      state->restore_actor(actor, status, read_value<std::uint32_t>(in));
+    }
+    for (auto sleeping = read_value<std::uint32_t>(in); sleeping > 0; sleeping--) {
+      auto actor = static_cast<aid_t>(read_value<std::int64_t>(in));
+      for (auto count = read_value<std::uint32_t>(in); count > 0; count--) {
+        auto actor_times = read_value<std::int32_t>(in);
+        std::stringstream stream(read_string(in));
+        xbt_assert(in.good(), "The exploration frontier %s is truncated", path.c_str());
+        std::shared_ptr<Transition> transition(deserialize_transition(actor, actor_times, stream));
+        transition->serialized_ = stream.str();
+        state->add_sleep_set(std::move(transition));
+      }
+    }
+
+    xbt_assert(in.good(), "The exploration frontier %s is truncated", path.c_str());
+    if (i + 1 == depth)
+      break;
+    xbt_assert(aid >= 0, "The exploration frontier %s is corrupted", path.c_str());
+    state->execute_saved(aid, times);
+    on_transition_execute_signal(state->get_transition(), get_remote_app());
+    auto next_state = std::make_unique<State>(get_remote_app());
+    on_state_creation_signal(next_state.get(), get_remote_app());
+    stack_.push_back(std::move(next_state));
+  }
+  XBT_INFO("Resume the exploration saved in %s at depth %u", path.c_str(), depth);
 }
 
 void DFSExplorer::run()
 {
   on_exploration_start_signal(get_remote_app());
+  if (_sg_mc_resume)
+    load_frontier();
+  bool saving      = not _sg_mc_frontier_file.get().empty();
+  double last_save = xbt_os_time();
+
   /* This function runs the DFS algorithm the state space.
    * We do so iteratively instead of recursively, dealing with the call stack manually.
    * This allows one to explore the call stack at will. */
@@ -97,6 +239,11 @@ void DFSExplorer::run()
     /* Get current state */
     State* state = stack_.back().get();
 
+    if (saving && xbt_os_time() - last_save >= _sg_mc_frontier_period) {
+      save_frontier();
+      last_save = xbt_os_time();
+    }
+
     XBT_DEBUG("**************************************************");
     XBT_DEBUG("Exploration depth=%zu (state:#%ld; %zu interleaves todo)", stack_.size(), state->get_num(),
               state->count_todo());
@@ -105,9 +252,9 @@ void DFSExplorer::run()
 
     // Backtrack if we reached the maximum depth
     if (stack_.size() > (std::size_t)_sg_mc_max_depth) {
-      if (reduction_mode_ == ReductionMode::dpor) {
-        XBT_ERROR("/!\\ Max depth of %d reached! THIS WILL PROBABLY BREAK the dpor reduction /!\\",
-                  _sg_mc_max_depth.get());
+      if (reduction_mode_ != ReductionMode::none) {
+        XBT_ERROR("/!\\ Max depth of %d reached! THIS WILL PROBABLY BREAK the %s reduction /!\\",
+                  _sg_mc_max_depth.get(), to_c_str(reduction_mode_));
         XBT_ERROR("/!\\ If bad things happen, disable dpor with --cfg=model-check/reduction:none /!\\");
       } else
         XBT_WARN("/!\\ Max depth reached ! /!\\ ");
@@ -152,6 +299,8 @@ void DFSExplorer::run()
 
     /* Create the new expanded state (copy the state of MCed into our MCer data) */
     auto next_state = std::make_unique<State>(get_remote_app());
+    if (reduction_mode_ == ReductionMode::sdpor)
+      next_state->inherit_sleep_set(*state);
     on_state_creation_signal(next_state.get(), get_remote_app());
 
     if (_sg_mc_termination)
@@ -163,14 +312,18 @@ void DFSExplorer::run()
 
     /* If this is a new state (or if we don't care about state-equality reduction) */
     if (visited_state_ == nullptr) {
-      /* Get an enabled process and insert it in the interleave set of the next state */
+      /* Get an enabled process and insert it in the interleave set of the next state (unless it sleeps) */
       for (auto const& [aid, _] : next_state->get_actors_list()) {
-        if (next_state->is_actor_enabled(aid)) {
+        if (next_state->is_actor_enabled(aid) && not next_state->is_done(aid)) {
           next_state->mark_todo(aid);
-          if (reduction_mode_ == ReductionMode::dpor)
+          if (reduction_mode_ != ReductionMode::none)
             break; // With DPOR, we take the first enabled transition
         }
       }
+      auto const& actors = next_state->get_actors_list();
+      if (reduction_mode_ == ReductionMode::sdpor && next_state->count_todo() == 0 &&
+          std::any_of(actors.begin(), actors.end(), [](auto const& actor) { return actor.second.is_enabled(); }))
+        sleep_blocked_count_++;
 
       mc_model_checker->dot_output("\"%ld\" -> \"%ld\" [%s];\n", state->get_num(), next_state->get_num(),
                                    state->get_transition()->dot_string().c_str());
@@ -181,11 +334,130 @@ void DFSExplorer::run()
                                    state->get_transition()->dot_string().c_str());
 
     stack_.push_back(std::move(next_state));
+
+    if (_sg_mc_fork_checkpoint > 0 && visited_state_ == nullptr && stack_.back()->get_system_state() == nullptr &&
+        (stack_.size() - 1) % _sg_mc_fork_checkpoint == 0)
+      add_fork_checkpoint();
   }
 
+  if (saving)
+    save_frontier(); // An empty frontier, so that resuming a complete exploration does nothing
   log_state();
 }
 
+/** Fork a paused copy of the application in the state at the top of the stack (model-check/fork-checkpoint)
+ *
+ *  When there are already too many copies, the one whose neighbours on the stack are the closest is killed, so that
+ *  the remaining ones stay spread along the stack. The copy of the initial state is always kept.
+ */
+void DFSExplorer::add_fork_checkpoint()
+{
+  std::vector<std::pair<std::size_t, State*>> checkpoints; // Depth of each checkpointed state but the initial one
+  std::size_t depth = 0;
+  for (auto const& state : stack_) {
+    if (depth > 0 && state->get_fork_checkpoint() != nullptr)
+      checkpoints.emplace_back(depth, state.get());
+    depth++;
+  }
+
+  if (checkpoints.size() + 1 >= static_cast<std::size_t>(_sg_mc_max_forks.get())) {
+    if (checkpoints.empty())
+      return;
+    std::size_t victim       = 0;
+    std::size_t smallest_gap = SIZE_MAX;
+    for (std::size_t i = 0; i < checkpoints.size(); i++) {
+      std::size_t previous = i == 0 ? 0 : checkpoints[i - 1].first;
+      std::size_t next     = i + 1 == checkpoints.size() ? stack_.size() - 1 : checkpoints[i + 1].first;
+      if (next - previous < smallest_gap) {
+        smallest_gap = next - previous;
+        victim       = i;
+      }
+    }
+    XBT_DEBUG("Forget the copy of the application at depth %zu", checkpoints[victim].first);
+    checkpoints[victim].second->set_fork_checkpoint(nullptr);
+  }
+
+  XBT_DEBUG("Fork a copy of the application at depth %zu", stack_.size() - 1);
+  stack_.back()->set_fork_checkpoint(get_remote_app().take_fork_checkpoint());
+}
+
+/** Source-DPOR (model-check/reduction:sdpor): reverse the races between the outgoing transition of the given state
+ *  (just popped from the stack) and the transitions of the stack
+ *
+ *  Two transitions race when they are dependent, from different actors, and not ordered by other transitions in
+ *  between. For each race, the state before the first transition must explore one of the actors that can start the
+ *  reversed sequence: the transitions in between that do not happen after the first one, followed by the second one.
+ *  If none of these actors is already explored (or asleep) there, one of them is added to its interleave set.
+ *
+ *  See "Source Sets: A Foundation for Optimal Dynamic Partial Order Reduction", Abdulla et al., JACM 2017.
+ */
+void DFSExplorer::reverse_races(const State* state)
+{
+  std::vector<State*> states;
+  for (auto const& s : stack_)
+    states.push_back(s.get());
+  const Transition* last = state->get_transition();
+  // Whether t1 is directly ordered before t2 (same actor or dependent transitions)
+  auto ordered = [](const Transition* t1, const Transition* t2) { return t1->aid_ == t2->aid_ || t1->depends(t2); };
+
+  std::vector<bool> before_last(states.size()); // Transitions that happen before the last one
+  for (std::size_t i = states.size(); i-- > 0;) {
+    const Transition* first = states[i]->get_transition();
+    bool direct             = ordered(first, last);
+    bool indirect           = false;
+    for (std::size_t j = i + 1; j < states.size() && not indirect; j++)
+      indirect = before_last[j] && ordered(first, states[j]->get_transition());
+    before_last[i] = direct || indirect;
+    if (not direct || indirect || first->aid_ == last->aid_)
+      continue;
+
+    XBT_VERB("Race between >>%s<< (state=%ld) and >>%s<< (state=%ld)", first->to_string().c_str(),
+             states[i]->get_num(), last->to_string().c_str(), state->get_num());
+    std::vector<const Transition*> after{first};
+    std::vector<const Transition*> reversed;
+    for (std::size_t j = i + 1; j < states.size(); j++) {
+      const Transition* t = states[j]->get_transition();
+      if (std::any_of(after.begin(), after.end(), [&ordered, t](const Transition* a) { return ordered(a, t); }))
+        after.push_back(t);
+      else
+        reversed.push_back(t);
+    }
+    reversed.push_back(last);
+
+    // The actors that can start the reversed sequence, the one of the last transition first
+    std::vector<aid_t> initials;
+    for (auto t = reversed.begin(); t != reversed.end(); ++t) {
+      auto ordered_before = [&ordered, t](const Transition* previous) { return ordered(previous, *t); };
+      if (std::none_of(reversed.begin(), t, ordered_before))
+        initials.insert((*t)->aid_ == last->aid_ ? initials.begin() : initials.end(), (*t)->aid_);
+    }
+
+    State* prev_state  = states[i];
+    auto const& actors = prev_state->get_actors_list();
+    if (std::any_of(initials.begin(), initials.end(), [&actors](aid_t aid) {
+          auto actor = actors.find(aid);
+          return actor != actors.end() && not actor->second.is_disabled();
+        })) {
+      XBT_DEBUG("The race is already reversed from state %ld", prev_state->get_num());
+      continue;
+    }
+    auto initial = std::find_if(initials.begin(), initials.end(), [&actors](aid_t aid) {
+      auto actor = actors.find(aid);
+      return actor != actors.end() && actor->second.is_enabled();
+    });
+    if (initial != initials.end()) {
+      XBT_DEBUG("Explore actor %ld from state %ld to reverse the race", *initial, prev_state->get_num());
+      prev_state->mark_todo(*initial);
+    } else {
+      XBT_DEBUG("No initial actor is enabled in state %ld: explore all its enabled actors", prev_state->get_num());
+      for (auto const& [aid, actor] : actors)
+        if (actor.is_enabled() && actor.is_disabled()) // Enabled, but not considered by the checker yet
+          prev_state->mark_todo(aid);
+    }
+    race_count_++;
+  }
+}
+
 void DFSExplorer::backtrack()
 {
   backtrack_count_++;
@@ -227,6 +499,10 @@ void DFSExplorer::backtrack()
           XBT_VERB("  %s (state=%ld)", state->get_transition()->to_string().c_str(), state->get_num());
         }
       }
+    } else if (reduction_mode_ == ReductionMode::sdpor &&
+               state->get_transition()->type_ != Transition::Type::UNKNOWN) { // No transition was executed there
+      reverse_races(state.get());
+      state->add_sleep_set();
     }
 
     if (state->count_todo() == 0) { // Empty interleaving set
@@ -248,31 +524,44 @@ void DFSExplorer::backtrack()
       return;
     }
 
-    /* if no snapshot, we need to restore the initial state and replay the transitions */
-    get_remote_app().restore_initial_state();
+    /* if no snapshot, we need to restore the initial state (or the deepest forked copy) and replay the transitions */
+    auto checkpoint = std::find_if(stack_.rbegin(), stack_.rend(),
+                                   [](auto const& state) { return state->get_fork_checkpoint() != nullptr; });
+    std::size_t start = 0;
+    if (checkpoint != stack_.rend()) {
+      get_remote_app().restore_fork_checkpoint(*(*checkpoint)->get_fork_checkpoint());
+      start = std::distance(checkpoint, stack_.rend()) - 1;
+    } else
+      get_remote_app().restore_initial_state();
     on_restore_initial_state_signal(get_remote_app());
 
     /* Traverse the stack from the state at position start and re-execute the transitions */
+    std::vector<Transition*> path;
     for (std::unique_ptr<State> const& state : stack_) {
       if (state == stack_.back()) /* If we are arrived on the target state, don't replay the outgoing transition */
         break;
-      state->get_transition()->replay();
-      on_transition_replay_signal(state->get_transition(), get_remote_app());
+      path.push_back(state->get_transition());
+    }
+    Transition::replay(std::vector<Transition*>(path.begin() + start, path.end()));
+    /* The observers follow the whole path from the initial state, even the part skipped thanks to a forked copy */
+    for (std::size_t i = 0; i < path.size(); i++) {
+      on_transition_replay_signal(path[i], get_remote_app());
       /* Update statistics */
-      mc_model_checker->inc_visited_states();
+      if (i >= start)
+        mc_model_checker->inc_visited_states();
     }
   } // If no backtracing point, then the stack is empty and the exploration is over
 }
 
-DFSExplorer::DFSExplorer(const std::vector<char*>& args, bool with_dpor) : Exploration(args)
+DFSExplorer::DFSExplorer(const std::vector<char*>& args, ReductionMode mode) : Exploration(args), reduction_mode_(mode)
 {
-  if (with_dpor)
-    reduction_mode_ = ReductionMode::dpor;
-  else
-    reduction_mode_ = ReductionMode::none;
+  /* Skip simgrid-mc itself and the options, that may change when resuming the exploration */
+  for (auto arg = args.begin() + 1; arg != args.end() && *arg != nullptr; ++arg)
+    if (strncmp(*arg, "--cfg=", 6) != 0 && strncmp(*arg, "--log=", 6) != 0)
+      command_line_ += command_line_.empty() ? *arg : std::string(" ") + *arg;
 
   if (_sg_mc_termination) {
-    if (with_dpor) {
+    if (reduction_mode_ != ReductionMode::none) {
       XBT_INFO("Check non progressive cycles (turning DPOR off)");
       reduction_mode_ = ReductionMode::none;
     } else {
@@ -282,6 +571,8 @@ DFSExplorer::DFSExplorer(const std::vector<char*>& args, bool with_dpor) : Explo
     XBT_INFO("Start a DFS exploration. Reduction is: %s.", to_c_str(reduction_mode_));
 
   auto initial_state = std::make_unique<State>(get_remote_app());
+  if (_sg_mc_fork_checkpoint > 0 && initial_state->get_system_state() == nullptr)
+    initial_state->set_fork_checkpoint(get_remote_app().take_fork_checkpoint());
 
   XBT_DEBUG("**************************************************");
 
@@ -290,7 +581,7 @@ DFSExplorer::DFSExplorer(const std::vector<char*>& args, bool with_dpor) : Explo
   for (auto const& [aid, _] : initial_state->get_actors_list()) {
     if (initial_state->is_actor_enabled(aid)) {
       initial_state->mark_todo(aid);
-      if (reduction_mode_ == ReductionMode::dpor) {
+      if (reduction_mode_ != ReductionMode::none) {
         XBT_DEBUG("Actor %ld is TODO, DPOR is ON so let's go for this one.", aid);
         break;
       }
@@ -301,9 +592,9 @@ DFSExplorer::DFSExplorer(const std::vector<char*>& args, bool with_dpor) : Explo
   stack_.push_back(std::move(initial_state));
 }
 
-Exploration* create_dfs_exploration(const std::vector<char*>& args, bool with_dpor)
+Exploration* create_dfs_exploration(const std::vector<char*>& args, ReductionMode mode)
 {
-  return new DFSExplorer(args, with_dpor);
+  return new DFSExplorer(args, mode);
 }
 
 } // namespace simgrid::mc
@@ -17,10 +17,10 @@
 namespace simgrid::mc {
 
 class XBT_PRIVATE DFSExplorer : public Exploration {
-  XBT_DECLARE_ENUM_CLASS(ReductionMode, none, dpor);
-
   ReductionMode reduction_mode_;
   long backtrack_count_        = 0;
+  long race_count_             = 0; // Races reversed by the source sets (sdpor)
+  long sleep_blocked_count_    = 0; // States whose enabled actors all sleep (sdpor)
 
   static xbt::signal<void(RemoteApp&)> on_exploration_start_signal;
   static xbt::signal<void(RemoteApp&)> on_backtracking_signal;
@@ -35,7 +35,7 @@ class XBT_PRIVATE DFSExplorer : public Exploration {
   static xbt::signal<void(RemoteApp&)> on_log_state_signal;
 
 public:
-  explicit DFSExplorer(const std::vector<char*>& args, bool with_dpor);
+  explicit DFSExplorer(const std::vector<char*>& args, ReductionMode mode);
   void run() override;
   RecordTrace get_record_trace() override;
   std::vector<std::string> get_textual_trace() override;
@@ -83,11 +83,18 @@ public:
 private:
   void check_non_termination(const State* current_state);
   void backtrack();
+  void reverse_races(const State* state);
+  void save_frontier() const;
+  void load_frontier();
+  void add_fork_checkpoint();
 
   /** Stack representing the position in the exploration graph */
   std::list<std::unique_ptr<State>> stack_;
   VisitedStates visited_states_;
   std::unique_ptr<VisitedState> visited_state_;
+
+  /** Command line of the application, saved with the exploration frontier to check that it is resumed on the same */
+  std::string command_line_;
 };
 
 } // namespace simgrid::mc
@@ -6,6 +6,7 @@
 #include "src/mc/explo/Exploration.hpp"
 #include "src/mc/mc_config.hpp"
 #include "src/mc/mc_private.hpp"
+#include "xbt/file.hpp"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_explo, mc, "Generic exploration algorithm of the model-checker");
 
@@ -18,6 +19,18 @@ Exploration::Exploration(const std::vector<char*>& args) : remote_app_(std::make
 
 void Exploration::log_state()
 {
+  for (auto const& [region, stats] : mc_model_checker->get_region_stats())
+    XBT_VERB("Snapshots of %s: %lu captures, %zu pages, %f seconds", xbt::Path(region).get_base_name().c_str(),
+             stats.snapshots, stats.pages, stats.time);
+  const PageStore::Stats& pages = mc_model_checker->page_store().get_stats();
+  if (pages.stored_pages > 0)
+    XBT_VERB("Page store: %zu pages stored, %zu distinct (dedup ratio %.2f); %zu evicted pages compressed (ratio %.2f), "
+             "%zu spilled to disk (%.1f%% of the distinct pages), %zu loaded back",
+             pages.stored_pages, pages.new_pages, (double)pages.stored_pages / pages.new_pages, pages.compressed_pages,
+             pages.compressed_bytes > 0 ? (double)(pages.compressed_pages * xbt_pagesize) / pages.compressed_bytes : 0.0,
+             pages.spilled_pages, 100.0 * pages.spilled_pages / pages.new_pages, pages.loaded_pages);
+  if (pages.overshoot_bytes > 0)
+    XBT_VERB("Page store: the pages loaded back exceeded the budget by up to %zu bytes", pages.overshoot_bytes);
   if (not _sg_mc_dot_output_file.get().empty()) {
     mc_model_checker->dot_output("}\n");
     mc_model_checker->dot_output_close();
@@ -111,6 +111,7 @@ void LivenessChecker::replay()
 
   /* Traverse the stack from the initial state and re-execute the transitions */
   int depth = 1;
+  std::vector<Transition*> path;
   for (std::shared_ptr<Pair> const& pair : exploration_stack_) {
     if (pair == exploration_stack_.back())
       break;
@@ -118,7 +119,7 @@ void LivenessChecker::replay()
     std::shared_ptr<State> state = pair->app_state_;
 
     if (pair->exploration_started) {
-      state->get_transition()->replay();
+      path.push_back(state->get_transition());
       XBT_DEBUG("Replay (depth = %d) : %s (%p)", depth, state->get_transition()->to_string().c_str(), state.get());
     }
 
@@ -126,6 +127,7 @@ void LivenessChecker::replay()
     visited_pairs_count_++;
     depth++;
   }
+  Transition::replay(path);
   XBT_DEBUG("**** End Replay ****");
 }
 
@@ -177,7 +179,12 @@ void LivenessChecker::purge_visited_pairs()
   }
 }
 
-LivenessChecker::LivenessChecker(const std::vector<char*>& args) : Exploration(args) {}
+LivenessChecker::LivenessChecker(const std::vector<char*>& args) : Exploration(args)
+{
+  xbt_assert(_sg_mc_frontier_file.get().empty(),
+             "The liveness exploration cannot be saved with model-check/frontier-file, as it depends on the memory "
+             "snapshots of the states on its stack");
+}
 LivenessChecker::~LivenessChecker()
 {
   xbt_automaton_free(property_automaton_);
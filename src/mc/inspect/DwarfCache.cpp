@@ -0,0 +1,245 @@
+/* Copyright (c) 2023. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Cache of the DWARF information of the ELF modules, in the model-check/dwarf-cache directory.
+ *
+ * The types, the global variables and the compilation units index of each module are saved in a binary file named
+ * after its build-id (see mc_serialization.hpp). The addresses are saved relative to the base address of the
+ * module, which may be loaded elsewhere in the next runs. The subprograms are not cached: they are loaded from the
+ * DWARF, one compilation unit at a time (see ObjectInformation::ensure_unit_loaded).
+ */
+
+#include "src/mc/inspect/ObjectInformation.hpp"
+#include "src/mc/inspect/Type.hpp"
+#include "src/mc/inspect/Variable.hpp"
+#include "src/mc/inspect/mc_dwarf.hpp"
+#include "src/mc/mc_config.hpp"
+#include "src/mc/mc_serialization.hpp"
+
+#include "xbt/log.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(mc_dwarf);
+
+namespace simgrid::dwarf {
+
+using namespace simgrid::mc::serialization;
+
+namespace {
+constexpr Magic cache_magic{{'S', 'G', 'M', 'C', 'D', 'W', 'F', '1'}};
+
+std::string cache_path(std::string const& build_id)
+{
+  return _sg_mc_dwarf_cache.get() + "/" + build_id + ".dwarf";
+}
+
+void write_expression(std::ostream& out, DwarfExpression const& expression)
+{
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(expression.size()));
+  for (Dwarf_Op const& op : expression) {
+    write_value<std::uint8_t>(out, op.atom);
+    write_value<std::uint64_t>(out, op.number);
+    write_value<std::uint64_t>(out, op.number2);
+    write_value<std::uint64_t>(out, op.offset);
+  }
+}
+void write_location_list(std::ostream& out, LocationList const& locations, std::uint64_t base)
+{
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(locations.size()));
+  for (LocationListEntry const& entry : locations) {
+    // The expressions valid everywhere are not relocated:
+    bool everywhere = entry.range().begin() == 0 && entry.range().end() == UINT64_MAX;
+    write_value<std::uint8_t>(out, everywhere);
+    if (not everywhere) {
+      write_value<std::uint64_t>(out, entry.range().begin() - base);
+      write_value<std::uint64_t>(out, entry.range().end() - base);
+    }
+    write_expression(out, entry.expression());
+  }
+}
+
+/* A truncated file makes the stream fail, which is checked at the end of load_cache() */
+DwarfExpression read_expression(std::istream& in)
+{
+  DwarfExpression expression(in.good() ? read_value<std::uint32_t>(in) : 0);
+  for (Dwarf_Op& op : expression) {
+    op.atom    = read_value<std::uint8_t>(in);
+    op.number  = read_value<std::uint64_t>(in);
+    op.number2 = read_value<std::uint64_t>(in);
+    op.offset  = read_value<std::uint64_t>(in);
+  }
+  return expression;
+}
+LocationList read_location_list(std::istream& in, std::uint64_t base)
+{
+  LocationList locations;
+  for (auto count = read_value<std::uint32_t>(in); in.good() && count > 0; count--) {
+    LocationListEntry::range_type range = {0, UINT64_MAX};
+    if (not read_value<std::uint8_t>(in)) {
+      range.begin() = base + read_value<std::uint64_t>(in);
+      range.end()   = base + read_value<std::uint64_t>(in);
+    }
+    locations.emplace_back(read_expression(in), range);
+  }
+  return locations;
+}
+} // namespace
+
+bool load_cache(simgrid::mc::ObjectInformation& info, std::string const& build_id)
+{
+  if (_sg_mc_dwarf_cache.get().empty())
+    return false;
+  std::string path = cache_path(build_id);
+  std::ifstream in(path, std::ios::binary);
+  if (not in.good())
+    return false;
+
+  if (not read_magic(in, cache_magic) || read_string(in) != build_id) {
+    XBT_WARN("Ignoring the DWARF cache %s, written by another version of SimGrid", path.c_str());
+    return false;
+  }
+  auto base = reinterpret_cast<std::uint64_t>(info.base_address());
+
+  for (auto count = read_value<std::uint32_t>(in); in.good() && count > 0; count--) {
+    simgrid::mc::Type type;
+    type.type          = read_value<std::int32_t>(in);
+    type.id            = read_value<std::uint32_t>(in);
+    type.name          = read_string(in);
+    type.byte_size     = read_value<std::int32_t>(in);
+    type.element_count = read_value<std::int32_t>(in);
+    type.type_id       = read_value<std::uint32_t>(in);
+    type.members.resize(in.good() ? read_value<std::uint32_t>(in) : 0);
+    for (simgrid::mc::Member& member : type.members) {
+      member.flags               = read_value<std::int32_t>(in);
+      member.name                = read_string(in);
+      member.location_expression = read_expression(in);
+      member.byte_size           = read_value<std::uint64_t>(in);
+      member.type_id             = read_value<std::uint32_t>(in);
+    }
+    info.types[type.id] = std::move(type);
+  }
+
+  for (auto count = read_value<std::uint32_t>(in); in.good() && count > 0; count--) {
+    std::string name = read_string(in);
+    auto type        = info.types.find(read_value<std::uint32_t>(in));
+    if (type != info.types.end())
+      info.full_types_by_name[name] = &type->second;
+  }
+
+  for (auto count = read_value<std::uint32_t>(in); in.good() && count > 0; count--) {
+    simgrid::mc::Variable variable;
+    variable.id      = read_value<std::uint32_t>(in);
+    variable.global  = read_value<std::uint8_t>(in);
+    variable.name    = read_string(in);
+    variable.type_id = read_value<std::uint32_t>(in);
+    if (read_value<std::uint8_t>(in))
+      variable.address = reinterpret_cast<void*>(base + read_value<std::uint64_t>(in));
+    variable.location_list = read_location_list(in, base);
+    variable.start_scope   = read_value<std::uint64_t>(in);
+    variable.object_info   = &info;
+    info.global_variables.push_back(std::move(variable));
+  }
+
+  for (auto count = read_value<std::uint32_t>(in); in.good() && count > 0; count--) {
+    simgrid::mc::CompilationUnitEntry unit;
+    unit.low_pc  = base + read_value<std::uint64_t>(in);
+    unit.high_pc = base + read_value<std::uint64_t>(in);
+    unit.offset  = read_value<std::uint64_t>(in);
+    info.units_index.push_back(unit);
+  }
+
+  if (not in.good()) {
+    XBT_WARN("Ignoring the truncated DWARF cache %s", path.c_str());
+    info.types.clear();
+    info.full_types_by_name.clear();
+    info.global_variables.clear();
+    info.units_index.clear();
+    return false;
+  }
+  XBT_DEBUG("DWARF information of %s loaded from %s", info.file_name.c_str(), path.c_str());
+  return true;
+}
+
+void save_cache(simgrid::mc::ObjectInformation const& info, std::string const& build_id)
+{
+  std::string const& directory = _sg_mc_dwarf_cache.get();
+  if (directory.empty())
+    return;
+  if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST) {
+    XBT_WARN("Cannot create the DWARF cache directory %s: %s", directory.c_str(), strerror(errno));
+    return;
+  }
+
+  // Several checks may run at the same time: each of them writes its own file, and renames it once complete
+  std::string path      = cache_path(build_id);
+  std::string temp_path = path + "." + std::to_string(getpid());
+  std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+  auto base = reinterpret_cast<std::uint64_t>(info.base_address());
+
+  write_magic(out, cache_magic);
+  write_string(out, build_id);
+
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(info.types.size()));
+  for (auto const& [_, type] : info.types) {
+    write_value<std::int32_t>(out, type.type);
+    write_value<std::uint32_t>(out, type.id);
+    write_string(out, type.name);
+    write_value<std::int32_t>(out, type.byte_size);
+    write_value<std::int32_t>(out, type.element_count);
+    write_value<std::uint32_t>(out, type.type_id);
+    write_value<std::uint32_t>(out, static_cast<std::uint32_t>(type.members.size()));
+    for (simgrid::mc::Member const& member : type.members) {
+      write_value<std::int32_t>(out, member.flags);
+      write_string(out, member.name);
+      write_expression(out, member.location_expression);
+      write_value<std::uint64_t>(out, member.byte_size);
+      write_value<std::uint32_t>(out, member.type_id);
+    }
+  }
+
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(info.full_types_by_name.size()));
+  for (auto const& [name, type] : info.full_types_by_name) {
+    write_string(out, name);
+    write_value<std::uint32_t>(out, type->id);
+  }
+
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(info.global_variables.size()));
+  for (simgrid::mc::Variable const& variable : info.global_variables) {
+    write_value<std::uint32_t>(out, variable.id);
+    write_value<std::uint8_t>(out, variable.global);
+    write_string(out, variable.name);
+    write_value<std::uint32_t>(out, variable.type_id);
+    write_value<std::uint8_t>(out, variable.address != nullptr);
+    if (variable.address != nullptr)
+      write_value<std::uint64_t>(out, reinterpret_cast<std::uint64_t>(variable.address) - base);
+    write_location_list(out, variable.location_list, base);
+    write_value<std::uint64_t>(out, variable.start_scope);
+  }
+
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(info.units_index.size()));
+  for (simgrid::mc::CompilationUnitEntry const& unit : info.units_index) {
+    write_value<std::uint64_t>(out, unit.low_pc - base);
+    write_value<std::uint64_t>(out, unit.high_pc - base);
+    write_value<std::uint64_t>(out, unit.offset);
+  }
+
+  out.close();
+  if (not out.good() || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    XBT_WARN("Cannot write the DWARF cache %s: %s", path.c_str(), strerror(errno));
+    std::remove(temp_path.c_str());
+    return;
+  }
+  XBT_DEBUG("DWARF information of %s saved in %s", info.file_name.c_str(), path.c_str());
+}
+
+} // namespace simgrid::dwarf
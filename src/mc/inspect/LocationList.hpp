@@ -35,6 +35,7 @@ public:
 
   DwarfExpression& expression() { return expression_; }
   DwarfExpression const& expression() const { return expression_; }
+  range_type const& range() const { return range_; }
   bool valid_for_ip(unw_word_t ip) const { return range_.contain(ip); }
 };
 
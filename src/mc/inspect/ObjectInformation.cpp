@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <sys/mman.h> // PROT_READ and friends
 #include <vector>
 
@@ -43,6 +44,13 @@ Frame* ObjectInformation::find_function(const void* ip)
 {
   ensure_dwarf_loaded();
 
+  // Load the subprograms of the compilation unit of this instruction, if not done yet:
+  auto address = reinterpret_cast<std::uint64_t>(ip);
+  auto unit    = std::upper_bound(this->units_index.begin(), this->units_index.end(), address,
+                                  [](std::uint64_t addr, auto const& entry) { return addr < entry.low_pc; });
+  if (unit != this->units_index.begin() && address < std::prev(unit)->high_pc)
+    ensure_unit_loaded(std::prev(unit)->offset);
+
   /* This is implemented by binary search on a sorted array.
    *
    * We do quite a lot of those so we want this to be cache efficient.
@@ -125,6 +133,14 @@ void ObjectInformation::remove_local_variable(const char* var_name, const char*
 {
   for (auto& [_, entry] : this->subprograms)
     mc::remove_local_variable(entry, var_name, subprogram_name, entry);
+  this->ignored_local_variables_.emplace_back(var_name, subprogram_name == nullptr ? "" : subprogram_name);
+}
+
+void ObjectInformation::remove_ignored_local_variables(Frame& subprogram) const
+{
+  for (auto const& [var_name, subprogram_name] : this->ignored_local_variables_)
+    mc::remove_local_variable(subprogram, var_name.c_str(), subprogram_name.empty() ? nullptr : subprogram_name.c_str(),
+                              subprogram);
 }
 
 /** @brief Fills the position of the segments (executable, read-only, read/write) */
@@ -9,6 +9,8 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "src/mc/inspect/Frame.hpp"
@@ -29,6 +31,18 @@ struct FunctionIndexEntry {
   simgrid::mc::Frame* function;
 };
 
+/** An entry in the compilation units index
+ *
+ *  See the code of ObjectInformation::find_function.
+ */
+struct CompilationUnitEntry {
+  std::uint64_t low_pc;
+  std::uint64_t high_pc;
+  std::uint64_t offset; // DWARF offset of the DIE of the unit
+};
+
+class DwarfFile;
+
 /** Information about an ELF module (executable or shared object)
  *
  *  This contains all the information we need about an executable or
@@ -47,11 +61,19 @@ struct FunctionIndexEntry {
  *  - etc.
  */
 class ObjectInformation {
-  bool dwarf_loaded = false; // Lazily loads the dwarf info
+  bool dwarf_loaded = false;              // Lazily loads the dwarf info
+  std::unique_ptr<DwarfFile> dwarf_file_; // Kept open to load the compilation units on need
+  std::unordered_set<std::uint64_t> loaded_units_;
+  // Local variables to remove from the compilation units loaded later (variable and subprogram names):
+  std::vector<std::pair<std::string, std::string>> ignored_local_variables_;
+
+  void remove_ignored_local_variables(simgrid::mc::Frame& subprogram) const;
 
 public:
-  void ensure_dwarf_loaded(); // Used by functions that need the dwarf
+  void ensure_dwarf_loaded();                        // Used by functions that need the dwarf
+  void ensure_unit_loaded(std::uint64_t die_offset); // Loads the subprograms of the unit of this DIE
   ObjectInformation() = default;
+  ~ObjectInformation();
 
   // Not copiable:
   ObjectInformation(ObjectInformation const&) = delete;
@@ -75,7 +97,10 @@ public:
   char* start_ro = nullptr;
   char* end_ro   = nullptr;
 
-  /** All of its subprograms indexed by their address */
+  /** Its subprograms indexed by their address
+   *
+   *  Only the subprograms of the compilation units loaded so far are there (see ensure_unit_loaded).
+   */
   std::unordered_map<std::uint64_t, simgrid::mc::Frame> subprograms;
 
   /** Index of functions by instruction address
@@ -91,6 +116,12 @@ public:
    */
   std::vector<FunctionIndexEntry> functions_index;
 
+  /** Index of the compilation units by instruction address, sorted by low_pc
+   *
+   *  A unit is loaded the first time that an instruction in one of its ranges is looked up.
+   */
+  std::vector<CompilationUnitEntry> units_index;
+
   std::vector<simgrid::mc::Variable> global_variables;
 
   /** Types indexed by DWARF ID */
@@ -126,7 +157,7 @@ public:
 
   /** Find a function by instruction address
    *
-   *  Loads the dwarf information on need.
+   *  Loads the dwarf information on need, and the compilation unit of this address.
    *
    *  @param ip instruction address
    *  @return corresponding function (if any) or nullptr
@@ -152,6 +183,8 @@ public:
   void remove_global_variable(const char* name);
 
   /** Remove a local variables (in order to ignore it)
+   *
+   *  The variable is also removed from the compilation units loaded later.
    *
    *  @param name Name of the local variable
    *  @param scope scopes name name of the function (myproject::Foo::count) or null for all functions
@@ -61,20 +61,31 @@ static uint64_t MC_dwarf_subrange_element_count(Dwarf_Die* die, Dwarf_Die* unit)
  */
 static uint64_t MC_dwarf_array_element_count(Dwarf_Die* die, Dwarf_Die* unit);
 
+namespace simgrid::dwarf {
+/** What a walk over the DIEs of a compilation unit loads
+ *
+ *  The types and the global variables (including the static variables of the functions) of all the compilation units
+ *  are loaded with the module. The subprograms, with their scopes and local variables, are loaded one compilation unit
+ *  at a time, when one of its instructions is looked up (see ObjectInformation::find_function).
+ */
+enum class DwarfPass { Globals, Code };
+} // namespace simgrid::dwarf
+
 /** @brief Process a DIE
  *
  *  @param info the resulting object for the library/binary file (output)
  *  @param die  the current DIE
  *  @param unit the DIE of the compile unit of the current DIE
  *  @param frame containing frame if any
+ *  @param pass what is loaded from the DIE
  */
 static void MC_dwarf_handle_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                simgrid::mc::Frame* frame, const char* ns);
+                                simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass);
 
 /** @brief Process a type DIE
  */
 static void MC_dwarf_handle_type_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                     simgrid::mc::Frame* frame, const char* ns);
+                                     simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass);
 
 /** @brief Calls MC_dwarf_handle_die on all children of the given die
  *
@@ -82,9 +93,10 @@ static void MC_dwarf_handle_type_die(simgrid::mc::ObjectInformation* info, Dwarf
  *  @param die  the current DIE
  *  @param unit the DIE of the compile unit of the current DIE
  *  @param frame containing frame if any
+ *  @param pass what is loaded from the DIEs
  */
 static void MC_dwarf_handle_children(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                     simgrid::mc::Frame* frame, const char* ns);
+                                     simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass);
 
 /** @brief Handle a variable (DW_TAG_variable or other)
  *
@@ -92,9 +104,10 @@ static void MC_dwarf_handle_children(simgrid::mc::ObjectInformation* info, Dwarf
  *  @param die  the current DIE
  *  @param unit the DIE of the compile unit of the current DIE
  *  @param frame containing frame if any
+ *  @param pass what is loaded from the DIE
  */
 static void MC_dwarf_handle_variable_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, const Dwarf_Die* unit,
-                                         simgrid::mc::Frame* frame, const char* ns);
+                                         simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass);
 
 /** @brief Get the DW_TAG_type of the DIE
  *
@@ -506,7 +519,7 @@ static void MC_dwarf_add_members(const simgrid::mc::ObjectInformation* /*info*/,
  *  @return MC representation of the type
  */
 static simgrid::mc::Type MC_dwarf_die_to_type(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                              simgrid::mc::Frame* frame, const char* ns)
+                                              simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass)
 {
   simgrid::mc::Type type;
   type.type          = dwarf_tag(die);
@@ -572,7 +585,7 @@ static simgrid::mc::Type MC_dwarf_die_to_type(simgrid::mc::ObjectInformation* in
     case DW_TAG_class_type:
       MC_dwarf_add_members(info, die, unit, &type);
       MC_dwarf_handle_children(info, die, unit, frame,
-                               ns ? simgrid::xbt::string_printf("%s::%s", ns, name).c_str() : type.name.c_str());
+                               ns ? simgrid::xbt::string_printf("%s::%s", ns, name).c_str() : type.name.c_str(), pass);
       break;
 
     default:
@@ -584,9 +597,16 @@ static simgrid::mc::Type MC_dwarf_die_to_type(simgrid::mc::ObjectInformation* in
 }
 
 static void MC_dwarf_handle_type_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                     simgrid::mc::Frame* frame, const char* ns)
+                                     simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass)
 {
-  simgrid::mc::Type type = MC_dwarf_die_to_type(info, die, unit, frame, ns);
+  if (pass == simgrid::dwarf::DwarfPass::Code) {
+    // The types are already loaded, only look for the subprograms defined in the structures:
+    int tag = dwarf_tag(die);
+    if (tag == DW_TAG_structure_type || tag == DW_TAG_union_type || tag == DW_TAG_class_type)
+      MC_dwarf_die_to_type(info, die, unit, frame, ns, pass);
+    return;
+  }
+  simgrid::mc::Type type = MC_dwarf_die_to_type(info, die, unit, frame, ns, pass);
   auto& t                = (info->types[type.id] = std::move(type));
   if (not t.name.empty() && type.byte_size != 0)
     info->full_types_by_name[t.name] = &t;
@@ -690,22 +710,26 @@ static std::unique_ptr<simgrid::mc::Variable> MC_die_to_variable(simgrid::mc::Ob
 }
 
 static void MC_dwarf_handle_variable_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, const Dwarf_Die* unit,
-                                         simgrid::mc::Frame* frame, const char* ns)
+                                         simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass)
 {
+  // The global variables are loaded with the module, and the local ones with the subprograms:
+  if (pass == simgrid::dwarf::DwarfPass::Code && frame == nullptr)
+    return;
   std::unique_ptr<simgrid::mc::Variable> variable = MC_die_to_variable(info, die, unit, frame, ns);
   if (not variable)
     return;
   // Those arrays are sorted later:
-  if (variable->global)
-    info->global_variables.push_back(std::move(*variable));
-  else if (frame != nullptr)
-    frame->variables.push_back(std::move(*variable));
-  else
+  if (variable->global) {
+    if (pass == simgrid::dwarf::DwarfPass::Globals)
+      info->global_variables.push_back(std::move(*variable));
+  } else if (frame == nullptr)
     xbt_die("No frame for this local variable");
+  else if (pass == simgrid::dwarf::DwarfPass::Code)
+    frame->variables.push_back(std::move(*variable));
 }
 
 static void MC_dwarf_handle_scope_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                      simgrid::mc::Frame* parent_frame, const char* ns)
+                                      simgrid::mc::Frame* parent_frame, const char* ns, simgrid::dwarf::DwarfPass pass)
 {
   // TODO, handle DW_TAG_type/DW_TAG_location for DW_TAG_with_stmt
   int tag                        = dwarf_tag(die);
@@ -723,6 +747,12 @@ static void MC_dwarf_handle_scope_die(simgrid::mc::ObjectInformation* info, Dwar
   frame.id          = dwarf_dieoffset(die);
   frame.object_info = info;
 
+  if (pass == simgrid::dwarf::DwarfPass::Globals) {
+    // Only look for the types and the static variables: the scope itself is loaded with its compilation unit
+    MC_dwarf_handle_children(info, die, unit, &frame, ns, pass);
+    return;
+  }
+
   if (klass == simgrid::dwarf::TagClass::Subprogram) {
     const char* name = MC_dwarf_attr_integrate_string(die, DW_AT_name);
     if (name && ns)
@@ -775,7 +805,7 @@ static void MC_dwarf_handle_scope_die(simgrid::mc::ObjectInformation* info, Dwar
   }
 
   // Handle children:
-  MC_dwarf_handle_children(info, die, unit, &frame, ns);
+  MC_dwarf_handle_children(info, die, unit, &frame, ns, pass);
 
   // We sort them in order to have an (somewhat) efficient by name
   // lookup:
@@ -789,48 +819,48 @@ static void MC_dwarf_handle_scope_die(simgrid::mc::ObjectInformation* info, Dwar
 }
 
 static void mc_dwarf_handle_namespace_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                          simgrid::mc::Frame* frame, const char* ns)
+                                          simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass)
 {
   const char* name = MC_dwarf_attr_integrate_string(die, DW_AT_name);
   xbt_assert(not frame, "Unexpected namespace in a subprogram");
   char* new_ns = ns == nullptr ? xbt_strdup(name) : bprintf("%s::%s", ns, name);
-  MC_dwarf_handle_children(info, die, unit, frame, new_ns);
+  MC_dwarf_handle_children(info, die, unit, frame, new_ns, pass);
   xbt_free(new_ns);
 }
 
 static void MC_dwarf_handle_children(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                     simgrid::mc::Frame* frame, const char* ns)
+                                     simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass)
 {
   // For each child DIE:
   Dwarf_Die child;
   for (int res = dwarf_child(die, &child); res == 0; res = dwarf_siblingof(&child, &child))
-    MC_dwarf_handle_die(info, &child, unit, frame, ns);
+    MC_dwarf_handle_die(info, &child, unit, frame, ns, pass);
 }
 
 static void MC_dwarf_handle_die(simgrid::mc::ObjectInformation* info, Dwarf_Die* die, Dwarf_Die* unit,
-                                simgrid::mc::Frame* frame, const char* ns)
+                                simgrid::mc::Frame* frame, const char* ns, simgrid::dwarf::DwarfPass pass)
 {
   int tag                        = dwarf_tag(die);
   simgrid::dwarf::TagClass klass = simgrid::dwarf::classify_tag(tag);
   switch (klass) {
     // Type:
     case simgrid::dwarf::TagClass::Type:
-      MC_dwarf_handle_type_die(info, die, unit, frame, ns);
+      MC_dwarf_handle_type_die(info, die, unit, frame, ns, pass);
       break;
 
       // Subprogram or scope:
     case simgrid::dwarf::TagClass::Subprogram:
     case simgrid::dwarf::TagClass::Scope:
-      MC_dwarf_handle_scope_die(info, die, unit, frame, ns);
+      MC_dwarf_handle_scope_die(info, die, unit, frame, ns, pass);
       return;
 
       // Variable:
     case simgrid::dwarf::TagClass::Variable:
-      MC_dwarf_handle_variable_die(info, die, unit, frame, ns);
+      MC_dwarf_handle_variable_die(info, die, unit, frame, ns, pass);
       break;
 
     case simgrid::dwarf::TagClass::Namespace:
-      mc_dwarf_handle_namespace_die(info, die, unit, frame, ns);
+      mc_dwarf_handle_namespace_die(info, die, unit, frame, ns, pass);
       break;
 
     default:
@@ -847,18 +877,35 @@ static Elf64_Half get_type(Elf* elf)
   xbt_die("Could not get ELF heeader");
 }
 
+/** Load the types and the global variables of all the compilation units, and index the units by address */
 static void read_dwarf_info(simgrid::mc::ObjectInformation* info, Dwarf* dwarf)
 {
+  auto base = reinterpret_cast<std::uint64_t>(info->base_address());
+
   // For each compilation unit:
   Dwarf_Off offset      = 0;
   Dwarf_Off next_offset = 0;
   size_t length;
 
   while (dwarf_nextcu(dwarf, offset, &next_offset, &length, nullptr, nullptr, nullptr) == 0) {
-    if (Dwarf_Die unit_die; dwarf_offdie(dwarf, offset + length, &unit_die) != nullptr)
-      MC_dwarf_handle_children(info, &unit_die, &unit_die, nullptr, nullptr);
+    if (Dwarf_Die unit_die; dwarf_offdie(dwarf, offset + length, &unit_die) != nullptr) {
+      MC_dwarf_handle_children(info, &unit_die, &unit_die, nullptr, nullptr, simgrid::dwarf::DwarfPass::Globals);
+
+      // Index the code of the unit, to load its subprograms on need. The units without code are only loaded when one
+      // of their subprograms is the abstract origin of an inlined subroutine.
+      Dwarf_Addr unit_base;
+      Dwarf_Addr start;
+      Dwarf_Addr end;
+      std::ptrdiff_t pos = 0;
+      while ((pos = dwarf_ranges(&unit_die, pos, &unit_base, &start, &end)) > 0)
+        if (start != 0)
+          info->units_index.push_back({base + start, base + end, dwarf_dieoffset(&unit_die)});
+    }
     offset = next_offset;
   }
+
+  boost::range::sort(info->units_index, [](simgrid::mc::CompilationUnitEntry const& a,
+                                           simgrid::mc::CompilationUnitEntry const& b) { return a.low_pc < b.low_pc; });
 }
 
 /** Get the build-id (NT_GNU_BUILD_ID) from the ELF file
@@ -966,33 +1013,59 @@ static int find_by_build_id(std::vector<std::byte> id)
   return -1;
 }
 
-/** @brief Populate the debugging information of the given ELF object
+namespace simgrid::mc {
+
+/** The DWARF information of an ELF module, kept open to load its compilation units on need */
+class DwarfFile {
+public:
+  int fd       = -1;
+  Elf* elf     = nullptr;
+  Dwarf* dwarf = nullptr;
+  std::string build_id; // In hexadecimal (empty if none is found)
+
+  DwarfFile() = default;
+  DwarfFile(DwarfFile const&) = delete;
+  DwarfFile& operator=(DwarfFile const&) = delete;
+  ~DwarfFile()
+  {
+    if (dwarf != nullptr)
+      dwarf_end(dwarf);
+    if (elf != nullptr)
+      elf_end(elf);
+    if (fd >= 0)
+      close(fd);
+  }
+};
+
+} // namespace simgrid::mc
+
+/** @brief Open the debugging information of the given ELF object
  *
- *  Read the DWARF information of the ELF object and populate the
- *  lists of types, variables, functions.
+ *  The DWARF information is either in the ELF object itself, or in a separate debug file.
  */
-static void MC_load_dwarf(simgrid::mc::ObjectInformation* info)
+static std::unique_ptr<simgrid::mc::DwarfFile> MC_open_dwarf(simgrid::mc::ObjectInformation* info)
 {
   xbt_assert(elf_version(EV_CURRENT) != EV_NONE, "libelf initialization error");
+  auto file = std::make_unique<simgrid::mc::DwarfFile>();
 
   // Open the ELF file:
-  int fd = open(info->file_name.c_str(), O_RDONLY);
-  xbt_assert(fd >= 0, "Could not open file %s", info->file_name.c_str());
-  Elf* elf = elf_begin(fd, ELF_C_READ, nullptr);
-  xbt_assert(elf != nullptr && elf_kind(elf) == ELF_K_ELF, "%s is not an ELF file", info->file_name.c_str());
+  file->fd = open(info->file_name.c_str(), O_RDONLY);
+  xbt_assert(file->fd >= 0, "Could not open file %s", info->file_name.c_str());
+  file->elf = elf_begin(file->fd, ELF_C_READ, nullptr);
+  xbt_assert(file->elf != nullptr && elf_kind(file->elf) == ELF_K_ELF, "%s is not an ELF file",
+             info->file_name.c_str());
 
   // Remember if this is a `ET_EXEC` (fixed location) or `ET_DYN`:
-  if (get_type(elf) == ET_EXEC)
+  if (get_type(file->elf) == ET_EXEC)
     info->flags |= simgrid::mc::ObjectInformation::Executable;
 
+  std::vector<std::byte> build_id = get_build_id(file->elf);
+  file->build_id                  = to_hex(build_id);
+
   // Read DWARF debug information in the file:
-  if (Dwarf* dwarf = dwarf_begin_elf(elf, DWARF_C_READ, nullptr)) {
-    read_dwarf_info(info, dwarf);
-    dwarf_end(dwarf);
-    elf_end(elf);
-    close(fd);
-    return;
-  }
+  file->dwarf = dwarf_begin_elf(file->elf, DWARF_C_READ, nullptr);
+  if (file->dwarf != nullptr)
+    return file;
 
   // If there was no DWARF in the file, try to find it in a separate file.
   // Different methods might be used to store the DWARF information:
@@ -1003,31 +1076,28 @@ static void MC_load_dwarf(simgrid::mc::ObjectInformation* info)
 
   // Try with NT_GNU_BUILD_ID: we find the build ID in the ELF file and then
   // use this ID to find the file in some known locations in the filesystem.
-  if (std::vector<std::byte> build_id = get_build_id(elf); not build_id.empty()) {
-    elf_end(elf);
-    close(fd);
+  if (not build_id.empty()) {
+    elf_end(file->elf);
+    file->elf = nullptr;
+    close(file->fd);
 
     // Find the debug file using the build id:
-    fd = find_by_build_id(build_id);
-    xbt_assert(fd != -1,
+    file->fd = find_by_build_id(build_id);
+    xbt_assert(file->fd != -1,
                "Missing debug info for %s with build-id %s\n"
                "You might want to install the suitable debugging package.\n",
-               info->file_name.c_str(), to_hex(build_id).c_str());
+               info->file_name.c_str(), file->build_id.c_str());
 
     // Load the DWARF info from this file:
     XBT_DEBUG("Load DWARF for %s", info->file_name.c_str());
-    Dwarf* dwarf = dwarf_begin(fd, DWARF_C_READ);
-    xbt_assert(dwarf != nullptr, "No DWARF info for %s", info->file_name.c_str());
-    read_dwarf_info(info, dwarf);
-    dwarf_end(dwarf);
-    close(fd);
-    return;
+    file->dwarf = dwarf_begin(file->fd, DWARF_C_READ);
+    xbt_assert(file->dwarf != nullptr, "No DWARF info for %s", info->file_name.c_str());
+    return file;
   }
 
   // TODO, try to find DWARF info using .gnu_debuglink.
 
-  elf_end(elf);
-  close(fd);
+  file.reset();
   xbt_die("Debugging information not found for %s\n"
           "Try recompiling with -g\n",
           info->file_name.c_str());
@@ -1035,26 +1105,26 @@ static void MC_load_dwarf(simgrid::mc::ObjectInformation* info)
 
 // ***** Functions index
 
-static void MC_make_functions_index(simgrid::mc::ObjectInformation* info)
+static void MC_index_functions(simgrid::mc::ObjectInformation* info, std::vector<simgrid::mc::Frame*> const& functions)
 {
-  info->functions_index.clear();
+  auto by_low_pc = [](simgrid::mc::FunctionIndexEntry const& a, simgrid::mc::FunctionIndexEntry const& b) {
+    return a.low_pc < b.low_pc;
+  };
 
-  for (auto& [_, e] : info->subprograms) {
-    if (e.range.begin() == 0)
+  std::vector<simgrid::mc::FunctionIndexEntry> entries;
+  for (simgrid::mc::Frame* e : functions) {
+    if (e->range.begin() == 0)
       continue;
     simgrid::mc::FunctionIndexEntry entry;
-    entry.low_pc   = (void*)e.range.begin();
-    entry.function = &e;
-    info->functions_index.push_back(entry);
+    entry.low_pc   = (void*)e->range.begin();
+    entry.function = e;
+    entries.push_back(entry);
   }
 
-  info->functions_index.shrink_to_fit();
-
-  // Sort the array by low_pc:
-  boost::range::sort(info->functions_index,
-                     [](simgrid::mc::FunctionIndexEntry const& a, simgrid::mc::FunctionIndexEntry const& b) {
-                       return a.low_pc < b.low_pc;
-                     });
+  // Merge them in the array, sorted by low_pc:
+  boost::range::sort(entries, by_low_pc);
+  auto middle = info->functions_index.insert(info->functions_index.end(), entries.begin(), entries.end());
+  std::inplace_merge(info->functions_index.begin(), middle, info->functions_index.end(), by_low_pc);
 }
 
 static void MC_post_process_variables(simgrid::mc::ObjectInformation* info)
@@ -1072,6 +1142,10 @@ static void mc_post_process_scope(simgrid::mc::ObjectInformation* info, simgrid:
   if (scope->tag == DW_TAG_inlined_subroutine) {
     // Attach correct namespaced name in inlined subroutine:
     auto i = info->subprograms.find(scope->abstract_origin_id);
+    if (i == info->subprograms.end()) { // The abstract origin may be in another compilation unit
+      info->ensure_unit_loaded(scope->abstract_origin_id);
+      i = info->subprograms.find(scope->abstract_origin_id);
+    }
     xbt_assert(i != info->subprograms.end(), "Could not lookup abstract origin %" PRIx64,
                (std::uint64_t)scope->abstract_origin_id);
     scope->name = i->second.name;
@@ -1122,18 +1196,56 @@ static void MC_post_process_types(simgrid::mc::ObjectInformation* info)
 
 namespace simgrid::mc {
 
+ObjectInformation::~ObjectInformation() = default;
+
 void ObjectInformation::ensure_dwarf_loaded()
 {
   if (dwarf_loaded)
     return;
   dwarf_loaded = true;
 
-  MC_load_dwarf(this);
+  dwarf_file_ = MC_open_dwarf(this);
+  bool cached = not dwarf_file_->build_id.empty() && simgrid::dwarf::load_cache(*this, dwarf_file_->build_id);
+  if (not cached)
+    read_dwarf_info(this, dwarf_file_->dwarf);
   MC_post_process_variables(this);
   MC_post_process_types(this);
-  for (auto& [_, entry] : this->subprograms)
-    mc_post_process_scope(this, &entry);
-  MC_make_functions_index(this);
+  if (not cached && not dwarf_file_->build_id.empty())
+    simgrid::dwarf::save_cache(*this, dwarf_file_->build_id);
+}
+
+void ObjectInformation::ensure_unit_loaded(std::uint64_t die_offset)
+{
+  ensure_dwarf_loaded();
+
+  Dwarf_Die die;
+  Dwarf_Die unit_die;
+  xbt_assert(dwarf_offdie(dwarf_file_->dwarf, die_offset, &die) != nullptr &&
+                 dwarf_diecu(&die, &unit_die, nullptr, nullptr) != nullptr,
+             "Could not find the compilation unit of the DIE <%" PRIx64 "> in %s", die_offset, file_name.c_str());
+  if (not loaded_units_.insert(dwarf_dieoffset(&unit_die)).second)
+    return;
+
+  XBT_DEBUG("Load the compilation unit <%" PRIx64 "> of %s", (std::uint64_t)dwarf_dieoffset(&unit_die),
+            file_name.c_str());
+  MC_dwarf_handle_children(this, &unit_die, &unit_die, nullptr, nullptr, simgrid::dwarf::DwarfPass::Code);
+
+  // The DIEs of the unit are between its header and the header of the next unit:
+  Dwarf_Off header = dwarf_dieoffset(&unit_die) - dwarf_cuoffset(&unit_die);
+  Dwarf_Off next_header;
+  size_t header_size;
+  if (dwarf_nextcu(dwarf_file_->dwarf, header, &next_header, &header_size, nullptr, nullptr, nullptr) != 0)
+    next_header = UINT64_MAX;
+  std::vector<Frame*> unit_subprograms;
+  for (auto& [id, entry] : this->subprograms)
+    if (id >= header && id < next_header)
+      unit_subprograms.push_back(&entry);
+
+  for (Frame* entry : unit_subprograms) {
+    mc_post_process_scope(this, entry);
+    remove_ignored_local_variables(*entry);
+  }
+  MC_index_functions(this, unit_subprograms);
 }
 
 /** @brief Finds information about a given shared object/executable */
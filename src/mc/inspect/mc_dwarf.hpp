@@ -10,6 +10,8 @@
 
 #include "src/mc/mc_forward.hpp"
 
+#include <string>
+
 namespace simgrid::dwarf {
 
 XBT_PRIVATE const char* attrname(int attr);
@@ -21,6 +23,18 @@ XBT_PRIVATE void* resolve_member(const void* base, const simgrid::mc::Type* type
 XBT_PRIVATE
 int dwarf_register_to_libunwind(int dwarf_register);
 
+/** Load the types, global variables and compilation units index of an ELF module from the model-check/dwarf-cache
+ *  directory
+ *
+ *  @param build_id build-id of the module, in hexadecimal
+ *  @return whether the module was found in the cache
+ */
+XBT_PRIVATE bool load_cache(simgrid::mc::ObjectInformation& info, std::string const& build_id);
+
+/** Save the types, global variables and compilation units index of an ELF module in the model-check/dwarf-cache
+ *  directory (if any) */
+XBT_PRIVATE void save_cache(simgrid::mc::ObjectInformation const& info, std::string const& build_id);
+
 } // namespace simgrid::dwarf
 
 #endif
@@ -42,10 +42,10 @@ simgrid::config::Flag<bool> _sg_mc_timeout{
 int _sg_mc_max_visited_states = 0;
 
 static simgrid::config::Flag<std::string> cfg_mc_reduction{
-    "model-check/reduction", "Specify the kind of exploration reduction (either none or DPOR)", "dpor",
+    "model-check/reduction", "Specify the kind of exploration reduction (either none, dpor or sdpor)", "dpor",
     [](std::string_view value) {
-      if (value != "none" && value != "dpor")
-        xbt_die("configuration option 'model-check/reduction' can only take 'none' or 'dpor' as a value");
+      if (value != "none" && value != "dpor" && value != "sdpor")
+        xbt_die("configuration option 'model-check/reduction' can only take 'none', 'dpor' or 'sdpor' as a value");
     }};
 
 simgrid::config::Flag<int> _sg_mc_checkpoint{
@@ -55,6 +55,73 @@ simgrid::config::Flag<int> _sg_mc_checkpoint{
                               "compromises between speed and memory consumption.",
     0, [](int) { _mc_cfg_cb_check("checkpointing value"); }};
 
+simgrid::config::Flag<int> _sg_mc_comparison_threads{
+    "model-check/comparison-threads",
+    "Amount of threads comparing the memory pages of the snapshots before the state comparison (default: 1)", 1,
+    [](int value) {
+      _mc_cfg_cb_check("amount of comparison threads");
+      xbt_assert(value >= 1, "The amount of comparison threads must be positive");
+    }};
+
+simgrid::config::Flag<std::string> _sg_mc_dwarf_cache{
+    "model-check/dwarf-cache",
+    "Directory where the types and global variables read from the DWARF information of the application and of its "
+    "libraries are cached, to start the next checks of the same binaries faster (default: empty => no cache)",
+    "", [](const std::string&) { _mc_cfg_cb_check("directory of the DWARF cache"); }};
+
+simgrid::config::Flag<int> _sg_mc_fork_checkpoint{
+    "model-check/fork-checkpoint",
+    "Fork a paused copy of the application every that many steps of a stateless exploration, to backtrack from the "
+    "nearest copy instead of replaying the path from the initial state (default: 0 => disabled)",
+    0, [](int) { _mc_cfg_cb_check("fork checkpointing value"); }};
+
+simgrid::config::Flag<int> _sg_mc_max_forks{
+    "model-check/max-forks", "Maximal amount of paused copies of the application kept with model-check/fork-checkpoint",
+    16, [](int value) {
+      _mc_cfg_cb_check("maximal amount of forks");
+      xbt_assert(value >= 1, "The maximal amount of forks must be positive");
+    }};
+
+simgrid::config::Flag<std::string> _sg_mc_frontier_file{
+    "model-check/frontier-file",
+    "File where the frontier of the DFS exploration is regularly saved, to resume it later with model-check/resume "
+    "(default: empty => not saved)",
+    "", [](const std::string&) { _mc_cfg_cb_check("file of the exploration frontier"); }};
+
+simgrid::config::Flag<int> _sg_mc_frontier_period{
+    "model-check/frontier-period", "Amount of seconds between two saves of the exploration frontier (default: 600)",
+    600, [](int value) {
+      _mc_cfg_cb_check("period of the exploration frontier saves");
+      xbt_assert(value >= 0, "The period of the exploration frontier saves cannot be negative");
+    }};
+
+simgrid::config::Flag<bool> _sg_mc_resume{
+    "model-check/resume", "Resume the exploration saved in model-check/frontier-file instead of starting over", false,
+    [](bool) { _mc_cfg_cb_check("exploration resume"); }};
+
+simgrid::config::Flag<int> _sg_mc_page_store_budget{
+    "model-check/page-store-budget",
+    "Memory budget of the snapshot pages, in MiB. Beyond that, the pages not used recently are compressed or spilled "
+    "to a temporary file (default: 0 => no limit)",
+    0, [](int value) {
+      _mc_cfg_cb_check("page store budget");
+      xbt_assert(value >= 0, "The page store budget cannot be negative");
+    }};
+
+simgrid::config::Flag<bool> _sg_mc_soft_dirty{
+    "model-check/soft-dirty",
+    "Use the soft-dirty bits of the kernel to only capture (and restore) the pages modified since the last snapshot "
+    "or restore",
+    false, [](bool) { _mc_cfg_cb_check("value to enable/disable the soft-dirty page tracking"); }};
+
+simgrid::config::Flag<std::string> _sg_mc_transport{
+    "model-check/transport",
+    "How the messages are exchanged between the model checker and the application",
+    "socket",
+    {{"socket", "Through a SOCK_SEQPACKET socket"},
+     {"shm", "Through rings in shared memory, with futex doorbells (the socket only detects the end of the application)"}},
+    [](std::string_view) { _mc_cfg_cb_check("transport"); }};
+
 simgrid::config::Flag<std::string> _sg_mc_property_file{
     "model-check/property", "Name of the file containing the property, as formatted by the ltl2ba program.", "",
     [](const std::string&) { _mc_cfg_cb_check("property"); }};
@@ -115,13 +182,17 @@ simgrid::config::Flag<bool> _sg_mc_termination{
     "model-check/termination", "Whether to enable non progressive cycle detection", false,
     [](bool) { _mc_cfg_cb_check("value to enable/disable the detection of non progressive cycles"); }};
 
-bool simgrid::mc::cfg_use_DPOR()
+simgrid::mc::ReductionMode simgrid::mc::get_model_checking_reduction()
 {
-  if (cfg_mc_reduction.get() == "dpor" && _sg_mc_max_visited_states__ > 0) {
+  if (cfg_mc_reduction.get() != "none" && _sg_mc_max_visited_states__ > 0) {
     XBT_INFO("Disabling DPOR since state-equality reduction is activated with 'model-check/visited'");
-    return false;
+    return ReductionMode::none;
   }
-  return cfg_mc_reduction.get() == "dpor";
+  if (cfg_mc_reduction.get() == "dpor")
+    return ReductionMode::dpor;
+  if (cfg_mc_reduction.get() == "sdpor")
+    return ReductionMode::sdpor;
+  return ReductionMode::none;
 }
 
 #endif
@@ -7,15 +7,27 @@
 #define MC_CONFIG_HPP
 
 #include <xbt/config.hpp>
+#include <xbt/utility.hpp>
 
 /********************************** Configuration of MC **************************************/
 namespace simgrid::mc {
-bool cfg_use_DPOR(); // "model-check/reduction" == "DPOR"
+XBT_DECLARE_ENUM_CLASS(ReductionMode, none, dpor, sdpor);
+ReductionMode get_model_checking_reduction(); // "model-check/reduction"
 extern XBT_PUBLIC bool cfg_do_model_check;
 };
 
 extern XBT_PUBLIC simgrid::config::Flag<std::string> _sg_mc_buffering;
 extern XBT_PRIVATE simgrid::config::Flag<int> _sg_mc_checkpoint;
+extern XBT_PRIVATE simgrid::config::Flag<int> _sg_mc_comparison_threads;
+extern XBT_PRIVATE simgrid::config::Flag<std::string> _sg_mc_dwarf_cache;
+extern XBT_PRIVATE simgrid::config::Flag<int> _sg_mc_fork_checkpoint;
+extern XBT_PRIVATE simgrid::config::Flag<std::string> _sg_mc_frontier_file;
+extern XBT_PRIVATE simgrid::config::Flag<int> _sg_mc_frontier_period;
+extern XBT_PRIVATE simgrid::config::Flag<bool> _sg_mc_resume;
+extern XBT_PRIVATE simgrid::config::Flag<int> _sg_mc_max_forks;
+extern XBT_PRIVATE simgrid::config::Flag<int> _sg_mc_page_store_budget;
+extern XBT_PRIVATE simgrid::config::Flag<bool> _sg_mc_soft_dirty;
+extern XBT_PRIVATE simgrid::config::Flag<std::string> _sg_mc_transport;
 extern XBT_PUBLIC simgrid::config::Flag<std::string> _sg_mc_property_file;
 extern XBT_PUBLIC simgrid::config::Flag<bool> _sg_mc_comms_determinism;
 extern XBT_PUBLIC simgrid::config::Flag<bool> _sg_mc_send_determinism;
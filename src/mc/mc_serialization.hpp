@@ -0,0 +1,65 @@
+/* Copyright (c) 2023. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Binary files of the model checker (exploration frontier, DWARF cache).
+ *
+ * The values are written in the byte order of the machine: these files are not meant to be moved to another one.
+ * Each file starts with a magic string naming its format and version. The reading functions let the stream fail on
+ * truncated files (the values read then are zeros), so the callers check the stream where it matters.
+ */
+
+#ifndef SIMGRID_MC_SERIALIZATION_HPP
+#define SIMGRID_MC_SERIALIZATION_HPP
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace simgrid::mc::serialization {
+
+using Magic = std::array<char, 8>;
+
+inline void write_magic(std::ostream& out, Magic const& magic)
+{
+  out.write(magic.data(), magic.size());
+}
+template <typename T> void write_value(std::ostream& out, T value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+inline void write_string(std::ostream& out, std::string const& value)
+{
+  write_value<std::uint32_t>(out, static_cast<std::uint32_t>(value.size()));
+  out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+/** Whether the stream starts with that magic string */
+inline bool read_magic(std::istream& in, Magic const& expected)
+{
+  Magic magic;
+  in.read(magic.data(), magic.size());
+  return in.good() && magic == expected;
+}
+template <typename T> T read_value(std::istream& in)
+{
+  T value{};
+  in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+inline std::string read_string(std::istream& in)
+{
+  auto size = read_value<std::uint32_t>(in);
+  if (not in.good())
+    return {};
+  std::string value(size, '\0');
+  in.read(value.data(), static_cast<std::streamsize>(value.size()));
+  return value;
+}
+
+} // namespace simgrid::mc::serialization
+
+#endif
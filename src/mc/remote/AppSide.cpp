@@ -26,9 +26,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <sys/mman.h>
 #include <sys/ptrace.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_client, mc, "MC client logic");
 XBT_LOG_EXTERNAL_CATEGORY(mc_global);
@@ -64,6 +67,16 @@ AppSide* AppSide::initialize()
 
   instance_ = std::make_unique<simgrid::mc::AppSide>(fd);
 
+  // With model-check/transport:shm, the messages go through the shared memory segment initialized by the checker
+  if (const char* shm_env = std::getenv(MC_ENV_SHM_FD)) {
+    int shm_fd   = xbt_str_parse_int(shm_env, "Not a number in variable '" MC_ENV_SHM_FD "'");
+    void* memory = mmap(nullptr, Channel::shared_memory_size(), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    xbt_assert(memory != MAP_FAILED, "Could not map the shared memory segment: %s", strerror(errno));
+    close(shm_fd);
+    instance_->channel_.use_shared_memory(memory, false);
+    XBT_DEBUG("Model-checked application uses the shared memory transport");
+  }
+
   // Wait for the model-checker:
   errno = 0;
 #if defined __linux__
@@ -175,6 +188,57 @@ void AppSide::handle_actors_status() const
   }
 }
 
+/** Take a sequence of transitions, without answering after each of them (used to replay a path of the exploration) */
+void AppSide::handle_replay(const s_mc_message_replay_t* msg) const
+{
+  xbt_assert(msg->count > 0 && static_cast<unsigned>(msg->count) <= MC_REPLAY_BATCH_SIZE,
+             "Invalid number of transitions to replay: %d", msg->count);
+  std::vector<s_mc_message_replay_one_t> transitions(msg->count);
+  size_t size = transitions.size() * sizeof(s_mc_message_replay_one_t);
+  xbt_assert(channel_.receive(transitions.data(), size) == static_cast<ssize_t>(size),
+             "Could not receive the transitions to replay");
+
+  XBT_DEBUG("Replay %d transitions", msg->count);
+  for (auto const& transition : transitions) {
+    kernel::actor::ActorImpl* actor = kernel::EngineImpl::get_instance()->get_actor_by_pid(transition.aid);
+    xbt_assert(actor != nullptr, "Invalid pid %ld", transition.aid);
+    actor->simcall_handle(transition.times_considered);
+    simgrid::mc::execute_actors();
+  }
+  // Tell the checker that the whole sequence is over, as main_loop() would do after the last transition
+  xbt_assert(channel_.send(MessageType::WAITING) == 0, "Could not send WAITING message to model-checker");
+}
+
+/** Fork a copy of the application, which talks to the checker through a new socket (model-check/fork-checkpoint)
+ *
+ *  Both processes go on waiting for messages: the checker decides which one is paused and which one runs.
+ */
+void AppSide::handle_fork() const
+{
+  // Reap the copies that were forked from here and killed since then
+  while (waitpid(-1, nullptr, WNOHANG) > 0)
+    ;
+
+  int sockets[2];
+  xbt_assert(socketpair(AF_LOCAL, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != -1, "Could not create socketpair");
+  pid_t pid = fork();
+  xbt_assert(pid >= 0, "Could not fork the application: %s", strerror(errno));
+
+  if (pid == 0) {
+    // Keep the file descriptor number of the socket, so that the memory of both copies remains the same
+    xbt_assert(dup2(sockets[0], channel_.get_socket()) != -1, "Could not replace the socket: %s", strerror(errno));
+    close(sockets[0]);
+    close(sockets[1]);
+    XBT_DEBUG("Forked copy of the application, pid %d", getpid());
+    return;
+  }
+
+  close(sockets[0]);
+  s_mc_message_int_t answer{MessageType::FORK_REPLY, static_cast<uint64_t>(pid)};
+  xbt_assert(channel_.send_with_fd(&answer, sizeof(answer), sockets[1]) == 0, "Could not answer to FORK");
+  close(sockets[1]);
+}
+
 #define assert_msg_size(_name_, _type_)                                                                                \
   xbt_assert(received_size == sizeof(_type_), "Unexpected size for " _name_ " (%zd != %zu)", received_size,            \
              sizeof(_type_))
@@ -215,6 +279,16 @@ void AppSide::handle_messages() const
         handle_actors_status();
         break;
 
+      case MessageType::REPLAY:
+        assert_msg_size("REPLAY", s_mc_message_replay_t);
+        handle_replay((s_mc_message_replay_t*)message_buffer.data());
+        break;
+
+      case MessageType::FORK:
+        assert_msg_size("FORK", s_mc_message_t);
+        handle_fork();
+        break;
+
       default:
         xbt_die("Received unexpected message %s (%i)", to_c_str(message->type), static_cast<int>(message->type));
         break;
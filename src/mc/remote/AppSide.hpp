@@ -33,6 +33,8 @@ private:
   void handle_simcall_execute(const s_mc_message_simcall_execute_t* message) const;
   void handle_finalize(const s_mc_message_int_t* msg) const;
   void handle_actors_status() const;
+  void handle_replay(const s_mc_message_replay_t* msg) const;
+  void handle_fork() const;
 
 public:
   Channel const& get_channel() const { return channel_; }
@@ -7,26 +7,190 @@
 #include "src/mc/remote/Channel.hpp"
 #include <xbt/log.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <climits>
 #include <cstring>
+#include <new>
+#include <poll.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <thread>
 #include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_Channel, mc, "MC interprocess communication");
 
 namespace simgrid::mc {
 
+/** A single-producer single-consumer ring of messages, in the memory shared by both processes
+ *
+ *  Each message is stored as its size (a 64 bits word) followed by its content, padded to 8 bytes. The positions only
+ *  grow (they are used modulo the capacity). The doorbell is a futex rung at each push, for the consumer waiting for
+ *  a message, and at each pop, for the producer waiting for some room.
+ */
+struct Channel::Ring {
+  static constexpr std::size_t CAPACITY = 1 << 20;
+  static constexpr std::size_t ALIGN    = 8;
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+                "The rings need lock-free atomics to be shared between processes");
+
+  std::atomic<std::uint64_t> head{0}; // Where the next message will be written (only modified by the producer)
+  std::atomic<std::uint64_t> tail{0}; // Where the next message will be read (only modified by the consumer)
+  std::atomic<std::uint32_t> doorbell{0};
+  std::atomic<std::uint32_t> sleepers{0};
+  std::array<char, CAPACITY> data;
+
+  static std::size_t footprint(std::size_t size) { return (sizeof(std::uint64_t) + size + ALIGN - 1) & ~(ALIGN - 1); }
+
+  void copy_in(std::uint64_t pos, const void* src, std::size_t size)
+  {
+    std::size_t offset = pos % CAPACITY;
+    std::size_t first  = std::min(size, CAPACITY - offset);
+    memcpy(data.data() + offset, src, first);
+    memcpy(data.data(), static_cast<const char*>(src) + first, size - first);
+  }
+  void copy_out(std::uint64_t pos, void* dst, std::size_t size) const
+  {
+    std::size_t offset = pos % CAPACITY;
+    std::size_t first  = std::min(size, CAPACITY - offset);
+    memcpy(dst, data.data() + offset, first);
+    memcpy(static_cast<char*>(dst) + first, data.data(), size - first);
+  }
+
+  void ring()
+  {
+    doorbell.fetch_add(1);
+#ifdef __linux__
+    if (sleepers.load() > 0)
+      syscall(SYS_futex, &doorbell, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+  }
+
+  /** Wait until ready() becomes true. Returns false on timeout (in ms, -1 for none) or when the peer is gone. */
+  template <class F> bool wait(F ready, int peer_socket, int timeout)
+  {
+    for (int i = 0; i < 1000; i++) // The answer of the peer often comes quickly
+      if (ready())
+        return true;
+
+    auto start = std::chrono::steady_clock::now();
+    while (not ready()) {
+      std::uint32_t bell = doorbell.load();
+      sleepers.fetch_add(1);
+      if (not ready()) {
+#ifdef __linux__
+        timespec delay = {0, 100 * 1000 * 1000};
+        syscall(SYS_futex, &doorbell, FUTEX_WAIT, bell, &delay, nullptr, 0);
+#else
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+      }
+      sleepers.fetch_sub(1);
+      if (ready())
+        return true;
+
+      // Without any news from the peer, check that it is still there (it keeps its end of the socket open)
+      pollfd peer = {peer_socket, 0, 0};
+      if (poll(&peer, 1, 0) > 0 && (peer.revents & (POLLHUP | POLLERR)))
+        return false;
+      if (timeout >= 0 && std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(timeout))
+        return false;
+    }
+    return true;
+  }
+
+  int push(const void* message, std::size_t size, int peer_socket)
+  {
+    std::size_t needed = footprint(size);
+    xbt_assert(needed <= CAPACITY, "Message of %zu bytes too large for the shared memory ring", size);
+    std::uint64_t pos = head.load(std::memory_order_relaxed);
+    if (not wait([this, pos, needed] { return CAPACITY - (pos - tail.load()) >= needed; }, peer_socket, -1))
+      return EPIPE;
+
+    std::uint64_t header = size;
+    copy_in(pos, &header, sizeof(header));
+    copy_in(pos + sizeof(header), message, size);
+    head.store(pos + needed);
+    ring();
+    return 0;
+  }
+
+  ssize_t pop(void* message, std::size_t size, bool block, int peer_socket)
+  {
+    std::uint64_t pos = tail.load(std::memory_order_relaxed);
+    auto not_empty    = [this, pos] { return head.load() != pos; };
+    if (not not_empty() && (not block || not wait(not_empty, peer_socket, -1))) {
+      errno = block ? ECONNRESET : EAGAIN;
+      return -1;
+    }
+
+    std::uint64_t header;
+    copy_out(pos, &header, sizeof(header));
+    // Like with a SOCK_SEQPACKET socket, the end of a message too large for the buffer is lost
+    std::size_t received = std::min<std::size_t>(header, size);
+    copy_out(pos + sizeof(header), message, received);
+    tail.store(pos + footprint(header));
+    ring();
+    return received;
+  }
+};
+
 Channel::~Channel()
 {
   if (this->socket_ >= 0)
     close(this->socket_);
+  if (this->recv_ring_ != nullptr)
+    munmap(std::min(this->send_ring_, this->recv_ring_), shared_memory_size());
+}
+
+std::size_t Channel::shared_memory_size()
+{
+  return 2 * sizeof(Ring);
+}
+
+void Channel::use_shared_memory(void* memory, bool creator)
+{
+  auto* rings = static_cast<Ring*>(memory);
+  if (creator) {
+    new (&rings[0]) Ring();
+    new (&rings[1]) Ring();
+  }
+  // The model checker sends on the first ring, and the application on the second one
+  send_ring_ = creator ? &rings[0] : &rings[1];
+  recv_ring_ = creator ? &rings[1] : &rings[0];
+}
+
+bool Channel::wait_message(int timeout) const
+{
+  std::uint64_t pos = recv_ring_->tail.load();
+  return recv_ring_->wait([this, pos] { return recv_ring_->head.load() != pos; }, socket_, timeout);
+}
+
+bool Channel::peer_gone() const
+{
+  pollfd peer = {socket_, 0, 0};
+  return poll(&peer, 1, 0) > 0 && (peer.revents & (POLLHUP | POLLERR));
 }
 
 /** @brief Send a message; returns 0 on success or errno on failure */
 int Channel::send(const void* message, size_t size) const
 {
   XBT_DEBUG("Send %s", to_c_str(*(MessageType*)message));
+  if (send_ring_ != nullptr) {
+    int res = send_ring_->push(message, size, socket_);
+    if (res != 0)
+      XBT_ERROR("Channel::send failure: %s", strerror(res));
+    return res;
+  }
   while (::send(this->socket_, message, size, 0) == -1) {
     if (errno != EINTR) {
       XBT_ERROR("Channel::send failure: %s", strerror(errno));
@@ -36,9 +200,65 @@ int Channel::send(const void* message, size_t size) const
   return 0;
 }
 
+int Channel::send_with_fd(const void* message, size_t size, int fd) const
+{
+  XBT_DEBUG("Send %s with file descriptor %d", to_c_str(*(const MessageType*)message), fd);
+  iovec iov = {const_cast<void*>(message), size};
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control;
+  msghdr header         = {};
+  header.msg_iov        = &iov;
+  header.msg_iovlen     = 1;
+  header.msg_control    = control.data();
+  header.msg_controllen = control.size();
+  cmsghdr* cmsg         = CMSG_FIRSTHDR(&header);
+  cmsg->cmsg_level      = SOL_SOCKET;
+  cmsg->cmsg_type       = SCM_RIGHTS;
+  cmsg->cmsg_len        = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+  while (sendmsg(this->socket_, &header, 0) == -1) {
+    if (errno != EINTR) {
+      XBT_ERROR("Channel::send_with_fd failure: %s", strerror(errno));
+      return errno;
+    }
+  }
+  return 0;
+}
+
+ssize_t Channel::receive_with_fd(void* message, size_t size, int* fd) const
+{
+  iovec iov = {message, size};
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control;
+  msghdr header         = {};
+  header.msg_iov        = &iov;
+  header.msg_iovlen     = 1;
+  header.msg_control    = control.data();
+  header.msg_controllen = control.size();
+
+  ssize_t res;
+  do {
+    res = recvmsg(this->socket_, &header, MSG_CMSG_CLOEXEC);
+  } while (res == -1 && errno == EINTR);
+  if (res == -1) {
+    XBT_ERROR("Channel::receive_with_fd failure: %s", strerror(errno));
+    return res;
+  }
+
+  *fd                 = -1;
+  const cmsghdr* cmsg = CMSG_FIRSTHDR(&header);
+  if (cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+    memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+  XBT_DEBUG("Receive %s with file descriptor %d", to_c_str(*(MessageType*)message), *fd);
+  return res;
+}
+
 ssize_t Channel::receive(void* message, size_t size, bool block) const
 {
-  ssize_t res = recv(this->socket_, message, size, block ? 0 : MSG_DONTWAIT);
+  ssize_t res;
+  if (recv_ring_ != nullptr)
+    res = recv_ring_->pop(message, size, block, socket_);
+  else
+    res = recv(this->socket_, message, size, block ? 0 : MSG_DONTWAIT);
   if (res != -1)
     XBT_DEBUG("Receive %s", to_c_str(*(MessageType*)message));
   else
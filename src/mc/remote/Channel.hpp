@@ -14,11 +14,18 @@ namespace simgrid::mc {
 
 /** A channel for exchanging messages between model-checker and model-checked app
  *
- *  This abstracts away the way the messages are transferred. Currently, they
- *  are sent over a (connected) `SOCK_SEQPACKET` socket.
+ *  This abstracts away the way the messages are transferred. By default, they
+ *  are sent over a (connected) `SOCK_SEQPACKET` socket. With
+ *  model-check/transport:shm, they go through two rings in a shared memory
+ *  segment instead (one per direction), and the socket is only used to detect
+ *  the termination of the peer.
  */
 class Channel {
+  struct Ring;
+
   int socket_ = -1;
+  Ring* send_ring_ = nullptr;
+  Ring* recv_ring_ = nullptr;
   template <class M> static constexpr bool messageType() { return std::is_class_v<M> && std::is_trivial_v<M>; }
 
 public:
@@ -29,6 +36,20 @@ public:
   Channel(Channel const&) = delete;
   Channel& operator=(Channel const&) = delete;
 
+  /** Size of the shared memory segment to give to use_shared_memory() */
+  static std::size_t shared_memory_size();
+  /** Exchange the messages through the given shared memory segment from now on
+   *
+   *  @param memory    The shared memory segment (of shared_memory_size() bytes)
+   *  @param creator   Whether we initialize the segment (the model checker does it before starting the application)
+   */
+  void use_shared_memory(void* memory, bool creator);
+  bool uses_shared_memory() const { return recv_ring_ != nullptr; }
+  /** Wait until a message can be received, or until the timeout (in ms) expires */
+  bool wait_message(int timeout) const;
+  /** Whether the peer closed its end of the channel (it died or exited) */
+  bool peer_gone() const;
+
   // Send
   int send(const void* message, size_t size) const;
   int send(MessageType type) const
@@ -42,6 +63,9 @@ public:
     return this->send(&m, sizeof(M));
   }
 
+  /** Send a message along with a file descriptor (always through the socket) */
+  int send_with_fd(const void* message, size_t size, int fd) const;
+
   // Receive
   ssize_t receive(void* message, size_t size, bool block = true) const;
   template <class M> typename std::enable_if_t<messageType<M>(), ssize_t> receive(M& m) const
@@ -49,6 +73,9 @@ public:
     return this->receive(&m, sizeof(M));
   }
 
+  /** Receive a message sent with send_with_fd(), storing the received file descriptor (or -1) in `fd` */
+  ssize_t receive_with_fd(void* message, size_t size, int* fd) const;
+
   int get_socket() const { return socket_; }
 };
 } // namespace simgrid::mc
@@ -4,8 +4,13 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "src/mc/remote/CheckerSide.hpp"
+#include "xbt/asserts.h"
+
+#include <cerrno>
 #include <csignal>
+#include <cstring>
 #include <sys/wait.h>
+#include <unistd.h>
 
 namespace simgrid::mc {
 
@@ -13,10 +18,15 @@ void CheckerSide::start(void (*handler)(int, short, void*), ModelChecker* mc)
 {
   auto* base = event_base_new();
   base_.reset(base);
+  handler_     = handler;
+  handler_arg_ = mc;
 
-  auto* socket_event = event_new(base, get_channel().get_socket(), EV_READ | EV_PERSIST, handler, mc);
-  event_add(socket_event, nullptr);
-  socket_event_.reset(socket_event);
+  // With the shared memory transport, nothing but the termination of the application comes through the socket
+  if (not channel_.uses_shared_memory()) {
+    auto* socket_event = event_new(base, get_channel().get_socket(), EV_READ | EV_PERSIST, handler, mc);
+    event_add(socket_event, nullptr);
+    socket_event_.reset(socket_event);
+  }
 
   auto* signal_event = event_new(base, SIGCHLD, EV_SIGNAL | EV_PERSIST, handler, mc);
   event_add(signal_event, nullptr);
@@ -25,11 +35,37 @@ void CheckerSide::start(void (*handler)(int, short, void*), ModelChecker* mc)
 
 void CheckerSide::dispatch() const
 {
-  event_base_dispatch(base_.get());
+  if (not channel_.uses_shared_memory()) {
+    event_base_dispatch(base_.get());
+    return;
+  }
+
+  break_requested_ = false;
+  while (not break_requested_) {
+    if (channel_.wait_message(100))
+      handler_(channel_.get_socket(), EV_READ, handler_arg_);
+    else {
+      event_base_loop(base_.get(), EVLOOP_NONBLOCK); // Handle the pending SIGCHLD, if any
+      if (channel_.peer_gone())
+        break;
+    }
+  }
+}
+
+void CheckerSide::replace_socket(int socket)
+{
+  // Keep the file descriptor number of the channel, and register the event again on the new socket
+  if (socket_event_)
+    event_del(socket_event_.get());
+  xbt_assert(dup2(socket, channel_.get_socket()) != -1, "Could not replace the socket: %s", strerror(errno));
+  close(socket);
+  if (socket_event_)
+    event_add(socket_event_.get(), nullptr);
 }
 
 void CheckerSide::break_loop() const
 {
+  break_requested_ = true;
   event_base_loopbreak(base_.get());
 }
 
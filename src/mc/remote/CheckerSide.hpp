@@ -21,6 +21,10 @@ class CheckerSide {
   std::unique_ptr<event, decltype(&event_free)> signal_event_{nullptr, &event_free};
 
   Channel channel_;
+  // With the shared memory transport, dispatch() polls the rings itself and calls the handler on each message
+  void (*handler_)(int, short, void*) = nullptr;
+  ModelChecker* handler_arg_          = nullptr;
+  mutable bool break_requested_       = false;
 
 public:
   explicit CheckerSide(int sockfd) : channel_(sockfd) {}
@@ -36,6 +40,8 @@ public:
   void start(void (*handler)(int, short, void*), ModelChecker* mc);
   void dispatch() const;
   void break_loop() const;
+  /** Talk to the application through another socket, which is closed after being duplicated */
+  void replace_socket(int socket);
 };
 
 } // namespace simgrid::mc
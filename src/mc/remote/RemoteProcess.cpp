@@ -7,6 +7,7 @@
 
 #include "src/mc/remote/RemoteProcess.hpp"
 
+#include "src/mc/mc_config.hpp"
 #include "src/mc/sosp/Snapshot.hpp"
 #include "xbt/file.hpp"
 #include "xbt/log.h"
@@ -14,6 +15,8 @@
 #include <fcntl.h>
 #include <libunwind-ptrace.h>
 #include <sys/mman.h> // PROT_*
+#include <sys/uio.h>  // process_vm_readv
+#include <unistd.h>
 
 #include <algorithm>
 #include <cerrno>
@@ -113,19 +116,68 @@ void RemoteProcess::init(xbt_mheap_t mmalloc_default_mdp, unsigned long* maxpid)
   this->memory_map_ = simgrid::xbt::get_memory_map(this->pid_);
   this->init_memory_map_info();
 
-  int fd = open_vm(this->pid_, O_RDWR);
-  xbt_assert(fd >= 0, "Could not open file for process virtual address space");
-  this->memory_file = fd;
+  this->open_files();
 
   this->unw_addr_space            = simgrid::mc::UnwindContext::createUnwindAddressSpace();
   this->unw_underlying_addr_space = simgrid::unw::create_addr_space();
   this->unw_underlying_context    = simgrid::unw::create_context(this->unw_underlying_addr_space, this->pid_);
 }
 
-RemoteProcess::~RemoteProcess()
+/** Open the files of /proc giving access to the memory of the process */
+void RemoteProcess::open_files()
+{
+  int fd = open_vm(this->pid_, O_RDWR);
+  xbt_assert(fd >= 0, "Could not open file for process virtual address space");
+  this->memory_file = fd;
+
+  if (_sg_mc_soft_dirty) {
+    std::string proc_dir = "/proc/" + std::to_string(this->pid_);
+    this->clear_refs_file_ = open((proc_dir + "/clear_refs").c_str(), O_WRONLY);
+    this->pagemap_file_    = open((proc_dir + "/pagemap").c_str(), O_RDONLY);
+    if (this->clear_refs_file_ < 0 || this->pagemap_file_ < 0) {
+      XBT_WARN("Cannot track the soft-dirty pages of the application (%s). Full snapshots will be taken.",
+               strerror(errno));
+      if (this->clear_refs_file_ >= 0)
+        close(this->clear_refs_file_);
+      if (this->pagemap_file_ >= 0)
+        close(this->pagemap_file_);
+      this->clear_refs_file_ = -1;
+      this->pagemap_file_    = -1;
+    }
+  }
+}
+
+void RemoteProcess::close_files()
 {
   if (this->memory_file >= 0)
     close(this->memory_file);
+  if (this->clear_refs_file_ >= 0)
+    close(this->clear_refs_file_);
+  if (this->pagemap_file_ >= 0)
+    close(this->pagemap_file_);
+  this->memory_file      = -1;
+  this->clear_refs_file_ = -1;
+  this->pagemap_file_    = -1;
+}
+
+void RemoteProcess::reattach(pid_t pid)
+{
+  XBT_DEBUG("Follow the application %d instead of %d", pid, this->pid_);
+  this->close_files();
+  this->pid_ = pid;
+  this->open_files();
+
+  if (this->unw_underlying_addr_space != unw_local_addr_space) {
+    if (this->unw_underlying_context)
+      _UPT_destroy(this->unw_underlying_context);
+    this->unw_underlying_context = simgrid::unw::create_context(this->unw_underlying_addr_space, this->pid_);
+  }
+  this->clear_cache();
+}
+
+RemoteProcess::~RemoteProcess()
+{
+  this->close_files();
 
   if (this->unw_underlying_addr_space != unw_local_addr_space) {
     if (this->unw_underlying_addr_space)
@@ -332,6 +384,39 @@ void* RemoteProcess::read_bytes(void* buffer, std::size_t size, RemotePtr<void>
   return buffer;
 }
 
+/** Read whole pages from the process memory, with as few system calls as possible
+ *
+ *  Each call to process_vm_readv() is given a scatter list of up to IOV_MAX remote pages. Partial transfers never
+ *  split an iovec element, so they always stop at a page boundary: the read goes on from there. When process_vm_readv()
+ *  is not usable (restricted by the kernel, or unreadable page), the remaining pages are read with pread.
+ */
+void RemoteProcess::read_pages(void* buffer, std::size_t page_count, RemotePtr<void> address) const
+{
+  static const auto max_iov = static_cast<std::size_t>(std::max(sysconf(_SC_IOV_MAX), 1L));
+  auto* target = static_cast<char*>(buffer);
+  std::vector<iovec> remote_iov;
+
+  std::size_t done = 0;
+  while (done < page_count) {
+    std::size_t count = std::min(page_count - done, max_iov);
+    remote_iov.resize(count);
+    for (std::size_t i = 0; i != count; ++i) {
+      remote_iov[i].iov_base = (void*)mmu::join(done + i, address.address());
+      remote_iov[i].iov_len  = xbt_pagesize;
+    }
+    iovec local_iov = {target + (done << xbt_pagebits), count << xbt_pagebits};
+
+    ssize_t res = process_vm_readv(this->pid_, &local_iov, 1, remote_iov.data(), count, 0);
+    if (res == -1 && errno == EINTR)
+      continue;
+    if (res <= 0) {
+      read_bytes(local_iov.iov_base, (page_count - done) << xbt_pagebits, remote(remote_iov[0].iov_base));
+      return;
+    }
+    done += static_cast<std::size_t>(res) >> xbt_pagebits;
+  }
+}
+
 /** Write data to a process memory
  *
  *  @param buffer   local memory address (source)
@@ -344,6 +429,38 @@ void RemoteProcess::write_bytes(const void* buffer, size_t len, RemotePtr<void>
              "Write to process %lli failed", (long long)this->pid_);
 }
 
+/** Reset the soft-dirty bits of all the pages of the process
+ *
+ *  From now on, the kernel marks again as soft-dirty each page written by the process (or through write_bytes()).
+ */
+void RemoteProcess::clear_soft_dirty() const
+{
+  xbt_assert(pwrite(this->clear_refs_file_, "4", 1, 0) == 1, "Could not clear the soft-dirty bits of process %lli",
+             (long long)this->pid_);
+}
+
+/** Which pages may have been modified since the last call to clear_soft_dirty()
+ *
+ *  The pages that are not in memory (nor in the swap) are reported as dirty: they may have been dropped (and
+ *  zeroed) by the application.
+ */
+std::vector<bool> RemoteProcess::get_dirty_pages(RemotePtr<void> address, std::size_t page_count) const
+{
+  static constexpr std::uint64_t PAGE_SOFT_DIRTY = 1ULL << 55;
+  static constexpr std::uint64_t PAGE_SWAPPED    = 1ULL << 62;
+  static constexpr std::uint64_t PAGE_PRESENT    = 1ULL << 63;
+
+  std::vector<std::uint64_t> pagemap(page_count);
+  xbt_assert(pread_whole(this->pagemap_file_, pagemap.data(), page_count * sizeof(std::uint64_t),
+                         (address.address() >> xbt_pagebits) * sizeof(std::uint64_t)) != -1,
+             "Could not read the page map of process %lli", (long long)this->pid_);
+
+  std::vector<bool> dirty(page_count);
+  for (std::size_t i = 0; i != page_count; ++i)
+    dirty[i] = (pagemap[i] & PAGE_SOFT_DIRTY) || not(pagemap[i] & (PAGE_PRESENT | PAGE_SWAPPED));
+  return dirty;
+}
+
 static void zero_buffer_init(const void** zero_buffer, size_t zero_buffer_size)
 {
   int fd = open("/dev/zero", O_RDONLY);
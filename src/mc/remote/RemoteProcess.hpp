@@ -72,6 +72,8 @@ public:
   explicit RemoteProcess(pid_t pid);
   ~RemoteProcess() override;
   void init(xbt_mheap_t mmalloc_default_mdp, unsigned long* maxpid);
+  /** Follow another process with the same memory layout, forked from this one (model-check/fork-checkpoint) */
+  void reattach(pid_t pid);
 
   RemoteProcess(RemoteProcess const&) = delete;
   RemoteProcess(RemoteProcess&&)      = delete;
@@ -85,6 +87,7 @@ public:
   // Read memory:
   void* read_bytes(void* buffer, std::size_t size, RemotePtr<void> address,
                    ReadOptions options = ReadOptions::none()) const override;
+  void read_pages(void* buffer, std::size_t page_count, RemotePtr<void> address) const override;
 
   void read_variable(const char* name, void* target, size_t size) const;
   template <class T> void read_variable(const char* name, T* target) const
@@ -105,6 +108,11 @@ public:
   void write_bytes(const void* buffer, size_t len, RemotePtr<void> address) const;
   void clear_bytes(RemotePtr<void> address, size_t len) const;
 
+  // Soft-dirty tracking of the memory pages (model-check/soft-dirty):
+  bool tracks_soft_dirty() const { return clear_refs_file_ >= 0; }
+  void clear_soft_dirty() const;
+  std::vector<bool> get_dirty_pages(RemotePtr<void> address, std::size_t page_count) const;
+
   // Debug information:
   std::shared_ptr<ObjectInformation> find_object_info(RemotePtr<void> addr) const;
   std::shared_ptr<ObjectInformation> find_object_info_exec(RemotePtr<void> addr) const;
@@ -173,6 +181,8 @@ public:
 
 private:
   void init_memory_map_info();
+  void open_files();
+  void close_files();
   void refresh_heap();
   void refresh_malloc_info();
 
@@ -182,6 +192,8 @@ private:
   RemotePtr<void> maestro_stack_start_;
   RemotePtr<void> maestro_stack_end_;
   int memory_file = -1;
+  int clear_refs_file_ = -1;
+  int pagemap_file_    = -1;
   std::vector<IgnoredRegion> ignored_regions_;
   std::vector<s_stack_region_t> stack_areas_;
   std::vector<IgnoredHeapRegion> ignored_heap_;
@@ -26,11 +26,12 @@ namespace simgrid::mc {
 XBT_DECLARE_ENUM_CLASS(MessageType, NONE, INITIAL_ADDRESSES, CONTINUE, IGNORE_HEAP, UNIGNORE_HEAP, IGNORE_MEMORY,
                        STACK_REGION, REGISTER_SYMBOL, DEADLOCK_CHECK, DEADLOCK_CHECK_REPLY, WAITING, SIMCALL_EXECUTE,
                        SIMCALL_EXECUTE_ANSWER, ASSERTION_FAILED, ACTORS_STATUS, ACTORS_STATUS_REPLY, FINALIZE,
-                       FINALIZE_REPLY);
+                       FINALIZE_REPLY, REPLAY, FORK, FORK_REPLY);
 } // namespace simgrid::mc
 
 constexpr unsigned MC_MESSAGE_LENGTH = 512;
 constexpr unsigned SIMCALL_SERIALIZATION_BUFFER_SIZE = 2048;
+constexpr unsigned MC_REPLAY_BATCH_SIZE               = 1024;
 
 /** Basic structure for a MC message
  *
@@ -96,6 +97,16 @@ struct s_mc_message_simcall_execute_answer_t {
   std::array<char, SIMCALL_SERIALIZATION_BUFFER_SIZE> buffer;
 };
 
+struct s_mc_message_replay_t {
+  simgrid::mc::MessageType type;
+  int count;
+};
+struct s_mc_message_replay_one_t { // an array of `s_mc_message_replay_one_t[count]` is sent right after a
+                                   // s_mc_message_replay_t, with at most MC_REPLAY_BATCH_SIZE elements
+  aid_t aid;
+  int times_considered;
+};
+
 struct s_mc_message_restore_t {
   simgrid::mc::MessageType type;
   int index;
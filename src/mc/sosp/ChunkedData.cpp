@@ -6,35 +6,47 @@
 #include "src/mc/AddressSpace.hpp"
 #include "src/mc/sosp/ChunkedData.hpp"
 
+#include <algorithm>
+
 namespace simgrid::mc {
 
+/** Number of pages read (and stored) at once when taking a snapshot */
+static constexpr std::size_t BATCH_PAGES = 256;
+
 /** Take a per-page snapshot of a region
+ *
+ *  The dirty pages of the region are read by spans of at most BATCH_PAGES pages, which are then stored together in
+ *  the page store.
  *
  *  @param addr            The start of the region (must be at the beginning of a page)
  *  @param page_count      Number of pages of the region
+ *  @param clean           If not null, the page number in the store of each page that did not change since it was
+ *                         stored (or DIRTY_PAGE if it must be read again)
  *  @return                Snapshot page numbers of this new snapshot
  */
-ChunkedData::ChunkedData(PageStore& store, const AddressSpace& as, RemotePtr<void> addr, std::size_t page_count)
+ChunkedData::ChunkedData(PageStore& store, const AddressSpace& as, RemotePtr<void> addr, std::size_t page_count,
+                         const std::size_t* clean)
     : store_(&store)
 {
+  xbt_assert(simgrid::mc::mmu::split(addr.address()).second == 0, "Not at the beginning of a page");
   this->pagenos_.resize(page_count);
-  std::vector<char> buffer(xbt_pagesize);
-
-  for (size_t i = 0; i != page_count; ++i) {
-    RemotePtr<void> page = remote((void*)simgrid::mc::mmu::join(i, addr.address()));
-    xbt_assert(simgrid::mc::mmu::split(page.address()).second == 0, "Not at the beginning of a page");
-
-    /* Adding another copy (and a syscall) will probably slow things a lot.
-       TODO, optimize this somehow (at least by grouping the syscalls)
-       if needed. Either:
-       - reduce the number of syscalls
-       - let the application snapshot itself
-       - move the segments in shared memory (this will break `fork` however)
-    */
-
-    as.read_bytes(buffer.data(), xbt_pagesize, page);
-
-    pagenos_[i] = store_->store_page(buffer.data());
+  std::vector<char> buffer(std::min(page_count, BATCH_PAGES) << xbt_pagebits);
+
+  size_t i = 0;
+  while (i < page_count) {
+    if (clean != nullptr && clean[i] != DIRTY_PAGE) {
+      store_->ref_page(clean[i]);
+      pagenos_[i] = clean[i];
+      i++;
+      continue;
+    }
+    size_t count = 1;
+    while (i + count < page_count && count < BATCH_PAGES && (clean == nullptr || clean[i + count] == DIRTY_PAGE))
+      count++;
+    RemotePtr<void> span = remote((void*)simgrid::mc::mmu::join(i, addr.address()));
+    as.read_pages(buffer.data(), count, span);
+    store_->store_pages(buffer.data(), count, &pagenos_[i]);
+    i += count;
   }
 }
 
@@ -6,6 +6,7 @@
 #ifndef SIMGRID_MC_CHUNKED_DATA_HPP
 #define SIMGRID_MC_CHUNKED_DATA_HPP
 
+#include <limits>
 #include <vector>
 
 #include "src/mc/mc_forward.hpp"
@@ -85,7 +86,11 @@ public:
   /** Get a pointer to a chunk */
   void* page(std::size_t i) const { return store_->get_page(pagenos_[i]); }
 
-  ChunkedData(PageStore& store, const AddressSpace& as, RemotePtr<void> addr, std::size_t page_count);
+  /** Value of the `clean` pages that must be read from the address space (see the constructor) */
+  static constexpr std::size_t DIRTY_PAGE = std::numeric_limits<std::size_t>::max();
+
+  ChunkedData(PageStore& store, const AddressSpace& as, RemotePtr<void> addr, std::size_t page_count,
+              const std::size_t* clean = nullptr);
 };
 
 } // namespace simgrid::mc
@@ -16,8 +16,14 @@
 #include "src/mc/mc_mmu.hpp"
 #include "src/mc/sosp/PageStore.hpp"
 
+#include <cerrno>
+#include <cstdlib>
 #include <cstring> // memcpy, memcmp
+#include <string>
 #include <unistd.h>
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 namespace simgrid::mc {
 
@@ -46,11 +52,16 @@ PageStore::PageStore(std::size_t size) : capacity_(size)
   this->top_index_ = 0;
   this->memory_    = memory;
   this->page_counts_.resize(size);
+  this->page_hashes_.resize(size);
+  this->page_states_.resize(size);
+  this->hash_index_.resize(64, IndexEntry{0, NO_PAGE});
 }
 
 PageStore::~PageStore()
 {
   ::munmap(this->memory_, this->capacity_ << xbt_pagebits);
+  if (this->spill_file_ >= 0)
+    ::close(this->spill_file_);
 }
 
 void PageStore::resize(std::size_t size)
@@ -91,6 +102,8 @@ void PageStore::resize(std::size_t size)
   this->capacity_ = size;
   this->memory_   = new_memory;
   this->page_counts_.resize(size, 0);
+  this->page_hashes_.resize(size, 0);
+  this->page_states_.resize(size);
 }
 
 /** Allocate a free page
@@ -118,25 +131,214 @@ std::size_t PageStore::alloc_page()
 void PageStore::remove_page(std::size_t pageno)
 {
   this->free_pages_.push_back(pageno);
-  const void* page = this->get_page(pageno);
-  hash_type hash   = mc_hash_page(page);
-  this->hash_index_[hash].erase(pageno);
+  this->index_erase(page_hashes_[pageno], pageno);
+  if (page_states_[pageno].tier == Tier::hot)
+    hot_pages_--;
+  else
+    drop_evicted(pageno);
+}
+
+// ***** Hash index
+
+void PageStore::index_insert(hash_type hash, std::size_t pageno)
+{
+  if (2 * (index_entries_ + 1) > hash_index_.size()) { // Keep the load factor below 1/2
+    std::vector<IndexEntry> old_index(2 * hash_index_.size(), IndexEntry{0, NO_PAGE});
+    old_index.swap(hash_index_);
+    index_entries_ = 0;
+    for (IndexEntry const& entry : old_index)
+      if (entry.pageno != NO_PAGE)
+        index_insert(entry.hash, entry.pageno);
+  }
+
+  std::size_t mask = hash_index_.size() - 1;
+  std::size_t i    = hash & mask;
+  while (hash_index_[i].pageno != NO_PAGE)
+    i = (i + 1) & mask;
+  hash_index_[i] = {hash, pageno};
+  index_entries_++;
+}
+
+void PageStore::index_erase(hash_type hash, std::size_t pageno)
+{
+  std::size_t mask = hash_index_.size() - 1;
+  std::size_t i    = hash & mask;
+  while (hash_index_[i].pageno != pageno) {
+    xbt_assert(hash_index_[i].pageno != NO_PAGE, "Page %zu is not in the hash index", pageno);
+    i = (i + 1) & mask;
+  }
+
+  // Backward shift deletion: move back the next entries of the cluster that would not be found anymore
+  for (std::size_t j = (i + 1) & mask; hash_index_[j].pageno != NO_PAGE; j = (j + 1) & mask) {
+    std::size_t home = hash_index_[j].hash & mask;
+    bool movable     = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+    if (movable) {
+      hash_index_[i] = hash_index_[j];
+      i              = j;
+    }
+  }
+  hash_index_[i].pageno = NO_PAGE;
+  index_entries_--;
+}
+
+// ***** Memory budget
+
+/** Evict the pages not used recently (clock algorithm) until the memory used is below 3/4 of the budget */
+void PageStore::enforce_budget()
+{
+  if (budget_ == 0 || resident_bytes() <= budget_)
+    return;
+  std::size_t target = budget_ - budget_ / 4;
+
+  for (std::size_t scanned = 0; resident_bytes() > target && hot_pages_ > 0 && scanned < 2 * top_index_; scanned++) {
+    clock_hand_      = clock_hand_ + 1 < top_index_ ? clock_hand_ + 1 : 0;
+    PageState& state = page_states_[clock_hand_];
+    if (page_counts_[clock_hand_] == 0 || state.tier != Tier::hot)
+      continue;
+    if (state.referenced)
+      state.referenced = false;
+    else
+      evict_page(clock_hand_);
+  }
+
+  // Even the compressed pages take too much memory: spill them too
+  for (std::size_t pageno = 0; resident_bytes() > target && compressed_bytes_ > 0 && pageno < top_index_; pageno++) {
+    PageState& state = page_states_[pageno];
+    if (page_counts_[pageno] != 0 && state.tier == Tier::compressed) {
+      std::unique_ptr<unsigned char[]> data = std::move(state.data);
+      compressed_bytes_ -= state.size;
+      spill_page(pageno, data.get(), state.size);
+    }
+  }
+}
+
+void PageStore::evict_page(std::size_t pageno)
+{
+  auto* page       = (void*)simgrid::mc::mmu::join(pageno, (std::uintptr_t)this->memory_);
+  PageState& state = page_states_[pageno];
+#if HAVE_ZLIB
+  uLongf size = compressBound(xbt_pagesize);
+  buffer_.resize(size);
+  if (compress2(buffer_.data(), &size, static_cast<const Bytef*>(page), xbt_pagesize, 1) == Z_OK &&
+      size <= xbt_pagesize / 2) {
+    state.data = std::make_unique<unsigned char[]>(size);
+    memcpy(state.data.get(), buffer_.data(), size);
+    state.size = static_cast<std::uint32_t>(size);
+    state.tier = Tier::compressed;
+    compressed_bytes_ += size;
+    stats_.compressed_pages++;
+    stats_.compressed_bytes += size;
+  } else
+#endif
+    spill_page(pageno, page, xbt_pagesize);
+
+  // Give the memory back to the system: the slot is filled with zeros on the next access
+  ::madvise(page, xbt_pagesize, MADV_DONTNEED);
+  hot_pages_--;
+}
+
+void PageStore::spill_page(std::size_t pageno, const void* content, std::size_t size)
+{
+  if (spill_file_ < 0) {
+    const char* tmpdir = std::getenv("TMPDIR");
+    std::string path   = std::string(tmpdir != nullptr ? tmpdir : "/tmp") + "/simgrid-mc-pages-XXXXXX";
+    spill_file_        = ::mkstemp(path.data());
+    xbt_assert(spill_file_ >= 0, "Could not create the file to spill the snapshot pages: %s", strerror(errno));
+    ::unlink(path.c_str());
+  }
+
+  PageState& state = page_states_[pageno];
+  if (free_spill_slots_.empty())
+    state.slot = spill_top_++;
+  else {
+    state.slot = free_spill_slots_.back();
+    free_spill_slots_.pop_back();
+  }
+  xbt_assert(::pwrite(spill_file_, content, size, state.slot << xbt_pagebits) == static_cast<ssize_t>(size),
+             "Could not spill a snapshot page: %s", strerror(errno));
+  state.size = static_cast<std::uint32_t>(size);
+  state.tier = Tier::spilled;
+  stats_.spilled_pages++;
+}
+
+/** Load an evicted page back in its slot of `memory_` */
+void PageStore::load_page(std::size_t pageno) const
+{
+  PageState& state                = page_states_[pageno];
+  auto* page                      = (void*)simgrid::mc::mmu::join(pageno, (std::uintptr_t)this->memory_);
+  const unsigned char* compressed = state.data.get();
+  if (state.tier == Tier::spilled) {
+    void* target = page;
+    if (state.size != xbt_pagesize) { // Compressed page spilled afterwards
+      buffer_.resize(state.size);
+      compressed = buffer_.data();
+      target     = buffer_.data();
+    }
+    xbt_assert(::pread(spill_file_, target, state.size, state.slot << xbt_pagebits) == (ssize_t)state.size,
+               "Could not read a spilled snapshot page: %s", strerror(errno));
+  }
+  if (compressed != nullptr) {
+#if HAVE_ZLIB
+    uLongf size = xbt_pagesize;
+    xbt_assert(uncompress(static_cast<Bytef*>(page), &size, compressed, state.size) == Z_OK && size == xbt_pagesize,
+               "Could not uncompress a snapshot page");
+#else
+    xbt_die("Compressed snapshot page, but zlib is not available");
+#endif
+  }
+
+  drop_evicted(pageno);
+  hot_pages_++;
+  stats_.loaded_pages++;
+  if (budget_ != 0 && resident_bytes() > budget_ + stats_.overshoot_bytes)
+    stats_.overshoot_bytes = resident_bytes() - budget_;
+}
+
+/** Forget the evicted content of a page */
+void PageStore::drop_evicted(std::size_t pageno) const
+{
+  PageState& state = page_states_[pageno];
+  if (state.tier == Tier::compressed) {
+    compressed_bytes_ -= state.size;
+    state.data.reset();
+  } else if (state.tier == Tier::spilled)
+    free_spill_slots_.push_back(state.slot);
+  state.tier = Tier::hot;
 }
 
 /** Store a page in memory */
 std::size_t PageStore::store_page(const void* page)
+{
+  enforce_budget();
+  return store_page(page, mc_hash_page(page));
+}
+
+/** Store contiguous pages in memory, hashing them all before touching the hash index */
+void PageStore::store_pages(const void* pages, std::size_t count, std::size_t* pagenos)
+{
+  const auto* page = static_cast<const char*>(pages);
+  std::vector<hash_type> hashes(count);
+  for (std::size_t i = 0; i != count; ++i)
+    hashes[i] = mc_hash_page(page + (i << xbt_pagebits));
+  enforce_budget();
+  for (std::size_t i = 0; i != count; ++i)
+    pagenos[i] = store_page(page + (i << xbt_pagebits), hashes[i]);
+}
+
+std::size_t PageStore::store_page(const void* page, hash_type hash)
 {
   xbt_assert(top_index_ <= this->capacity_, "top_index is not consistent");
 
   // First, we check if a page with the same content is already in the page store:
-  //  1. compute the hash of the page
-  //  2. find pages with the same hash using `hash_index_`
-  //  3. find a page with the same content
-  hash_type hash = mc_hash_page(page);
-
-  // Try to find a duplicate in set of pages with the same hash:
-  page_set_type& page_set = this->hash_index_[hash];
-  for (size_t const& pageno : page_set) {
+  //  1. find pages with the same hash (computed by the caller) using `hash_index_`
+  //  2. find a page with the same content
+  // Try to find a duplicate in the pages with the same hash:
+  stats_.stored_pages++;
+  std::size_t mask = hash_index_.size() - 1;
+  for (std::size_t i = hash & mask; hash_index_[i].pageno != NO_PAGE; i = (i + 1) & mask) {
+    if (hash_index_[i].hash != hash)
+      continue;
+    std::size_t pageno        = hash_index_[i].pageno;
     const void* snapshot_page = this->get_page(pageno);
     if (memcmp(page, snapshot_page, xbt_pagesize) == 0) {
       // If a page with the same content is already in the page store it's reused and its refcount is incremented.
@@ -150,8 +352,11 @@ std::size_t PageStore::store_page(const void* page)
   xbt_assert(this->page_counts_[pageno] == 0, "Allocated page is already used");
   void* snapshot_page = this->get_page(pageno);
   memcpy(snapshot_page, page, xbt_pagesize);
-  page_set.insert(pageno);
+  index_insert(hash, pageno);
+  page_hashes_[pageno] = hash;
   page_counts_[pageno]++;
+  hot_pages_++;
+  stats_.new_pages++;
   return pageno;
 }
 
@@ -9,8 +9,8 @@
 #include "src/mc/mc_forward.hpp"
 #include "src/mc/mc_mmu.hpp"
 
-#include <unordered_map>
-#include <unordered_set>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #ifndef XBT_ALWAYS_INLINE
@@ -64,23 +64,57 @@ namespace simgrid::mc {
  *
  *  * When we are adding a page, we need to check if a page with the same
  *    content is already in the page store in order to reuse it. For this
- *    reason, we maintain an index (`hash_index_`) mapping the hash of a
- *    page to the list of page indices with this hash.
+ *    reason, we maintain an index (`hash_index_`) from the hash of a page
+ *    to its page index. This is an open-addressing table with linear
+ *    probing, so that a lookup usually touches a single cache line.
  *    We use a fast (non cryptographic) hash so there may be conflicts:
- *    we must be able to store multiple indices for the same hash.
+ *    the table may hold several entries with the same hash.
+ *    The hash of each page is kept (`page_hashes_`), so that snapshots
+ *    can be fingerprinted without reading their pages again.
+ *
+ *  * With a memory budget (`set_budget()`), the pages that were not used
+ *    recently are evicted from `memory_` when the budget is exceeded: they
+ *    are compressed in memory when this halves their size (if zlib is
+ *    available), or spilled to an unlinked temporary file otherwise.
+ *    Their slot in `memory_` is given back to the system, and they are
+ *    loaded back in it on the next `get_page()`. Pages are only evicted
+ *    while storing new pages or in `trim()`, so that the pointers given by
+ *    `get_page()` remain valid until then. The pages loaded back in between
+ *    may exceed the budget: the overshoot is recorded in the statistics.
  *
  */
 class PageStore {
 public: // Types
   using hash_type = std::uint64_t;
 
+  /** Activity of the store since its creation */
+  struct Stats {
+    std::size_t stored_pages     = 0; // Pages given to store_page() or store_pages()
+    std::size_t new_pages        = 0; // Stored pages that were not already in the store
+    std::size_t compressed_pages = 0; // Evicted pages kept compressed in memory
+    std::size_t compressed_bytes = 0; // Size of these pages once compressed
+    std::size_t spilled_pages    = 0; // Evicted pages written to the spill file
+    std::size_t loaded_pages     = 0; // Evicted pages loaded back in memory
+    std::size_t overshoot_bytes  = 0; // Largest excess over the budget, reached when loading pages back
+  };
+
 private:
   // Types
-  // We are using a cheap hash to index a page.
-  // We should expect collision and we need to associate multiple page indices
-  // to the same hash.
-  using page_set_type  = std::unordered_set<std::size_t>;
-  using pages_map_type = std::unordered_map<hash_type, page_set_type>;
+  enum class Tier : unsigned char { hot, compressed, spilled };
+  /** Where a page lives, when it is not in `memory_` */
+  struct PageState {
+    Tier tier          = Tier::hot;
+    bool referenced    = false; // Used since the last pass of the eviction clock
+    std::uint32_t size = 0;     // Size of the evicted content (smaller than a page when compressed)
+    std::size_t slot   = 0;     // Slot in the spill file
+    std::unique_ptr<unsigned char[]> data; // Compressed content
+  };
+  /** Entry of the hash index (open addressing with linear probing) */
+  struct IndexEntry {
+    hash_type hash;
+    std::size_t pageno; // NO_PAGE for an empty entry
+  };
+  static constexpr std::size_t NO_PAGE = SIZE_MAX;
 
   // Fields:
   /** First page */
@@ -91,15 +125,41 @@ private:
   std::size_t top_index_;
   /** Page reference count */
   std::vector<std::uint64_t> page_counts_;
+  /** Hash of each used page */
+  std::vector<hash_type> page_hashes_;
   /** Index of available pages before the top */
   std::vector<std::size_t> free_pages_;
-  /** Index from page hash to page index */
-  pages_map_type hash_index_;
+  /** Index from page hash to page index (the size is a power of two) */
+  std::vector<IndexEntry> hash_index_;
+  std::size_t index_entries_ = 0;
+
+  /** Maximal amount of bytes used by the hot and compressed pages (0 for no limit) */
+  std::size_t budget_ = 0;
+  mutable std::vector<PageState> page_states_;
+  mutable std::size_t hot_pages_        = 0; // Used pages in `memory_`
+  mutable std::size_t compressed_bytes_ = 0; // Memory used by the compressed pages
+  std::size_t clock_hand_               = 0;
+  int spill_file_                       = -1;
+  std::size_t spill_top_                = 0;
+  mutable std::vector<std::size_t> free_spill_slots_;
+  mutable std::vector<unsigned char> buffer_; // To (de)compress the pages
+  mutable Stats stats_;
 
   // Methods
   void resize(std::size_t size);
   std::size_t alloc_page();
   void remove_page(std::size_t pageno);
+  std::size_t store_page(const void* page, hash_type hash);
+
+  void index_insert(hash_type hash, std::size_t pageno);
+  void index_erase(hash_type hash, std::size_t pageno);
+
+  std::size_t resident_bytes() const { return (hot_pages_ << xbt_pagebits) + compressed_bytes_; }
+  void enforce_budget();
+  void evict_page(std::size_t pageno);
+  void spill_page(std::size_t pageno, const void* content, std::size_t size);
+  void load_page(std::size_t pageno) const;
+  void drop_evicted(std::size_t pageno) const;
 
 public:
   // Constructors
@@ -110,6 +170,20 @@ public:
 
   // Methods
 
+  /** @brief Limit the memory used by the pages (in bytes, 0 for no limit)
+   *
+   *  Beyond that, the pages that were not used recently are compressed or spilled to a file.
+   */
+  void set_budget(std::size_t bytes) { budget_ = bytes; }
+  std::size_t get_budget() const { return budget_; }
+
+  /** @brief Evict pages until the memory used is back under the budget
+   *
+   *  This invalidates the pointers given by `get_page()`. Call it once these pages are not used anymore, e.g. after
+   *  comparing snapshots, which may load many pages back without storing any.
+   */
+  void trim() { enforce_budget(); }
+
   /** @brief Decrement the reference count for a given page
    *
    * Decrement the reference count of this page. Used when a snapshot is destroyed.
@@ -135,10 +209,25 @@ public:
   /** @brief Store a page in the page store */
   std::size_t store_page(const void* page);
 
+  /** @brief Store several contiguous pages in the page store
+   *
+   *  All the pages are hashed in a first pass, before being looked up in (and added to) the store.
+   *
+   *  @param pages   Start of the first page
+   *  @param count   Number of pages to store
+   *  @param pagenos Where to write the page number of each stored page (must hold `count` entries)
+   */
+  void store_pages(const void* pages, std::size_t count, std::size_t* pagenos);
+
   /** @brief Get a page from its page number
+   *
+   *  An evicted page is loaded back in memory first, even if this exceeds the budget (see `trim()`).
+   *
+   *  This is not thread-safe, even if it is const: loading a page changes the state of the eviction and the
+   *  statistics. Only call it from the thread owning the store.
    *
    *  @param pageno Number of the memory page in the store
-   *  @return Start of the page
+   *  @return Start of the page (valid until the next store of pages or `trim()`)
    */
   void* get_page(std::size_t pageno) const;
 
@@ -147,6 +236,9 @@ public:
   /** @brief Get the number of references for a page */
   std::size_t get_ref(std::size_t pageno) const;
 
+  /** @brief Get the hash of the content of a page (computed when it was stored) */
+  hash_type get_hash(std::size_t pageno) const { return page_hashes_[pageno]; }
+
   /** @brief Get the number of used pages */
   std::size_t size() const;
 
@@ -155,6 +247,10 @@ public:
    *  The capacity is expanded by a system call (mremap).
    * */
   std::size_t capacity() const;
+
+  const Stats& get_stats() const { return stats_; }
+  /** @brief Get the number of used pages currently evicted from memory */
+  std::size_t evicted() const { return size() - hot_pages_; }
 };
 
 XBT_ALWAYS_INLINE void PageStore::unref_page(std::size_t pageno)
@@ -170,6 +266,10 @@ XBT_ALWAYS_INLINE void PageStore::ref_page(size_t pageno)
 
 XBT_ALWAYS_INLINE void* PageStore::get_page(std::size_t pageno) const
 {
+  PageState& state = this->page_states_[pageno];
+  if (state.tier != Tier::hot)
+    this->load_page(pageno);
+  state.referenced = true;
   return (void*)simgrid::mc::mmu::join(pageno, (std::uintptr_t)this->memory_);
 }
 
@@ -14,7 +14,11 @@
 #include <unistd.h>
 
 #include <memory>
+#include <random>
+#include <vector>
 
+#include "src/include/xxhash.hpp"
+#include "src/internal_config.h" // HAVE_ZLIB
 #include "src/mc/sosp/PageStore.hpp"
 
 using simgrid::mc::PageStore;
@@ -36,6 +40,7 @@ public:
   static void store_new_page();
   static void unref_pages();
   static void reallocate_page();
+  static void store_pages_batch();
 
   static void new_content(void* buf, std::size_t size);
 };
@@ -62,6 +67,7 @@ void helper_tests::store_page_once()
   REQUIRE(store->get_ref(pageno[0]) == 1);
   const void* copy = store->get_page(pageno[0]);
   REQUIRE(::memcmp(data, copy, pagesize) == 0); // The page data should be the same
+  REQUIRE(store->get_hash(pageno[0]) == xxh::xxhash<64>(data, pagesize));
   REQUIRE(store->size() == 1);
 }
 
@@ -100,6 +106,25 @@ void helper_tests::reallocate_page()
   REQUIRE(store->size() == 2);
 }
 
+void helper_tests::store_pages_batch()
+{
+  auto* pages = static_cast<char*>(
+      mmap(nullptr, 3 * pagesize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  ::memcpy(pages, store->get_page(pageno[2]), pagesize); // Already in the store
+  new_content(pages + pagesize, pagesize);
+  ::memcpy(pages + 2 * pagesize, pages + pagesize, pagesize); // Twice the same new page
+
+  std::array<size_t, 3> batch;
+  store->store_pages(pages, batch.size(), batch.data());
+  REQUIRE(batch[0] == pageno[2]);
+  REQUIRE(batch[1] == batch[2]);
+  REQUIRE(batch[1] != pageno[2]);
+  REQUIRE(store->get_ref(batch[1]) == 2);
+  REQUIRE(::memcmp(pages + pagesize, store->get_page(batch[1]), pagesize) == 0);
+  REQUIRE(store->size() == 3);
+  munmap(pages, 3 * pagesize);
+}
+
 void helper_tests::new_content(void* buf, std::size_t size)
 {
   value++;
@@ -123,4 +148,65 @@ TEST_CASE("MC page store, used during checkpoint", "MC::PageStore")
 
   INFO("Reallocate pages");
   helper_tests::reallocate_page();
+
+  INFO("Store pages in batch");
+  helper_tests::store_pages_batch();
+}
+
+TEST_CASE("MC page store with a memory budget", "MC::PageStore")
+{
+  const std::size_t pagesize = getpagesize();
+  PageStore store(16);
+  store.set_budget(16 * pagesize);
+
+  // Half of the pages compress well, the other half are random
+  constexpr std::size_t count = 128;
+  std::vector<unsigned char> pages(count * pagesize);
+  std::mt19937 rng(42);
+  for (std::size_t i = 0; i < count; i++)
+    for (std::size_t j = 0; j < pagesize; j++)
+      pages[i * pagesize + j] = i % 2 == 0 ? static_cast<unsigned char>(i + j / 64) : static_cast<unsigned char>(rng());
+
+  std::vector<std::size_t> pagenos(count);
+  for (std::size_t i = 0; i < count; i += 8)
+    store.store_pages(&pages[i * pagesize], 8, &pagenos[i]);
+  REQUIRE(store.size() == count);
+  REQUIRE(store.evicted() > 0);
+
+  INFO("Evicted pages are found when storing them again");
+  for (std::size_t i = 0; i < count; i += 7) {
+    REQUIRE(store.store_page(&pages[i * pagesize]) == pagenos[i]);
+    REQUIRE(store.get_ref(pagenos[i]) == 2);
+    store.unref_page(pagenos[i]);
+  }
+
+  INFO("Evicted pages are loaded back with their content");
+  for (std::size_t i = 0; i < count; i++)
+    REQUIRE(::memcmp(store.get_page(pagenos[i]), &pages[i * pagesize], pagesize) == 0);
+
+  const PageStore::Stats& stats = store.get_stats();
+  REQUIRE(stats.new_pages == count);
+  REQUIRE(stats.spilled_pages > 0);
+#if HAVE_ZLIB
+  REQUIRE(stats.compressed_pages > 0);
+  REQUIRE(stats.compressed_bytes < stats.compressed_pages * pagesize / 2);
+#endif
+
+  INFO("Loading all the pages back exceeds the budget until the store is trimmed");
+  REQUIRE(stats.overshoot_bytes > 0);
+  REQUIRE(store.evicted() == 0);
+  store.trim();
+  REQUIRE(store.evicted() > 0);
+
+  INFO("Removed pages leave the hash index consistent");
+  for (std::size_t i = 0; i < count; i += 2)
+    store.unref_page(pagenos[i]);
+  REQUIRE(store.size() == count / 2);
+  for (std::size_t i = 1; i < count; i += 2)
+    REQUIRE(store.store_page(&pages[i * pagesize]) == pagenos[i]);
+  for (std::size_t i = 0; i < count; i += 2)
+    store.store_page(&pages[i * pagesize]);
+  REQUIRE(store.size() == count);
+  for (std::size_t i = 1; i < count; i += 2)
+    REQUIRE(::memcmp(store.get_page(pagenos[i]), &pages[i * pagesize], pagesize) == 0);
 }
@@ -9,6 +9,7 @@
 #include "src/mc/mc_forward.hpp"
 #include "src/mc/remote/RemoteProcess.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <sys/mman.h>
 #ifdef __FreeBSD__
@@ -22,8 +23,23 @@ Region::Region(RegionType region_type, void* start_addr, size_t size)
 {
   xbt_assert((((uintptr_t)start_addr) & (xbt_pagesize - 1)) == 0, "Start address not at the beginning of a page");
 
-  chunks_ = ChunkedData(mc_model_checker->page_store(), mc_model_checker->get_remote_process(),
-                        RemotePtr<void>(start_addr), mmu::chunk_count(size));
+  const RemoteProcess& process = mc_model_checker->get_remote_process();
+  std::size_t page_count      = mmu::chunk_count(size);
+
+  // With soft-dirty tracking, the pages that were not written since the last snapshot or restore are the ones known
+  // by the model checker: reuse them instead of reading them again.
+  std::vector<std::size_t> clean;
+  const ChunkedData* live = process.tracks_soft_dirty() ? mc_model_checker->get_live_region(start()) : nullptr;
+  if (live != nullptr) {
+    std::vector<bool> dirty = process.get_dirty_pages(start(), page_count);
+    clean.resize(page_count, ChunkedData::DIRTY_PAGE);
+    for (std::size_t i = 0; i < std::min(page_count, live->page_count()); ++i)
+      if (not dirty[i])
+        clean[i] = live->pageno(i);
+  }
+
+  chunks_ = ChunkedData(mc_model_checker->page_store(), process, start(), page_count,
+                        clean.empty() ? nullptr : clean.data());
 }
 
 /** @brief Restore a region from a snapshot
@@ -34,11 +50,21 @@ void Region::restore() const
 {
   xbt_assert(((start().address()) & (xbt_pagesize - 1)) == 0, "Not at the beginning of a page");
   xbt_assert(simgrid::mc::mmu::chunk_count(size()) == get_chunks().page_count());
+  const RemoteProcess& process = mc_model_checker->get_remote_process();
+
+  // With soft-dirty tracking, the pages that were not written since the last snapshot or restore and that are the
+  // same in this snapshot (identical pages share the same number in the page store) do not need to be written.
+  const ChunkedData* live = process.tracks_soft_dirty() ? mc_model_checker->get_live_region(start()) : nullptr;
+  std::vector<bool> dirty;
+  if (live != nullptr)
+    dirty = process.get_dirty_pages(start(), get_chunks().page_count());
 
   for (size_t i = 0; i != get_chunks().page_count(); ++i) {
+    if (live != nullptr && i < live->page_count() && not dirty[i] && live->pageno(i) == get_chunks().pageno(i))
+      continue;
     auto* target_page       = (void*)simgrid::mc::mmu::join(i, (std::uintptr_t)(void*)start().address());
     const void* source_page = get_chunks().page(i);
-    mc_model_checker->get_remote_process().write_bytes(source_page, xbt_pagesize, remote(target_page));
+    process.write_bytes(source_page, xbt_pagesize, remote(target_page));
   }
 }
 
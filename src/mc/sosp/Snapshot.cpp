@@ -5,7 +5,11 @@
 
 #include "src/mc/sosp/Snapshot.hpp"
 #include "src/mc/mc_config.hpp"
+#include "xbt/xbt_os_time.h"
 
+#include "src/include/xxhash.hpp"
+
+#include <algorithm>
 #include <cstddef> /* std::size_t */
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_snapshot, mc, "Taking and restoring snapshots");
@@ -26,6 +30,20 @@ void Snapshot::snapshot_regions(RemoteProcess* process)
 
   add_region(RegionType::Heap, nullptr, start_heap, (char*)end_heap - (char*)start_heap);
   heap_bytes_used_ = mmalloc_get_bytes_used_remote(heap->heaplimit, process->get_malloc_info());
+
+  mark_clean(process);
+}
+
+/** With soft-dirty tracking, remember that the regions of the application currently hold the content of this
+ *  snapshot, and start tracking the pages modified from now on */
+void Snapshot::mark_clean(RemoteProcess* process) const
+{
+  if (not process->tracks_soft_dirty())
+    return;
+  for (std::unique_ptr<Region> const& region : snapshot_regions_)
+    if (region)
+      mc_model_checker->set_live_region(region->start(), region->get_chunks());
+  process->clear_soft_dirty();
 }
 
 /** @brief Checks whether the variable is in scope for a given IP.
@@ -205,6 +223,7 @@ Snapshot::Snapshot(long num_state, RemoteProcess* process) : AddressSpace(proces
 
   /* Save the std heap and the writable mapped pages of libsimgrid and binary */
   snapshot_regions(process);
+  content_hash_ = this->do_content_hash();
 
   to_ignore_ = process->ignored_heap();
 
@@ -223,8 +242,11 @@ void Snapshot::add_region(RegionType type, ObjectInformation* object_info, void*
   else if (type == RegionType::Heap)
     xbt_assert(not object_info, "Unexpected object info for heap region.");
 
+  double start = xbt_os_time();
   auto* region = new Region(type, start_addr, size);
   region->object_info(object_info);
+  mc_model_checker->add_region_snapshot(object_info ? object_info->file_name : "heap", region->get_chunks().page_count(),
+                                        xbt_os_time() - start);
   snapshot_regions_.push_back(std::unique_ptr<Region>(region));
 }
 
@@ -278,6 +300,7 @@ void Snapshot::restore(RemoteProcess* process) const
     if (region) // privatized variables are not snapshotted
       region.get()->restore();
   }
+  mark_clean(process);
 
   ignore_restore();
   process->clear_cache();
@@ -288,21 +311,105 @@ class djb_hash {
   hash_type state_ = 5381LL;
 
 public:
-  template <class T> void update(T& x) { state_ = (state_ << 5) + state_ + x; }
+  template <class T> void update(const T& x) { state_ = (state_ << 5) + state_ + x; }
   hash_type value() const { return state_; }
 };
+
+/** Add the value of a variable to the hash, if operator== compares it byte per byte (see areas_differ_with_type) */
+static void hash_variable(djb_hash& hash, const Snapshot& snapshot, const void* address, const Type* type)
+{
+  while (type != nullptr &&
+         (type->type == DW_TAG_typedef || type->type == DW_TAG_const_type || type->type == DW_TAG_volatile_type))
+    type = type->subtype;
+  if (type == nullptr || type->byte_size <= 0 ||
+      (type->type != DW_TAG_base_type && type->type != DW_TAG_enumeration_type))
+    return;
+
+  std::vector<char> buffer(type->byte_size);
+  const void* value = snapshot.read_bytes(buffer.data(), buffer.size(), remote(address), ReadOptions::lazy());
+  hash.update(xxh::xxhash<64>(value, buffer.size()));
+}
+
+/** Compute the fingerprint of the state
+ *
+ *  Two snapshots that are equal according to operator== always have the same fingerprint: it is only built from what
+ *  is compared exactly (actors, stack sizes, frames, scalar local and global variables, heap usage), not from the
+ *  pointers nor from the heap blocks, which may differ between equal states.
+ */
 hash_type Snapshot::do_hash() const
 {
   XBT_DEBUG("START hash %ld", num_state_);
   djb_hash hash;
-  // TODO:
-  // * nb_processes
-  // * heap_bytes_used
-  // * root variables
-  // * basic stack frame information
-  // * stack frame local variables
+
+  // Actors, their stack frames and their local variables
+  hash.update(stacks_.size());
+  for (std::size_t size : stack_sizes_)
+    hash.update(size);
+  for (s_mc_snapshot_stack_t const& stack : stacks_) {
+    hash.update(stack.local_variables.size());
+    for (s_local_variable_t const& var : stack.local_variables) {
+      hash.update(var.ip);
+      hash_variable(hash, *this, var.address, var.type);
+    }
+  }
+
+  // Heap
+  hash.update(heap_bytes_used_);
+
+  // Global variables (the ignored ones are not listed in the object infos anymore)
+  for (std::unique_ptr<Region> const& region : snapshot_regions_) {
+    if (not region || region->region_type() != RegionType::Data)
+      continue;
+    const ObjectInformation* info = region->object_info();
+    for (Variable const& var : info->global_variables)
+      if ((char*)var.address >= info->start_rw && (char*)var.address <= info->end_rw)
+        hash_variable(hash, *this, var.address, var.type);
+  }
+
   XBT_DEBUG("END hash %ld", num_state_);
   return hash.value();
 }
 
+/** Compute the hash of the memory content of the state, from the hashes of its pages in the page store */
+hash_type Snapshot::do_content_hash() const
+{
+  const PageStore& store = mc_model_checker->page_store();
+  djb_hash hash;
+  for (std::unique_ptr<Region> const& region : snapshot_regions_) {
+    if (not region)
+      continue;
+    hash.update(region->start().address());
+    ChunkedData const& chunks = region->get_chunks();
+    for (std::size_t i = 0; i != chunks.page_count(); ++i)
+      hash.update(store.get_hash(chunks.pageno(i)));
+  }
+  return hash.value();
+}
+
+/** Whether the memory of both states is exactly the same
+ *
+ *  The identical pages are shared in the page store, so this only compares the page numbers of the regions.
+ */
+bool Snapshot::same_content(const Snapshot& other) const
+{
+  if (content_hash_ != other.content_hash_ || hash_ != other.hash_ ||
+      snapshot_regions_.size() != other.snapshot_regions_.size())
+    return false;
+  for (std::size_t i = 0; i != snapshot_regions_.size(); ++i) {
+    const Region* region1 = snapshot_regions_[i].get();
+    const Region* region2 = other.snapshot_regions_[i].get();
+    if (region1 == nullptr || region2 == nullptr) {
+      if (region1 != region2)
+        return false;
+      continue;
+    }
+    ChunkedData const& chunks1 = region1->get_chunks();
+    ChunkedData const& chunks2 = region2->get_chunks();
+    if (region1->start() != region2->start() || chunks1.page_count() != chunks2.page_count() ||
+        not std::equal(chunks1.pagenos(), chunks1.pagenos() + chunks1.page_count(), chunks2.pagenos()))
+      return false;
+  }
+  return true;
+}
+
 } // namespace simgrid::mc
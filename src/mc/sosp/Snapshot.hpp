@@ -77,6 +77,9 @@ public:
 
   bool operator==(const Snapshot& other);
   bool operator!=(const Snapshot& other) { return not(*this == other); }
+  /** Whether both snapshots hold exactly the same memory (this implies operator==) */
+  bool same_content(const Snapshot& other) const;
+  hash_type get_content_hash() const { return content_hash_; }
 
   // To be private
   long num_state_;
@@ -86,15 +89,19 @@ public:
   std::vector<s_mc_snapshot_stack_t> stacks_;
   std::vector<simgrid::mc::IgnoredHeapRegion> to_ignore_;
   std::uint64_t hash_ = 0;
+  std::uint64_t content_hash_ = 0;
   std::vector<s_mc_snapshot_ignored_data_t> ignored_data_;
 
 private:
+  bool equals_to(const Snapshot& other);
   void add_region(RegionType type, ObjectInformation* object_info, void* start_addr, std::size_t size);
   void snapshot_regions(RemoteProcess* process);
+  void mark_clean(RemoteProcess* process) const;
   void snapshot_stacks(RemoteProcess* process);
   void handle_ignore();
   void ignore_restore() const;
   hash_type do_hash() const;
+  hash_type do_content_hash() const;
 };
 } // namespace simgrid::mc
 
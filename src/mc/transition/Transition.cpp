@@ -53,6 +53,19 @@ void Transition::replay() const
 #endif
 }
 
+void Transition::replay(std::vector<Transition*> const& transitions)
+{
+  replayed_transitions_ += transitions.size();
+
+#if SIMGRID_HAVE_MC
+  std::vector<std::pair<aid_t, int>> simcalls;
+  simcalls.reserve(transitions.size());
+  for (const Transition* transition : transitions)
+    simcalls.emplace_back(transition->aid_, transition->times_considered_);
+  mc_model_checker->replay_simcalls(simcalls);
+#endif
+}
+
 Transition* deserialize_transition(aid_t issuer, int times_considered, std::stringstream& stream)
 {
 #if SIMGRID_HAVE_MC
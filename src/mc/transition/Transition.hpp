@@ -11,6 +11,7 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace simgrid::mc {
 
@@ -53,6 +54,9 @@ public:
    */
   int times_considered_ = 0;
 
+  /** Description of the transition as sent by the application (only kept when saving the exploration frontier) */
+  std::string serialized_;
+
   Transition() = default;
   Transition(Type type, aid_t issuer, int times_considered)
       : type_(type), aid_(issuer), times_considered_(times_considered)
@@ -67,6 +71,8 @@ public:
 
   /* Moves the application toward a path that was already explored, but don't change the current transition */
   void replay() const;
+  /* Same for a whole path, in one exchange with the application */
+  static void replay(std::vector<Transition*> const& transitions);
 
   virtual bool depends(const Transition* other) const { return true; }
 
@@ -102,6 +102,8 @@ int PMPI_Type_dup(MPI_Datatype datatype, MPI_Datatype *newtype){
   if(retval!=MPI_SUCCESS){
     simgrid::smpi::Datatype::unref(*newtype);
     *newtype = MPI_DATATYPE_NULL;
+  } else if ((*newtype)->is_valid()) {
+    (*newtype)->commit(); // the copy of a committed type is committed too, flatten its layout
   }
   return retval;
 }
@@ -0,0 +1,42 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "../colls_private.hpp"
+
+/* Allreduce following the netzone hierarchy of the platform (see Comm::init_topo).
+ *
+ * 1) reduce inside each domain of the innermost level (the ranks of a host, of a blade, ...) to its leader
+ * 2) the leaders reduce their partial results level by level up to rank 0
+ * 3) rank 0 broadcasts the result down the same levels
+ *
+ * Each level uses the ompi decision logic. Non-commutative operations are given to the ompi allreduce, as the
+ * reductions do not follow the rank order.
+ */
+namespace simgrid::smpi {
+int allreduce__topo(const void* sbuf, void* rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm)
+{
+  if (op != MPI_OP_NULL && not op->is_commutative())
+    return allreduce__ompi(sbuf, rbuf, rcount, dtype, op, comm);
+
+  if (sbuf != MPI_IN_PLACE)
+    Datatype::copy(sbuf, rcount, dtype, rbuf, rcount, dtype);
+  const std::vector<MPI_Comm>& levels = comm->get_topo_comms();
+  if (rcount == 0 || levels.empty())
+    return MPI_SUCCESS;
+
+  unsigned char* tmp_buf = smpi_get_tmp_sendbuffer(rcount * dtype->get_extent());
+  for (auto level = levels.rbegin(); level != levels.rend() && *level != MPI_COMM_NULL; ++level) {
+    Datatype::copy(rbuf, rcount, dtype, tmp_buf, rcount, dtype);
+    reduce__ompi(tmp_buf, rbuf, rcount, dtype, op, 0, *level);
+  }
+  smpi_free_tmp_buffer(tmp_buf);
+
+  for (MPI_Comm level : levels)
+    if (level != MPI_COMM_NULL)
+      bcast__ompi(rbuf, rcount, dtype, 0, level);
+  return MPI_SUCCESS;
+}
+} // namespace simgrid::smpi
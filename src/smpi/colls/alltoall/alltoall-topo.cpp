@@ -0,0 +1,98 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "../colls_private.hpp"
+
+/* Alltoall aggregating the messages in the innermost domains of the netzone hierarchy (see Comm::init_topo), such as
+ * the ranks of a host or the nodes of a dragonfly blade:
+ *
+ * 1) each domain gathers the buffers of its ranks on its leader
+ * 2) the leaders exchange the blocks of their domains with an alltoallv, so that only one message crosses the upper
+ *    levels of the hierarchy between each pair of domains
+ * 3) each leader scatters the received blocks to the ranks of its domain
+ *
+ * With a single level (flat platform with one rank per host), this falls back to the ompi alltoall.
+ */
+namespace simgrid::smpi {
+int alltoall__topo(const void* send_buff, int send_count, MPI_Datatype send_type, void* recv_buff, int recv_count,
+                   MPI_Datatype recv_type, MPI_Comm comm)
+{
+  const std::vector<MPI_Comm>& levels = comm->get_topo_comms();
+  if (levels.size() < 2)
+    return alltoall__ompi(send_buff, send_count, send_type, recv_buff, recv_count, recv_type, comm);
+
+  int size             = comm->size();
+  MPI_Comm domain_comm = levels.back();
+  int domain_size      = domain_comm->size();
+  size_t block         = static_cast<size_t>(recv_count) * recv_type->size();
+  size_t buffer_size   = block * size;
+
+  unsigned char* packed = smpi_get_tmp_sendbuffer(buffer_size);
+  if (send_buff == MPI_IN_PLACE)
+    Datatype::copy(recv_buff, recv_count * size, recv_type, packed, buffer_size, MPI_BYTE);
+  else
+    Datatype::copy(send_buff, send_count * size, send_type, packed, buffer_size, MPI_BYTE);
+
+  const std::vector<int>& leaders = comm->get_topo_leaders_map();
+  unsigned char* gathered         = nullptr;
+  unsigned char* to_scatter       = nullptr;
+  if (domain_comm->rank() == 0) {
+    gathered   = smpi_get_tmp_sendbuffer(buffer_size * domain_size);
+    to_scatter = smpi_get_tmp_recvbuffer(buffer_size * domain_size);
+  }
+  gather__ompi(packed, buffer_size, MPI_BYTE, gathered, buffer_size, MPI_BYTE, 0, domain_comm);
+
+  if (domain_comm->rank() == 0) {
+    MPI_Comm leaders_comm = comm->get_topo_leaders_comm();
+    int num_leaders       = leaders_comm->size();
+    /* The ranks of each domain, in the order of the leaders communicator and of the domain communicators */
+    std::vector<std::vector<int>> domains(num_leaders);
+    std::vector<int> leader_index(size);
+    for (int i = 0, index = 0; i < size; i++)
+      if (leaders[i] == i)
+        leader_index[i] = index++;
+    for (int i = 0; i < size; i++)
+      domains[leader_index[leaders[i]]].push_back(i);
+
+    std::vector<int> send_counts(num_leaders);
+    std::vector<int> send_disps(num_leaders);
+    int offset = 0;
+    for (int j = 0; j < num_leaders; j++) {
+      send_counts[j] = static_cast<int>(domain_size * domains[j].size() * block);
+      send_disps[j]  = offset;
+      offset += send_counts[j];
+    }
+    /* Blocks sent to the domain j, ordered by source in my domain and by destination in the domain j */
+    unsigned char* exchanged = smpi_get_tmp_recvbuffer(buffer_size * domain_size);
+    unsigned char* position  = to_scatter;
+    for (int j = 0; j < num_leaders; j++)
+      for (int src = 0; src < domain_size; src++)
+        for (int dst : domains[j]) {
+          memcpy(position, gathered + src * buffer_size + dst * block, block);
+          position += block;
+        }
+    alltoallv__ompi(to_scatter, send_counts.data(), send_disps.data(), MPI_BYTE, exchanged, send_counts.data(),
+                    send_disps.data(), MPI_BYTE, leaders_comm);
+
+    /* Reorder the received blocks by destination in my domain and by source rank */
+    for (int j = 0; j < num_leaders; j++)
+      for (size_t src = 0; src < domains[j].size(); src++)
+        for (int dst = 0; dst < domain_size; dst++)
+          memcpy(to_scatter + dst * buffer_size + domains[j][src] * block,
+                 exchanged + send_disps[j] + (src * domain_size + dst) * block, block);
+    smpi_free_tmp_buffer(exchanged);
+  }
+  scatter__ompi(to_scatter, buffer_size, MPI_BYTE, packed, buffer_size, MPI_BYTE, 0, domain_comm);
+  Datatype::copy(packed, buffer_size, MPI_BYTE, recv_buff, recv_count * size, recv_type);
+
+  smpi_free_tmp_buffer(packed);
+  if (gathered != nullptr) {
+    smpi_free_tmp_buffer(gathered);
+    smpi_free_tmp_buffer(to_scatter);
+  }
+  return MPI_SUCCESS;
+}
+} // namespace simgrid::smpi
@@ -0,0 +1,32 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "../colls_private.hpp"
+
+/* Broadcast following the netzone hierarchy of the platform (see Comm::init_topo): the data goes from rank 0 to the
+ * leaders of the outermost domains (dragonfly groups, fat-tree pods, ...), then down level by level to the ranks of
+ * each host. Each level uses the ompi decision logic. When the root is not rank 0, it first sends the data to rank 0.
+ */
+namespace simgrid::smpi {
+int bcast__topo(void* buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm)
+{
+  const std::vector<MPI_Comm>& levels = comm->get_topo_comms();
+  if (count == 0 || levels.empty())
+    return MPI_SUCCESS;
+
+  if (root != 0) {
+    if (comm->rank() == root)
+      Request::send(buf, count, datatype, 0, COLL_TAG_BCAST, comm);
+    else if (comm->rank() == 0)
+      Request::recv(buf, count, datatype, root, COLL_TAG_BCAST, comm, MPI_STATUS_IGNORE);
+  }
+
+  for (MPI_Comm level : levels)
+    if (level != MPI_COMM_NULL)
+      bcast__ompi(buf, count, datatype, 0, level);
+  return MPI_SUCCESS;
+}
+} // namespace simgrid::smpi
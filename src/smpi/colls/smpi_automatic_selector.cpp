@@ -10,6 +10,9 @@
 #include "simgrid/s4u/Engine.hpp"
 #include "src/smpi/include/smpi_actor.hpp"
 
+/* Relative difference under which the times of two algorithms are considered equal */
+constexpr double COLL_TIME_TIE_PRECISION = 1e-9;
+
 //attempt to do a quick autotuning version of the collective,
 #define AUTOMATIC_COLL_BENCH(cat, ret, args, args2)                                                                    \
   ret _XBT_CONCAT2(cat, __automatic)(COLL_UNPAREN args)                                                                \
@@ -20,7 +23,7 @@
     auto descriptions = simgrid::smpi::colls::get_smpi_coll_descriptions(_XBT_STRINGIFY(cat));                         \
     for (unsigned long i = 0; i < descriptions->size(); i++) {                                                         \
       auto desc = &descriptions->at(i);                                                                                \
-      if (desc->name == "automatic" || desc->name == "default")                                                        \
+      if (desc->name == "automatic" || desc->name == "default" || desc->name == "table")                               \
         continue;                                                                                                      \
       barrier__default(comm);                                                                                          \
       if (TRACE_is_enabled()) {                                                                                        \
@@ -47,7 +50,8 @@
         time_min = time2 - time1;                                                                                      \
       }                                                                                                                \
       if (comm->rank() == 0) {                                                                                         \
-        if (buf_in < max_min) {                                                                                        \
+        /* On equal times (up to the rounding errors), keep the first algorithm of the list */                         \
+        if (buf_in < max_min * (1 - COLL_TIME_TIE_PRECISION)) {                                                        \
           max_min     = buf_in;                                                                                        \
           global_coll = i;                                                                                             \
         }                                                                                                              \
@@ -57,6 +61,8 @@
       XBT_WARN("For rank 0, the quickest was %s : %f , but global was %s : %f at max",                                 \
                descriptions->at(min_coll).name.c_str(), time_min, descriptions->at(global_coll).name.c_str(),          \
                max_min);                                                                                               \
+      colls::record_decision(_XBT_STRINGIFY(cat), comm->size(), colls::_XBT_CONCAT(cat, _msg_size) args2,              \
+                             descriptions->at(global_coll).name, max_min);                                             \
     } else                                                                                                             \
       XBT_WARN("The quickest " _XBT_STRINGIFY(cat) " was %s on rank %d and took %f",                                   \
                descriptions->at(min_coll).name.c_str(), comm->rank(), time_min);                                       \
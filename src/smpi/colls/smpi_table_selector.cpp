@@ -0,0 +1,231 @@
+/* selector for collective algorithms based on a decision table computed beforehand */
+
+/* Copyright (c) 2023. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "colls_private.hpp"
+#include "xbt/config.hpp"
+#include "xbt/file.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace {
+/* For each size of communicator, the algorithm to use for the messages up to a given size */
+using DecisionTable = std::map<int, std::map<size_t, void*>>;
+
+/* Loaded once by set_collectives(), before the actors start, and only read afterward */
+std::map<std::string, DecisionTable, std::less<>> decision_tables;
+bool decision_tables_loaded = false;
+/* Selector of the collectives that do not appear in the table */
+std::string decision_fallback;
+std::ofstream decision_output;
+
+simgrid::config::Flag<std::string> cfg_coll_table{
+    "smpi/coll-table", "Decision table of the 'table' collective selector (see also smpi/coll-table-output)", ""};
+simgrid::config::Flag<std::string> cfg_coll_table_output{
+    "smpi/coll-table-output", "File where the automatic collective selector writes the best algorithm of each call",
+    ""};
+
+/* The decisions of that collective, or nullptr if it does not appear in the table */
+const DecisionTable* find_decision_table(const char* collective)
+{
+  xbt_assert(decision_tables_loaded, "The decision table of the 'table' collective selector was not loaded");
+  auto table = decision_tables.find(collective);
+  return table == decision_tables.end() ? nullptr : &table->second;
+}
+
+void* find_fallback(const char* collective)
+{
+  const std::vector<simgrid::smpi::s_mpi_coll_description_t>* descriptions =
+      simgrid::smpi::colls::get_smpi_coll_descriptions(collective);
+  auto desc = std::find_if(descriptions->begin(), descriptions->end(),
+                           [](const simgrid::smpi::s_mpi_coll_description_t& d) { return d.name == decision_fallback; });
+  xbt_assert(desc != descriptions->end(), "Collective '%s' has no algorithm '%s'", collective,
+             decision_fallback.c_str());
+  return desc->coll;
+}
+
+/* The entry for the largest communicator that is not larger than comm_size (or for the smallest one), and then for
+ * the smallest message size that is not smaller than msg_size (or for the largest one). */
+void* lookup_decision(const DecisionTable& table, int comm_size, size_t msg_size)
+{
+  auto by_comm_size = table.upper_bound(comm_size);
+  if (by_comm_size != table.begin())
+    --by_comm_size;
+  auto entry = by_comm_size->second.lower_bound(msg_size);
+  if (entry == by_comm_size->second.end())
+    --entry;
+  return entry->second;
+}
+} // namespace
+
+#define TABLE_COLL_SELECTOR(cat, ret, args, args2)                                                                     \
+  ret _XBT_CONCAT2(cat, __table)(COLL_UNPAREN args)                                                                    \
+  {                                                                                                                    \
+    static const DecisionTable* const table = find_decision_table(_XBT_STRINGIFY(cat));                                \
+    if (table == nullptr) {                                                                                            \
+      static const auto fallback = reinterpret_cast<ret(*) args>(find_fallback(_XBT_STRINGIFY(cat)));                  \
+      return fallback args2;                                                                                           \
+    }                                                                                                                  \
+    auto coll = reinterpret_cast<ret(*) args>(                                                                         \
+        lookup_decision(*table, comm->size(), colls::_XBT_CONCAT(cat, _msg_size) args2));                              \
+    return coll args2;                                                                                                 \
+  }
+
+namespace simgrid::smpi {
+
+void colls::load_decision_table(const std::string& filename)
+{
+  if (decision_tables_loaded)
+    return;
+  xbt_assert(not filename.empty(),
+             "The 'table' collective selector needs a decision table: please set smpi/coll-table");
+  std::ifstream in(filename);
+  xbt_assert(in.is_open(), "Cannot open the decision table '%s' (path=%s)", filename.c_str(),
+             simgrid::xbt::path_to_string().c_str());
+
+  /* The collectives missing from the table use the selector given by smpi/coll-selector (such as automatic), unless
+   * this selector is the table itself */
+  decision_fallback = simgrid::config::get_value<std::string>("smpi/coll-selector");
+  if (decision_fallback.empty() || decision_fallback == "table")
+    decision_fallback = "default";
+
+  /* Each line reads "<collective> <communicator size> <maximal message size> <algorithm>", and may be followed by
+   * anything else (such as the time measured by the automatic selector) */
+  std::string line;
+  int line_number = 0;
+  int entries     = 0;
+  while (std::getline(in, line)) {
+    line_number++;
+    std::istringstream fields(line);
+    std::string collective;
+    if (not(fields >> collective) || collective[0] == '#')
+      continue;
+    int comm_size;
+    size_t msg_size;
+    std::string algo;
+    xbt_assert(fields >> comm_size >> msg_size >> algo, "%s:%d: Invalid decision: %s", filename.c_str(), line_number,
+               line.c_str());
+    xbt_assert(algo != "automatic" && algo != "table", "%s:%d: Algorithm '%s' cannot be used in a decision table",
+               filename.c_str(), line_number, algo.c_str());
+
+    const std::vector<s_mpi_coll_description_t>* descriptions = get_smpi_coll_descriptions(collective);
+    auto desc = std::find_if(descriptions->begin(), descriptions->end(),
+                             [&algo](const s_mpi_coll_description_t& d) { return d.name == algo; });
+    xbt_assert(desc != descriptions->end(), "%s:%d: Collective '%s' has no algorithm '%s'", filename.c_str(),
+               line_number, collective.c_str(), algo.c_str());
+    decision_tables[collective][comm_size][msg_size] = desc->coll;
+    entries++;
+  }
+  decision_tables_loaded = true;
+  XBT_INFO("Loaded %d decisions for %zu collectives from %s", entries, decision_tables.size(), filename.c_str());
+}
+
+void colls::record_decision(const std::string& collective, int comm_size, size_t msg_size, const std::string& algo,
+                            double time)
+{
+  if (cfg_coll_table_output.get().empty())
+    return;
+  if (not decision_output.is_open()) {
+    decision_output.open(cfg_coll_table_output.get());
+    xbt_assert(decision_output.is_open(), "Cannot open '%s' to write the collective decisions",
+               cfg_coll_table_output.get().c_str());
+  }
+  decision_output << collective << ' ' << comm_size << ' ' << msg_size << ' ' << algo << ' ' << time << std::endl;
+}
+
+/* The message sizes must be identical on all ranks, so only the parameters that are significant everywhere are used */
+size_t colls::gather_msg_size(const void* send_buff, int send_count, MPI_Datatype send_type, void*, int recv_count,
+                              MPI_Datatype recv_type, int, MPI_Comm)
+{
+  return send_buff == MPI_IN_PLACE ? recv_count * recv_type->size() : send_count * send_type->size();
+}
+
+size_t colls::allgather_msg_size(const void*, int, MPI_Datatype, void*, int recv_count, MPI_Datatype recv_type,
+                                 MPI_Comm)
+{
+  return recv_count * recv_type->size();
+}
+
+size_t colls::allgatherv_msg_size(const void*, int, MPI_Datatype, void*, const int* recv_count, const int*,
+                                  MPI_Datatype recv_type, MPI_Comm comm)
+{
+  size_t total = 0;
+  for (int i = 0; i < comm->size(); i++)
+    total += recv_count[i];
+  return total * recv_type->size() / comm->size();
+}
+
+size_t colls::alltoall_msg_size(const void*, int, MPI_Datatype, void*, int recv_count, MPI_Datatype recv_type,
+                                MPI_Comm)
+{
+  return recv_count * recv_type->size();
+}
+
+// The counts of alltoallv differ from one rank to another, so only the size of the communicator is used
+size_t colls::alltoallv_msg_size(const void*, const int*, const int*, MPI_Datatype, void*, const int*, const int*,
+                                 MPI_Datatype, MPI_Comm)
+{
+  return 0;
+}
+
+size_t colls::bcast_msg_size(void*, int count, MPI_Datatype datatype, int, MPI_Comm)
+{
+  return count * datatype->size();
+}
+
+size_t colls::reduce_msg_size(const void*, void*, int count, MPI_Datatype datatype, MPI_Op, int, MPI_Comm)
+{
+  return count * datatype->size();
+}
+
+size_t colls::allreduce_msg_size(const void*, void*, int rcount, MPI_Datatype dtype, MPI_Op, MPI_Comm)
+{
+  return rcount * dtype->size();
+}
+
+size_t colls::reduce_scatter_msg_size(const void*, void*, const int* rcounts, MPI_Datatype dtype, MPI_Op,
+                                      MPI_Comm comm)
+{
+  size_t total = 0;
+  for (int i = 0; i < comm->size(); i++)
+    total += rcounts[i];
+  return total * dtype->size();
+}
+
+size_t colls::scatter_msg_size(const void*, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount,
+                               MPI_Datatype recvtype, int, MPI_Comm)
+{
+  return recvbuf == MPI_IN_PLACE ? sendcount * sendtype->size() : recvcount * recvtype->size();
+}
+
+size_t colls::barrier_msg_size(MPI_Comm)
+{
+  return 0;
+}
+
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_ALLGATHERV_SIG,
+           (send_buff, send_count, send_type, recv_buff, recv_count, recv_disps, recv_type, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_ALLREDUCE_SIG, (sbuf, rbuf, rcount, dtype, op, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_GATHER_SIG,
+           (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, root, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_ALLGATHER_SIG,
+           (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_ALLTOALL_SIG,
+           (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_ALLTOALLV_SIG,
+           (send_buff, send_counts, send_disps, send_type, recv_buff, recv_counts, recv_disps, recv_type, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_BCAST_SIG, (buf, count, datatype, root, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_REDUCE_SIG, (buf, rbuf, count, datatype, op, root, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_REDUCE_SCATTER_SIG, (sbuf, rbuf, rcounts, dtype, op, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_SCATTER_SIG,
+           (sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm))
+COLL_APPLY(TABLE_COLL_SELECTOR, COLL_BARRIER_SIG, (comm))
+
+} // namespace simgrid::smpi
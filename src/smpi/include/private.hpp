@@ -124,6 +124,7 @@ extern XBT_PRIVATE char* smpi_data_exe_start; // start of the data+bss segment o
 extern XBT_PRIVATE size_t smpi_data_exe_size; // size of the data+bss segment of the executable
 
 XBT_PRIVATE bool smpi_switch_data_segment(simgrid::s4u::ActorPtr actor, const void* addr = nullptr);
+XBT_PRIVATE void* smpi_privatized_address(simgrid::s4u::ActorPtr actor, void* addr);
 
 XBT_PRIVATE void smpi_prepare_global_memory_segment();
 XBT_PRIVATE void smpi_backup_global_memory_segment();
@@ -15,6 +15,8 @@
 #define COLL_DEFS(cat, ret, args, args2)                                                                               \
   extern int(*cat) args;
 
+#define COLL_MSG_SIZE_DEFS(cat, ret, args, args2) size_t _XBT_CONCAT(cat, _msg_size) args;
+
 #define COLL_UNPAREN(...)  __VA_ARGS__
 #define COLL_APPLY(action, sig, name) action(sig, name)
 
@@ -85,6 +87,24 @@ COLL_APPLY(COLL_DEFS, COLL_BCAST_SIG, "")
 COLL_APPLY(COLL_DEFS, COLL_ALLTOALL_SIG, "")
 COLL_APPLY(COLL_DEFS, COLL_ALLTOALLV_SIG, "")
 
+/* Decision table of the "table" selector (see smpi/coll-table), which can be produced by the automatic selector.
+ * The entries are indexed by the size of the communicator and by the message size computed by the *_msg_size()
+ * functions, which are the same on all ranks of the communicator. */
+void load_decision_table(const std::string& filename);
+void record_decision(const std::string& collective, int comm_size, size_t msg_size, const std::string& algo,
+                     double time);
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_GATHER_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_ALLGATHER_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_ALLGATHERV_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_REDUCE_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_ALLREDUCE_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_REDUCE_SCATTER_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_SCATTER_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_BARRIER_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_BCAST_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_ALLTOALL_SIG, "")
+COLL_APPLY(COLL_MSG_SIZE_DEFS, COLL_ALLTOALLV_SIG, "")
+
 // These fairly unused collectives only have one implementation in SMPI
 int gatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int* recvcounts,
             const int* displs, MPI_Datatype recvtype, int root, MPI_Comm comm);
@@ -149,6 +169,7 @@ int gather__mvapich2(const void *send_buff, int send_count, MPI_Datatype send_ty
 int gather__mvapich2_two_level(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, int root, MPI_Comm comm);
 int gather__impi(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, int root, MPI_Comm comm);
 int gather__automatic(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, int root, MPI_Comm comm);
+int gather__table(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, int root, MPI_Comm comm);
 
 int allgather__default(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 int allgather__2dmesh(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
@@ -172,6 +193,7 @@ int allgather__mvapich2_smp(const void *send_buff, int send_count, MPI_Datatype
 int allgather__mpich(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 int allgather__impi(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 int allgather__automatic(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
+int allgather__table(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 
 int allgatherv__default(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, const int *recv_count, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 int allgatherv__GB(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, const int *recv_count, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
@@ -186,6 +208,7 @@ int allgatherv__mpich_ring(const void *send_buff, int send_count, MPI_Datatype s
 int allgatherv__mvapich2(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, const int *recv_count, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 int allgatherv__impi(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, const int *recv_count, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 int allgatherv__automatic(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, const int *recv_count, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
+int allgatherv__table(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, const int *recv_count, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 
 int allreduce__default(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
 int allreduce__lr(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
@@ -208,7 +231,9 @@ int allreduce__mvapich2_rs(const void *sbuf, void *rbuf, int rcount, MPI_Datatyp
 int allreduce__mvapich2_two_level(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
 int allreduce__impi(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
 int allreduce__rab(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
+int allreduce__topo(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
 int allreduce__automatic(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
+int allreduce__table(const void *sbuf, void *rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm);
 
 int alltoall__default(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 int alltoall__2dmesh(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
@@ -230,7 +255,9 @@ int alltoall__mvapich2_scatter_dest(const void *send_buff, int send_count, MPI_D
 int alltoall__ompi(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 int alltoall__mpich(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 int alltoall__impi(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
+int alltoall__topo(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 int alltoall__automatic(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
+int alltoall__table(const void *send_buff, int send_count, MPI_Datatype send_type, void *recv_buff, int recv_count, MPI_Datatype recv_type, MPI_Comm comm);
 
 int alltoallv__default(const void *send_buff, const int *send_counts, const int *send_disps, MPI_Datatype send_type, void *recv_buff, const int *recv_counts, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 int alltoallv__bruck(const void *send_buff, const int *send_counts, const int *send_disps, MPI_Datatype send_type, void *recv_buff, const int *recv_counts, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
@@ -248,6 +275,7 @@ int alltoallv__ompi_basic_linear(const void *send_buff, const int *send_counts,
 int alltoallv__mvapich2(const void *send_buff, const int *send_counts, const int *send_disps, MPI_Datatype send_type, void *recv_buff, const int *recv_counts, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 int alltoallv__impi(const void *send_buff, const int *send_counts, const int *send_disps, MPI_Datatype send_type, void *recv_buff, const int *recv_counts, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 int alltoallv__automatic(const void *send_buff, const int *send_counts, const int *send_disps, MPI_Datatype send_type, void *recv_buff, const int *recv_counts, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
+int alltoallv__table(const void *send_buff, const int *send_counts, const int *send_disps, MPI_Datatype send_type, void *recv_buff, const int *recv_counts, const int *recv_disps, MPI_Datatype recv_type, MPI_Comm comm);
 
 int bcast__default(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
 int bcast__arrival_pattern_aware(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
@@ -273,7 +301,9 @@ int bcast__mvapich2_inter_node(void *buf, int count, MPI_Datatype datatype, int
 int bcast__mvapich2_intra_node(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
 int bcast__mvapich2_knomial_intra_node(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
 int bcast__impi(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
+int bcast__topo(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
 int bcast__automatic(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
+int bcast__table(void *buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
 
 int reduce__default(const void *buf, void *rbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm);
 int reduce__arrival_pattern_aware(const void *buf, void *rbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm);
@@ -295,6 +325,7 @@ int reduce__mvapich2_two_level(const void *buf, void *rbuf, int count, MPI_Datat
 int reduce__impi(const void *buf, void *rbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm);
 int reduce__rab(const void *buf, void *rbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm);
 int reduce__automatic(const void *buf, void *rbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm);
+int reduce__table(const void *buf, void *rbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm);
 
 int reduce_scatter__default(const void *sbuf, void *rbuf, const int *rcounts, MPI_Datatype dtype,MPI_Op  op,MPI_Comm  comm);
 int reduce_scatter__ompi(const void *sbuf, void *rbuf, const int *rcounts, MPI_Datatype dtype,MPI_Op  op,MPI_Comm  comm);
@@ -308,6 +339,7 @@ int reduce_scatter__mpich_noncomm(const void *sbuf, void *rbuf, const int *rcoun
 int reduce_scatter__mvapich2(const void *sbuf, void *rbuf, const int *rcounts, MPI_Datatype dtype,MPI_Op  op,MPI_Comm  comm);
 int reduce_scatter__impi(const void *sbuf, void *rbuf, const int *rcounts, MPI_Datatype dtype,MPI_Op  op,MPI_Comm  comm);
 int reduce_scatter__automatic(const void *sbuf, void *rbuf, const int *rcounts, MPI_Datatype dtype,MPI_Op  op,MPI_Comm  comm);
+int reduce_scatter__table(const void *sbuf, void *rbuf, const int *rcounts, MPI_Datatype dtype,MPI_Op  op,MPI_Comm  comm);
 
 int scatter__default(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm);
 int scatter__ompi(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm);
@@ -320,6 +352,7 @@ int scatter__mvapich2_two_level_binomial(const void *sendbuf, int sendcount, MPI
 int scatter__mvapich2_two_level_direct(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm);
 int scatter__impi (const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm);
 int scatter__automatic (const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm);
+int scatter__table(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm);
 
 int barrier__default(MPI_Comm comm);
 int barrier__ompi(MPI_Comm comm);
@@ -335,6 +368,7 @@ int barrier__mvapich2_pair(MPI_Comm comm);
 int barrier__mvapich2 (MPI_Comm comm);
 int barrier__impi(MPI_Comm comm);
 int barrier__automatic(MPI_Comm comm);
+int barrier__table(MPI_Comm comm);
 
 } // namespace simgrid::smpi
 #endif
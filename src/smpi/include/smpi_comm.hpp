@@ -6,9 +6,12 @@
 #ifndef SMPI_COMM_HPP_INCLUDED
 #define SMPI_COMM_HPP_INCLUDED
 
+#include <cstdint>
 #include <list>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include "smpi_errhandler.hpp"
 #include "smpi_keyvals.hpp"
 #include "smpi_group.hpp"
@@ -32,6 +35,12 @@ class Comm : public F2C, public Keyval{
   bool is_blocked_      = false;   // are ranks allocated on the same smp node contiguous?
   bool is_smp_comm_     = false;   // set to false in case this is already an intra-comm or a leader-comm to avoid
                                    // recursion
+  /* Communicators following the netzone hierarchy of the platform (see init_topo). They are indexed by rank since
+   * MPI_COMM_WORLD is shared by all processes */
+  std::vector<std::vector<MPI_Comm>> topo_comms_; // leaders of the subdomains of each level, from the outermost level
+  std::vector<MPI_Comm> topo_leaders_comms_;      // leaders of the innermost domains
+  std::vector<int> topo_leaders_map_;             // leader of the innermost domain of each rank
+  bool topo_initialized_ = false;
   std::list<MPI_Win> rma_wins_; // attached windows for synchronization.
   std::string name_;
   MPI_Info info_ = MPI_INFO_NULL;
@@ -39,8 +48,25 @@ class Comm : public F2C, public Keyval{
   MPI_Errhandler errhandler_ =  _smpi_cfg_default_errhandler_is_error ? MPI_ERRORS_ARE_FATAL : MPI_ERRORS_RETURN;;
   MPI_Errhandler* errhandlers_ = nullptr; //for MPI_COMM_WORLD only
 
-  std::unordered_map<std::string, unsigned int> sent_messages_;
-  std::unordered_map<std::string, unsigned int> recv_messages_;
+  /* Amount of messages exchanged so far for each (src, dst, tag), to enforce the non-overtaking rule */
+  struct MessageKey {
+    int src;
+    int dst;
+    int tag;
+    bool operator==(const MessageKey& other) const
+    {
+      return src == other.src && dst == other.dst && tag == other.tag;
+    }
+  };
+  struct MessageKeyHash {
+    size_t operator()(const MessageKey& key) const
+    {
+      auto peers = (static_cast<std::uint64_t>(static_cast<unsigned>(key.src)) << 32) | static_cast<unsigned>(key.dst);
+      return std::hash<std::uint64_t>()((peers * 0x9e3779b97f4a7c15ULL) ^ static_cast<unsigned>(key.tag));
+    }
+  };
+  std::unordered_map<MessageKey, unsigned int, MessageKeyHash> sent_messages_;
+  std::unordered_map<MessageKey, unsigned int, MessageKeyHash> recv_messages_;
   unsigned int collectives_count_ = 0;
   std::vector<unsigned int> collectives_counts_; // for MPI_COMM_WORLD only
 
@@ -81,6 +107,10 @@ public:
   static void unref(MPI_Comm comm);
   static void destroy(MPI_Comm comm);
   void init_smp();
+  void init_topo();
+  const std::vector<MPI_Comm>& get_topo_comms();
+  MPI_Comm get_topo_leaders_comm();
+  const std::vector<int>& get_topo_leaders_map();
 
   static void free_f(int id);
   static Comm* f2c(int);
@@ -96,6 +96,16 @@ class Datatype_contents {
   ~Datatype_contents();
 };
 
+/** One step of the pack plan of a derived datatype: block_count blocks of block_length elements of a non-derived type,
+ *  located block_stride bytes apart, the first one at offset bytes from the start of the buffer. */
+struct Datatype_plan_step {
+  MPI_Aint offset;
+  MPI_Aint block_stride;
+  int block_count;
+  int block_length;
+  MPI_Datatype type;
+};
+
 class Datatype : public F2C, public Keyval{
   std::string name_ = "";
   /* The id here is the (unique) datatype id used for this datastructure.
@@ -110,12 +120,18 @@ class Datatype : public F2C, public Keyval{
   int refcount_ = 1;
   std::unique_ptr<Datatype_contents> contents_ = nullptr;
   MPI_Datatype duplicated_datatype_ = MPI_DATATYPE_NULL;
+  /* Flattened layout of one element of this type, built by commit() and left untouched afterward */
+  std::vector<Datatype_plan_step> plan_;
+  bool plan_built_ = false;
+
+  const std::vector<Datatype_plan_step>& get_plan(std::vector<Datatype_plan_step>& scratch);
 
 protected:
   template <typename... Args> void set_contents(Args&&... args)
   {
     contents_ = std::make_unique<Datatype_contents>(std::forward<Args>(args)...);
   }
+  static void add_to_plan(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int block_length, MPI_Datatype type);
 
 public:
   static std::unordered_map<int, smpi_key_elem> keyvals_;
@@ -152,8 +168,10 @@ public:
   static int copy(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount,
                   MPI_Datatype recvtype);
   virtual int clone(MPI_Datatype* type);
-  virtual void serialize(const void* noncontiguous, void* contiguous, int count);
-  virtual void unserialize(const void* contiguous, void* noncontiguous, int count, MPI_Op op);
+  /** Append to the plan the blocks of count elements of this type, located at offset bytes in the buffer */
+  virtual void flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count);
+  void serialize(const void* noncontiguous, void* contiguous, int count);
+  void unserialize(const void* contiguous, void* noncontiguous, int count, MPI_Op op);
   int pack(const void* inbuf, int incount, void* outbuf, int outcount, int* position, const Comm* comm);
   int unpack(const void* inbuf, int insize, int* position, void* outbuf, int outcount, const Comm* comm);
   int get_contents(int max_integers, int max_addresses, int max_datatypes, int* array_of_integers,
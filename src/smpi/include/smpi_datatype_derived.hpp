@@ -21,8 +21,7 @@ public:
   Type_Contiguous& operator=(const Type_Contiguous&) = delete;
   ~Type_Contiguous() override;
   int clone(MPI_Datatype* type) override;
-  void serialize(const void* noncontiguous, void* contiguous, int count) override;
-  void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  void flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count) override;
 };
 
 class Type_Hvector: public Datatype{
@@ -38,8 +37,7 @@ public:
   Type_Hvector& operator=(const Type_Hvector&) = delete;
   ~Type_Hvector() override;
   int clone(MPI_Datatype* type) override;
-  void serialize(const void* noncontiguous, void* contiguous, int count) override;
-  void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  void flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count) override;
 };
 
 class Type_Vector : public Type_Hvector {
@@ -64,8 +62,7 @@ public:
   Type_Hindexed& operator=(const Type_Hindexed&) = delete;
   int clone(MPI_Datatype* type) override;
   ~Type_Hindexed() override;
-  void serialize(const void* noncontiguous, void* contiguous, int count) override;
-  void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  void flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count) override;
 };
 
 class Type_Indexed : public Type_Hindexed {
@@ -88,8 +85,7 @@ public:
   Type_Struct& operator=(const Type_Struct&) = delete;
   int clone(MPI_Datatype* type) override;
   ~Type_Struct() override;
-  void serialize(const void* noncontiguous, void* contiguous, int count) override;
-  void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  void flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count) override;
 };
 
 } // namespace simgrid::smpi
@@ -59,6 +59,10 @@ public:
   Request() = default;
   Request(const void* buf, int count, MPI_Datatype datatype, aid_t src, aid_t dst, int tag, MPI_Comm comm,
           unsigned flags, MPI_Op op = MPI_REPLACE);
+  /* The memory of the requests is recycled, as they are allocated for every message */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+  static void free_pool();
   MPI_Comm comm() const { return comm_; }
   size_t size() const { return size_; }
   size_t real_size() const { return real_size_; }
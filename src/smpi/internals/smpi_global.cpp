@@ -11,6 +11,7 @@
 #include "smpi_config.hpp"
 #include "smpi_f2c.hpp"
 #include "smpi_host.hpp"
+#include "smpi_request.hpp"
 #include "src/kernel/EngineImpl.hpp"
 #include "src/kernel/activity/CommImpl.hpp"
 #include "src/mc/mc_replay.hpp"
@@ -35,6 +36,13 @@
 #include <sys/sendfile.h>
 #endif
 
+#ifdef __linux__
+#include <linux/fs.h> /* FICLONE */
+#include <sys/ioctl.h>
+#include <sys/mman.h>     /* memfd_create */
+#include <sys/resource.h> /* RLIMIT_NOFILE */
+#endif
+
 #if HAVE_PAPI
 #include "papi.h"
 #endif
@@ -75,6 +83,17 @@ static int smpi_exit_status = 0;
 xbt_os_timer_t global_timer;
 static std::vector<std::string> privatize_libs_paths;
 
+/* Cost of the copies of the binary and libraries done by the dlopen privatization */
+static unsigned int privatization_cloned_files = 0;
+static unsigned int privatization_copied_files = 0;
+static unsigned int privatization_memory_files = 0;
+static std::uintmax_t privatization_copied_bytes = 0;
+static std::uintmax_t privatization_memory_bytes = 0;
+static double privatization_copy_time            = 0.0;
+/* Anonymous in-memory files holding the copies of the binary, when they could not be cloned in smpi/tmpdir. They are
+ * kept open until the end, as dlopen() would take a reused /proc/self/fd/<fd> path for an already loaded object. */
+static std::vector<int> privatization_memory_fds;
+
 // No instance gets manually created; check also the smpirun.in script as
 // this default name is used there as well (when the <actor> tag is generated).
 static const std::string smpi_default_instance_name("smpirun");
@@ -163,7 +182,8 @@ void smpi_comm_copy_buffer_callback(simgrid::kernel::activity::CommImpl* comm, v
   std::vector<std::pair<size_t, size_t>> src_private_blocks;
   std::vector<std::pair<size_t, size_t>> dst_private_blocks;
   XBT_DEBUG("Copy the data over");
-  if(smpi_is_shared(buff, src_private_blocks, &src_offset)) {
+  bool src_shared = smpi_is_shared(buff, src_private_blocks, &src_offset);
+  if (src_shared) {
     src_private_blocks = shift_and_frame_private_blocks(src_private_blocks, src_offset, buff_size);
     if (src_private_blocks.empty()) { // simple shared malloc ... return.
       XBT_VERB("Sender is shared. Let's ignore it.");
@@ -171,11 +191,8 @@ void smpi_comm_copy_buffer_callback(simgrid::kernel::activity::CommImpl* comm, v
       return;
     }
   }
-  else {
-    src_private_blocks.clear();
-    src_private_blocks.emplace_back(0, buff_size);
-  }
-  if (smpi_is_shared((char*)comm->dst_buff_, dst_private_blocks, &dst_offset)) {
+  bool dst_shared = smpi_is_shared((char*)comm->dst_buff_, dst_private_blocks, &dst_offset);
+  if (dst_shared) {
     dst_private_blocks = shift_and_frame_private_blocks(dst_private_blocks, dst_offset, buff_size);
     if (dst_private_blocks.empty()) { // simple shared malloc ... return.
       XBT_VERB("Receiver is shared. Let's ignore it.");
@@ -183,30 +200,35 @@ void smpi_comm_copy_buffer_callback(simgrid::kernel::activity::CommImpl* comm, v
       return;
     }
   }
-  else {
-    dst_private_blocks.clear();
-    dst_private_blocks.emplace_back(0, buff_size);
-  }
-  check_blocks(src_private_blocks, buff_size);
-  check_blocks(dst_private_blocks, buff_size);
-  auto private_blocks = merge_private_blocks(src_private_blocks, dst_private_blocks);
-  check_blocks(private_blocks, buff_size);
-  void* tmpbuff=buff;
-  if (smpi_switch_data_segment(comm->src_actor_->get_iface(), buff)) {
-    XBT_DEBUG("Privatization : We are copying from a zone inside global memory... Saving data to temp buffer !");
-    tmpbuff = xbt_malloc(buff_size);
-    memcpy_private(tmpbuff, buff, private_blocks);
+
+  // In the common case where no buffer is shared, the whole buffer is copied without building the block lists
+  std::vector<std::pair<size_t, size_t>> private_blocks;
+  bool partial_copy = src_shared || dst_shared;
+  if (partial_copy) {
+    if (not src_shared)
+      src_private_blocks.emplace_back(0, buff_size);
+    if (not dst_shared)
+      dst_private_blocks.emplace_back(0, buff_size);
+    check_blocks(src_private_blocks, buff_size);
+    check_blocks(dst_private_blocks, buff_size);
+    private_blocks = merge_private_blocks(src_private_blocks, dst_private_blocks);
+    check_blocks(private_blocks, buff_size);
   }
+  auto copy_data = [partial_copy, &private_blocks, buff_size](void* dest, const void* src) {
+    if (partial_copy)
+      memcpy_private(dest, src, private_blocks);
+    else
+      memcpy(dest, src, buff_size);
+  };
 
-  if (smpi_switch_data_segment(comm->dst_actor_->get_iface(), comm->dst_buff_))
-    XBT_DEBUG("Privatization : We are copying to a zone inside global memory - Switch data segment");
+  // With the mmap privatization, buffers located in the globals are accessed through the mapping of their actor
+  const void* src_buff = smpi_privatized_address(comm->src_actor_->get_iface(), buff);
+  void* dst_buff       = smpi_privatized_address(comm->dst_actor_->get_iface(), comm->dst_buff_);
 
-  XBT_DEBUG("Copying %zu bytes from %p to %p", buff_size, tmpbuff, comm->dst_buff_);
-  memcpy_private(comm->dst_buff_, tmpbuff, private_blocks);
+  XBT_DEBUG("Copying %zu bytes from %p to %p", buff_size, src_buff, dst_buff);
+  copy_data(dst_buff, src_buff);
 
   smpi_cleanup_comm_after_copy(comm,buff);
-  if (tmpbuff != buff)
-    xbt_free(tmpbuff);
 }
 
 void smpi_comm_null_copy_buffer_callback(simgrid::kernel::activity::CommImpl*, void*, size_t)
@@ -336,15 +358,9 @@ static smpi_entry_point_type smpi_resolve_function(void* handle)
   return smpi_entry_point_type();
 }
 
-static void smpi_copy_file(const std::string& src, const std::string& target, off_t fdin_size)
+/** Copy the content of fdin into fdout, and close both of them */
+static void smpi_copy_fd(int fdin, int fdout, off_t fdin_size, const std::string& src, const std::string& target)
 {
-  int fdin = open(src.c_str(), O_RDONLY);
-  xbt_assert(fdin >= 0, "Cannot read from %s. Please make sure that the file exists and is executable.", src.c_str());
-  xbt_assert(unlink(target.c_str()) == 0 || errno == ENOENT, "Failed to unlink file %s: %s", target.c_str(),
-             strerror(errno));
-  int fdout = open(target.c_str(), O_CREAT | O_RDWR | O_EXCL, S_IRWXU);
-  xbt_assert(fdout >= 0, "Cannot write into %s: %s", target.c_str(), strerror(errno));
-
   XBT_DEBUG("Copy %" PRIdMAX " bytes into %s", static_cast<intmax_t>(fdin_size), target.c_str());
 #if SG_HAVE_SENDFILE
   ssize_t sent_size = sendfile(fdout, fdin, nullptr, fdin_size);
@@ -379,6 +395,65 @@ static void smpi_copy_file(const std::string& src, const std::string& target, of
   close(fdout);
 }
 
+/** Copy a file, or clone it if the file system allows it. Returns whether the copy was cloned */
+static bool smpi_copy_file(const std::string& src, const std::string& target, off_t fdin_size)
+{
+  int fdin = open(src.c_str(), O_RDONLY);
+  xbt_assert(fdin >= 0, "Cannot read from %s. Please make sure that the file exists and is executable.", src.c_str());
+  xbt_assert(unlink(target.c_str()) == 0 || errno == ENOENT, "Failed to unlink file %s: %s", target.c_str(),
+             strerror(errno));
+  int fdout = open(target.c_str(), O_CREAT | O_RDWR | O_EXCL, S_IRWXU);
+  xbt_assert(fdout >= 0, "Cannot write into %s: %s", target.c_str(), strerror(errno));
+
+#ifdef FICLONE
+  // On copy-on-write file systems (btrfs, XFS, ...), the copy shares the blocks of the original: no data is written
+  if (ioctl(fdout, FICLONE, fdin) == 0) {
+    XBT_DEBUG("Cloned %s into %s", src.c_str(), target.c_str());
+    privatization_cloned_files++;
+    close(fdin);
+    close(fdout);
+    return true;
+  }
+#endif
+  privatization_copied_files++;
+  privatization_copied_bytes += fdin_size;
+  smpi_copy_fd(fdin, fdout, fdin_size, src, target);
+  return false;
+}
+
+/** Copy a file into an anonymous in-memory file, and return the path to dlopen() it (or an empty string on failure)
+ *
+ *  Nothing is written in smpi/tmpdir, and there is nothing to clean if the simulation gets killed. glibc identifies
+ *  the loaded objects by device and inode, so each rank still needs its own copy of the binary.
+ */
+static std::string smpi_copy_file_in_memory(const std::string& src, off_t fdin_size)
+{
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+  if (privatization_memory_fds.empty()) { // One file per rank remains open: allow as many files as possible
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+      limit.rlim_cur = limit.rlim_max;
+      setrlimit(RLIMIT_NOFILE, &limit);
+    }
+  }
+  int fdout = memfd_create(simgrid::xbt::Path(src).get_base_name().c_str(), MFD_CLOEXEC);
+  if (fdout < 0) {
+    XBT_DEBUG("Cannot create an in-memory copy of %s: %s", src.c_str(), strerror(errno));
+    return "";
+  }
+  int fdin = open(src.c_str(), O_RDONLY);
+  xbt_assert(fdin >= 0, "Cannot read from %s. Please make sure that the file exists and is executable.", src.c_str());
+  std::string target = "/proc/self/fd/" + std::to_string(fdout);
+  smpi_copy_fd(fdin, dup(fdout), fdin_size, src, target);
+  privatization_memory_fds.push_back(fdout);
+  privatization_memory_files++;
+  privatization_memory_bytes += fdin_size;
+  return target;
+#else
+  return "";
+#endif
+}
+
 #if not defined(__APPLE__) && not defined(__HAIKU__)
 static int visit_libs(struct dl_phdr_info* info, size_t, void* data)
 {
@@ -426,12 +501,24 @@ static void smpi_init_privatization_dlopen(const std::string& executable)
   simgrid::s4u::Engine::get_instance()->register_default([executable, fdin_size](std::vector<std::string> args) {
     return simgrid::kernel::actor::ActorCode([executable, fdin_size, args = std::move(args)] {
       static std::size_t rank = 0;
+      // Once a copy could not be cloned in smpi/tmpdir, the next ones are done in memory when possible
+      static bool in_memory = false;
+      xbt_os_timer_t copy_timer = xbt_os_timer_new();
+      xbt_os_walltimer_start(copy_timer);
       // Copy the dynamic library:
-      simgrid::xbt::Path path(executable);
-      std::string target_executable = simgrid::config::get_value<std::string>("smpi/tmpdir") + "/" +
-          path.get_base_name() + "_" + std::to_string(getpid()) + "_" + std::to_string(rank) + ".so";
-
-      smpi_copy_file(executable, target_executable, fdin_size);
+      std::string target_executable;
+      bool temporary_file = true;
+      if (in_memory)
+        target_executable = smpi_copy_file_in_memory(executable, fdin_size);
+      if (target_executable.empty()) {
+        simgrid::xbt::Path path(executable);
+        target_executable = simgrid::config::get_value<std::string>("smpi/tmpdir") + "/" + path.get_base_name() + "_" +
+                            std::to_string(getpid()) + "_" + std::to_string(rank) + ".so";
+        bool cloned = smpi_copy_file(executable, target_executable, fdin_size);
+        // The copies of the libraries are modified with sed, and the kept temporary files must be in smpi/tmpdir
+        in_memory = not cloned && privatize_libs_paths.empty() && not simgrid::config::get_value<bool>("smpi/keep-temps");
+      } else
+        temporary_file = false;
       // if smpi/privatize-libs is set, duplicate pointed lib and link each executable copy to a different one.
       std::vector<std::string> target_libs;
       for (auto const& libpath : privatize_libs_paths) {
@@ -466,8 +553,12 @@ static void smpi_init_privatization_dlopen(const std::string& executable)
       // Load the copy and resolve the entry point:
       void* handle    = dlopen(target_executable.c_str(), RTLD_LAZY | RTLD_LOCAL | WANT_RTLD_DEEPBIND);
       int saved_errno = errno;
+      xbt_os_walltimer_stop(copy_timer);
+      privatization_copy_time += xbt_os_timer_elapsed(copy_timer);
+      xbt_os_timer_free(copy_timer);
       if (not simgrid::config::get_value<bool>("smpi/keep-temps")) {
-        unlink(target_executable.c_str());
+        if (temporary_file)
+          unlink(target_executable.c_str());
         for (const std::string& target_lib : target_libs)
           unlink(target_lib.c_str());
       }
@@ -627,6 +718,18 @@ void SMPI_finalize()
   if (smpi_cfg_privatization() == SmpiPrivStrategies::MMAP)
     smpi_destroy_global_memory_segments();
 
+  if (smpi_cfg_privatization() == SmpiPrivStrategies::DLOPEN &&
+      simgrid::config::get_value<bool>("smpi/display-timing"))
+    XBT_INFO("The dlopen privatization cloned %u files and copied %u files (%" PRIuMAX " bytes written to %s), "
+             "and copied %u files in memory (%" PRIuMAX " bytes). Copying and loading them took %g seconds.",
+             privatization_cloned_files, privatization_copied_files, privatization_copied_bytes,
+             simgrid::config::get_value<std::string>("smpi/tmpdir").c_str(), privatization_memory_files,
+             privatization_memory_bytes, privatization_copy_time);
+  for (int fd : privatization_memory_fds)
+    close(fd);
+  privatization_memory_fds.clear();
+
+  simgrid::smpi::Request::free_pool();
   simgrid::smpi::utils::print_memory_analysis();
 }
 
@@ -30,6 +30,8 @@ char* smpi_data_exe_start = nullptr;
 size_t smpi_data_exe_size = 0;
 SmpiPrivStrategies smpi_privatize_global_variables;
 static void* smpi_data_exe_copy;
+// Amount of times the data segment was remapped, displayed with smpi/display-timing
+static unsigned long smpi_data_exe_switches = 0;
 
 // Initialized by smpi_prepare_global_memory_segment().
 static std::vector<simgrid::xbt::VmMap> initial_vm_map;
@@ -176,6 +178,9 @@ void* smpi_temp_shm_mmap(int fd, size_t size)
  *  If 'addr' is not null, only switch if it's an address from the data segment.
  *
  *  Returns 'true' if the segment has to be switched (mmap privatization and 'addr' in data segment).
+ *
+ *  The switch remaps the data segment with mmap(MAP_FIXED), i.e. a system call whenever the actor differs from the
+ *  previous one. Use smpi_privatized_address() to merely access the globals of another actor.
  */
 bool smpi_switch_data_segment(simgrid::s4u::ActorPtr actor, const void* addr)
 {
@@ -200,11 +205,32 @@ bool smpi_switch_data_segment(simgrid::s4u::ActorPtr actor, const void* addr)
                  TOPAGE(smpi_data_exe_start),
              "Couldn't map the new region (errno %d): %s", errno, strerror(errno));
   smpi_loaded_page = actor->get_pid();
+  smpi_data_exe_switches++;
 #endif
 
   return true;
 }
 
+/** Get the address where the given actor's copy of 'addr' can be accessed, without switching the data segment
+ *
+ *  Each privatization region remains mapped at its own address in addition to the switching area, so the globals of
+ *  any actor can be reached at any time. If 'addr' is not in the data segment, or if the privatization is not done
+ *  with mmap, 'addr' is returned unchanged.
+ */
+void* smpi_privatized_address(simgrid::s4u::ActorPtr actor, void* addr)
+{
+  if (smpi_cfg_privatization() != SmpiPrivStrategies::MMAP || smpi_data_exe_size == 0 || addr == nullptr ||
+      not(static_cast<const char*>(addr) >= smpi_data_exe_start &&
+          static_cast<const char*>(addr) < smpi_data_exe_start + smpi_data_exe_size))
+    return addr;
+
+  const simgrid::smpi::ActorExt* process = smpi_process_remote(actor);
+  if (process == nullptr || process->privatized_region() == nullptr)
+    return addr;
+  return static_cast<char*>(process->privatized_region()->address) +
+         (static_cast<char*>(addr) - static_cast<char*>(TOPAGE(smpi_data_exe_start)));
+}
+
 /**
  * @brief Makes a backup of the segment in memory that stores the global variables of a process.
  *        This backup is then used to initialize the global variables for every single
@@ -253,6 +279,9 @@ smpi_privatization_region_t smpi_init_global_memory_segment_process()
 void smpi_destroy_global_memory_segments(){
   if (smpi_data_exe_size == 0) // no need to switch
     return;
+  if (simgrid::config::get_value<bool>("smpi/display-timing"))
+    XBT_INFO("The mmap privatization switched the data segment (%zu bytes) %lu times.", smpi_data_exe_size,
+             smpi_data_exe_switches);
 #if HAVE_PRIVATIZATION
   for (auto const& region : smpi_privatization_regions) {
     if (munmap(region.address, smpi_data_exe_size) < 0)
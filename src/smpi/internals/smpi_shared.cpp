@@ -36,6 +36,7 @@
 #include <array>
 #include <cstring>
 #include <map>
+#include <string_view>
 
 #include "private.hpp"
 #include "xbt/config.hpp"
@@ -64,20 +65,31 @@ namespace{
  *  This information is used by SMPI_SHARED_MALLOC to allocate  some shared memory for all simulated processes.
  */
 
-class smpi_source_location : public std::string {
-public:
-  smpi_source_location() = default;
-  smpi_source_location(const char* filename, int line) : std::string(std::string(filename) + ":" + std::to_string(line))
+struct smpi_source_location {
+  std::string filename;
+  int line = 0;
+};
+
+/* Compare the locations with the (filename, line) given by the user code, without building a key for each lookup */
+struct smpi_source_location_less {
+  using is_transparent = void;
+  template <class L1, class L2> bool operator()(const L1& a, const L2& b) const
   {
+    int cmp = std::string_view(a.filename).compare(b.filename);
+    return cmp < 0 || (cmp == 0 && a.line < b.line);
   }
 };
+struct smpi_source_location_ref {
+  std::string_view filename;
+  int line;
+};
 
 struct shared_data_t {
   int fd    = -1;
   int count = 0;
 };
 
-std::unordered_map<smpi_source_location, shared_data_t, std::hash<std::string>> allocs;
+std::map<smpi_source_location, shared_data_t, smpi_source_location_less> allocs;
 using shared_data_key_type = decltype(allocs)::value_type;
 
 struct shared_metadata_t {
@@ -86,11 +98,25 @@ struct shared_metadata_t {
   void *allocated_ptr;
   std::vector<std::pair<size_t, size_t>> private_blocks;
   shared_data_key_type* data;
+  unsigned long mappings = 1; // amount of mmap() done for this allocation
 };
 
 std::map<const void*, shared_metadata_t> allocs_metadata;
 std::map<std::string, void*, std::less<>> calls;
 
+/* Bounds of the address range containing all shared allocations, to quickly reject the other addresses before
+ * searching allocs_metadata. This is only a pre-check: the addresses within the bounds are still looked up in the map,
+ * and the bounds are not shrunk when the allocations are freed. */
+const char* allocs_lowest_addr  = nullptr;
+const char* allocs_highest_addr = nullptr;
+
+/* Statistics displayed with smpi/display-allocs */
+unsigned long shared_mappings        = 0; // amount of mmap() of shared memory, each of them creating a VMA
+unsigned long shared_live_mappings   = 0; // amount of these mappings that are not unmapped yet
+unsigned long shared_peak_mappings   = 0; // maximum of shared_live_mappings
+unsigned long long shared_virtual_size  = 0; // size of the shared allocations
+unsigned long long shared_physical_size = 0; // memory actually backing them
+
 int smpi_shared_malloc_bogusfile           = -1;
 int smpi_shared_malloc_bogusfile_huge_page = -1;
 unsigned long smpi_shared_malloc_blocksize = 1UL << 20;
@@ -98,20 +124,41 @@ unsigned long smpi_shared_malloc_blocksize = 1UL << 20;
 
 void smpi_shared_destroy()
 {
+  if (smpi_cfg_display_alloc() && shared_mappings > 0)
+    XBT_INFO("Shared allocations: %llu bytes backed by %llu bytes of memory, through %lu memory mappings "
+             "(at most %lu at the same time)",
+             shared_virtual_size, shared_physical_size, shared_mappings, shared_peak_mappings);
   allocs.clear();
   allocs_metadata.clear();
   calls.clear();
+  allocs_lowest_addr  = nullptr;
+  allocs_highest_addr = nullptr;
+}
+
+static void register_metadata(void* mem, shared_metadata_t&& meta)
+{
+  auto* low  = static_cast<const char*>(meta.allocated_ptr);
+  auto* high = low + meta.allocated_size;
+  if (allocs_metadata.empty() || low < allocs_lowest_addr)
+    allocs_lowest_addr = low;
+  if (allocs_metadata.empty() || high > allocs_highest_addr)
+    allocs_highest_addr = high;
+  shared_virtual_size += meta.size;
+  shared_live_mappings += meta.mappings;
+  shared_peak_mappings = std::max(shared_peak_mappings, shared_live_mappings);
+  allocs_metadata[mem] = std::move(meta);
 }
 
 static void* shm_map(int fd, size_t size, shared_data_key_type* data)
 {
   void* mem = smpi_temp_shm_mmap(fd, size);
+  shared_mappings++;
   shared_metadata_t meta;
   meta.size = size;
   meta.data = data;
   meta.allocated_ptr   = mem;
   meta.allocated_size  = size;
-  allocs_metadata[mem] = meta;
+  register_metadata(mem, std::move(meta));
   XBT_DEBUG("MMAP %zu to %p", size, mem);
   return mem;
 }
@@ -119,14 +166,14 @@ static void* shm_map(int fd, size_t size, shared_data_key_type* data)
 static void *smpi_shared_malloc_local(size_t size, const char *file, int line)
 {
   void* mem;
-  smpi_source_location loc(file, line);
-  auto [data, inserted] = allocs.try_emplace(loc);
-  if (inserted) {
-    // The new element was inserted.
+  auto data = allocs.find(smpi_source_location_ref{file, line});
+  if (data == allocs.end()) {
+    data               = allocs.try_emplace(smpi_source_location{file, line}).first;
     int fd             = smpi_temp_shm_get();
     data->second.fd    = fd;
     data->second.count = 1;
     mem = shm_map(fd, size, &*data);
+    shared_physical_size += size;
   } else {
     mem = shm_map(data->second.fd, size, &*data);
     data->second.count++;
@@ -194,6 +241,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
   if(use_huge_page && smpi_shared_malloc_bogusfile_huge_page == -1) {
     std::string huge_page_filename         = huge_page_mount_point + "/simgrid-shmalloc-XXXXXX";
     smpi_shared_malloc_bogusfile_huge_page = mkstemp((char*)huge_page_filename.c_str());
+    shared_physical_size += HUGE_PAGE_SIZE;
     XBT_DEBUG("bogusfile_huge_page: %s\n", huge_page_filename.c_str());
     unlink(huge_page_filename.c_str());
   }
@@ -204,6 +252,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
     unlink(name);
     xbt_assert(ftruncate(smpi_shared_malloc_bogusfile, smpi_shared_malloc_blocksize) == 0,
                "Could not write bogus file for shared malloc");
+    shared_physical_size += smpi_shared_malloc_blocksize;
   }
 
   int mmap_base_flag = MAP_FIXED | MAP_SHARED | MAP_POPULATE;
@@ -215,6 +264,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
 #endif
 
   XBT_DEBUG("global shared allocation, begin mmap");
+  unsigned long mappings = shared_mappings;
 
   /* Map the bogus file in place of the anonymous memory */
   for(int i_block = 0; i_block < nb_shared_blocks; i_block ++) {
@@ -232,6 +282,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
       XBT_DEBUG("\t\tglobal shared allocation, mmap block offset %zx", offset);
       void* pos       = static_cast<char*>(mem) + offset;
       const void* res = mmap(pos, smpi_shared_malloc_blocksize, PROT_READ | PROT_WRITE, mmap_flag, huge_fd, 0);
+      shared_mappings++;
       xbt_assert(res == pos, "Could not map folded virtual memory (%s). Do you perhaps need to increase the "
                              "size of the mapped file using --cfg=smpi/shared-malloc-blocksize:newvalue (default 1048576) ? "
                              "You can also try using  the sysctl vm.max_map_count. "
@@ -247,6 +298,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
       const void* res = mmap(pos, low_page_stop_offset - low_page_start_offset, PROT_READ | PROT_WRITE,
                              mmap_base_flag, // not a full huge page
                              smpi_shared_malloc_bogusfile, 0);
+      shared_mappings++;
       xbt_assert(res == pos, "Could not map folded virtual memory (%s). Do you perhaps need to increase the "
                              "size of the mapped file using --cfg=smpi/shared-malloc-blocksize:newvalue (default 1048576) ?"
                              "You can also try using  the sysctl vm.max_map_count",
@@ -260,6 +312,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
         const void* res = mmap(pos, high_page_stop_offset - stop_block_offset, PROT_READ | PROT_WRITE,
                                mmap_base_flag, // not a full huge page
                                smpi_shared_malloc_bogusfile, 0);
+        shared_mappings++;
         xbt_assert(res == pos, "Could not map folded virtual memory (%s). Do you perhaps need to increase the "
                                "size of the mapped file using --cfg=smpi/shared-malloc-blocksize:newvalue (default 1048576) ?"
                                "You can also try using  the sysctl vm.max_map_count",
@@ -277,6 +330,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
   newmeta.data = data;
   newmeta.allocated_ptr = allocated_ptr;
   newmeta.allocated_size = allocated_size;
+  newmeta.mappings       = shared_mappings - mappings + 1; // the folded blocks, within the reserved area
   if(shared_block_offsets[0] > 0) {
     newmeta.private_blocks.emplace_back(0, shared_block_offsets[0]);
   }
@@ -287,7 +341,7 @@ void* smpi_shared_malloc_partial(size_t size, const size_t* shared_block_offsets
   if(shared_block_offsets[2*i_block+1] < size) {
     newmeta.private_blocks.emplace_back(shared_block_offsets[2 * i_block + 1], size);
   }
-  allocs_metadata[mem] = newmeta;
+  register_metadata(mem, std::move(newmeta));
 
   XBT_DEBUG("global shared allocation, allocated_ptr %p - %p", allocated_ptr, (void*)(((uint64_t)allocated_ptr)+allocated_size));
   XBT_DEBUG("global shared allocation, returned_ptr  %p - %p", mem, (void*)(((uint64_t)mem)+size));
@@ -365,7 +419,8 @@ void* smpi_shared_malloc(size_t size, const char* file, int line)
 
 int smpi_is_shared(const void* ptr, std::vector<std::pair<size_t, size_t>> &private_blocks, size_t *offset){
   private_blocks.clear(); // being paranoid
-  if (allocs_metadata.empty())
+  if (allocs_metadata.empty() || static_cast<const char*>(ptr) < allocs_lowest_addr ||
+      static_cast<const char*>(ptr) >= allocs_highest_addr)
     return 0;
   if (smpi_cfg_shared_malloc() == SharedMallocType::LOCAL || smpi_cfg_shared_malloc() == SharedMallocType::GLOBAL) {
     auto low = allocs_metadata.lower_bound(ptr);
@@ -442,6 +497,7 @@ void smpi_shared_free(void *ptr)
     if (munmap(meta->second.allocated_ptr, meta->second.allocated_size) < 0) {
       XBT_WARN("Unmapping of fd %d failed: %s", data->fd, strerror(errno));
     }
+    shared_live_mappings -= meta->second.mappings;
     data->count--;
     if (data->count <= 0) {
       close(data->fd);
@@ -458,6 +514,7 @@ void smpi_shared_free(void *ptr)
       meta->second.data->second.count--;
       XBT_DEBUG("Shared free - Global - of %p", ptr);
       munmap(ptr, meta->second.size);
+      shared_live_mappings -= meta->second.mappings;
       if(meta->second.data->second.count==0){
         delete meta->second.data;
         allocs_metadata.erase(meta);
@@ -5,6 +5,8 @@
 
 #include "smpi_comm.hpp"
 #include "simgrid/host.h"
+#include "simgrid/kernel/routing/NetPoint.hpp"
+#include "simgrid/kernel/routing/NetZoneImpl.hpp"
 #include "smpi_coll.hpp"
 #include "smpi_datatype.hpp"
 #include "smpi_info.hpp"
@@ -14,6 +16,7 @@
 #include "src/surf/HostImpl.hpp"
 
 #include <limits>
+#include <map>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_comm, smpi, "Logging specific to SMPI (comm)");
 
@@ -37,6 +40,8 @@ namespace simgrid::smpi {
 
 std::unordered_map<int, smpi_key_elem> Comm::keyvals_;
 int Comm::keyval_id_=0;
+/* Context id of the next communicator, so that the messages of different communicators do not match */
+static int global_id_ = 0;
 
 Comm::Comm(MPI_Group group, MPI_Topology topo, bool smp, int in_id)
     : group_(group), topo_(topo), is_smp_comm_(smp), id_(in_id)
@@ -48,7 +53,6 @@ Comm::Comm(MPI_Group group, MPI_Topology topo, bool smp, int in_id)
     group->c2f();
     int id;
     if(this->rank()==0){
-      static int global_id_ = 0;
       id=global_id_;
       global_id_++;
     }
@@ -341,6 +345,13 @@ void Comm::cleanup_smp(){
     Comm::unref(leaders_comm_);
   xbt_free(non_uniform_map_);
   delete[] leaders_map_;
+  for (auto const& comms : topo_comms_)
+    for (auto const& comm : comms)
+      if (comm != MPI_COMM_NULL)
+        Comm::unref(comm);
+  for (auto const& comm : topo_leaders_comms_)
+    if (comm != MPI_COMM_NULL)
+      Comm::unref(comm);
 }
 
 void Comm::unref(Comm* comm){
@@ -520,6 +531,161 @@ void Comm::init_smp(){
     smpi_process()->set_replaying(true);
 }
 
+/* Location of a host in the platform: for each netzone from the root to the one of the host, the location of the next
+ * component in that netzone (see NetZoneImpl::get_location) followed by its id. */
+static std::vector<unsigned long> get_host_location(const s4u::Host* host)
+{
+  std::vector<unsigned long> location;
+  const kernel::routing::NetPoint* elm = host->get_netpoint();
+  for (const auto* zone = elm->get_englobing_zone(); zone != nullptr; zone = zone->get_parent()) {
+    std::vector<unsigned long> local = zone->get_location(elm);
+    local.push_back(elm->id());
+    location.insert(location.begin(), local.begin(), local.end());
+    elm = zone->get_netpoint();
+  }
+  return location;
+}
+
+/* Builds the communicators following the netzone hierarchy. Two ranks belong to the same domain of level l when the
+ * first l items of the locations of their hosts are equal, the ranks of a same host forming the innermost domains. The
+ * communicator of level l gathers the leaders (lowest rank) of the domains of level l+1 that are in the same domain of
+ * level l. The levels that do not split any domain are skipped.
+ *
+ * The first rank calling it builds the communicators of all ranks, which are then shared by the members of each
+ * domain. Everything is computed from the locations of the hosts. For MPI_COMM_WORLD, that is shared by all processes,
+ * this is done without any communication nor simcall, so no other rank runs in the meantime. The other communicators
+ * (obtained with dup or split) are distinct objects on each rank, which all build their own copy of the communicators:
+ * their context ids are then agreed upon with a broadcast on this communicator, so init_topo() is collective for them.
+ */
+void Comm::init_topo()
+{
+  if (this == MPI_COMM_UNINITIALIZED) {
+    smpi_process()->comm_world()->init_topo();
+    return;
+  }
+  if (topo_initialized_)
+    return;
+  int comm_size = this->size();
+
+  std::vector<std::vector<unsigned long>> locations(comm_size);
+  std::unordered_map<const s4u::Host*, std::vector<unsigned long>> host_locations;
+  size_t depth = 0;
+  for (int i = 0; i < comm_size; i++) {
+    const s4u::Host* host = s4u::Actor::by_pid(group_->actor(i))->get_host();
+    auto known            = host_locations.find(host);
+    if (known == host_locations.end())
+      known = host_locations.try_emplace(host, get_host_location(host)).first;
+    locations[i] = known->second;
+    depth        = std::max(depth, locations[i].size());
+  }
+  // Hosts may be at different depths of the hierarchy, but their locations then differ before the end of the shortest
+  for (auto& location : locations)
+    location.resize(depth, std::numeric_limits<unsigned long>::max());
+
+  // leaders[l][i] is the leader of the domain of level l containing i. The domains of the last level are singletons.
+  std::vector<std::vector<int>> leaders(depth + 2, std::vector<int>(comm_size));
+  for (size_t l = 0; l <= depth; l++) {
+    std::map<std::vector<unsigned long>, int> domain_leaders;
+    for (int i = 0; i < comm_size; i++) {
+      std::vector<unsigned long> prefix(locations[i].begin(), locations[i].begin() + l);
+      leaders[l][i] = domain_leaders.try_emplace(prefix, i).first->second;
+    }
+  }
+  for (int i = 0; i < comm_size; i++)
+    leaders[depth + 1][i] = i;
+
+  /* These communicators are only used by the topo collectives. As they are built in one go instead of collectively,
+   * their context ids are given once all of them are created. */
+  std::vector<MPI_Comm> created;
+  auto create_comm = [this, &created](const std::vector<int>& ranks) {
+    auto* group = new Group(static_cast<int>(ranks.size()));
+    for (size_t i = 0; i < ranks.size(); i++)
+      group->set_mapping(group_->actor(ranks[i]), static_cast<int>(i));
+    auto* comm = new Comm(group, nullptr, true, MPI_UNDEFINED);
+    for (size_t i = 1; i < ranks.size(); i++) // one reference per member, released by cleanup_smp()
+      comm->ref();
+    created.push_back(comm);
+    return comm;
+  };
+  // Groups the ranks satisfying is_member() by their leader in domain_leaders
+  auto build_domains = [comm_size](const std::vector<int>& domain_leaders, auto is_member) {
+    std::map<int, std::vector<int>> domains;
+    for (int i = 0; i < comm_size; i++)
+      if (is_member(i))
+        domains[domain_leaders[i]].push_back(i);
+    return domains;
+  };
+
+  topo_comms_.assign(comm_size, std::vector<MPI_Comm>());
+  topo_leaders_comms_.assign(comm_size, MPI_COMM_NULL);
+  size_t innermost = 0;
+  for (size_t l = 0; l <= depth; l++) {
+    if (leaders[l] == leaders[l + 1])
+      continue;
+    innermost = l;
+    for (auto& comms : topo_comms_)
+      comms.push_back(MPI_COMM_NULL);
+    const std::vector<int>& sub_leaders = leaders[l + 1];
+    for (auto const& [_, members] : build_domains(leaders[l], [&sub_leaders](int i) { return sub_leaders[i] == i; })) {
+      MPI_Comm comm = create_comm(members);
+      for (int member : members)
+        topo_comms_[member].back() = comm;
+    }
+  }
+
+  topo_leaders_map_ = leaders[innermost];
+  if (not topo_comms_[0].empty()) {
+    std::vector<int> members;
+    for (int i = 0; i < comm_size; i++)
+      if (leaders[innermost][i] == i)
+        members.push_back(i);
+    MPI_Comm comm = create_comm(members);
+    for (int member : members)
+      topo_leaders_comms_[member] = comm;
+  }
+
+  // Reserve a block of context ids before any other communicator can take one
+  int first_id = global_id_;
+  if (this != smpi_process()->comm_world()) {
+    if (rank() == 0)
+      global_id_ += static_cast<int>(created.size());
+    // the id must be copied even when replaying, as in init_smp()
+    bool replaying = smpi_process()->replaying();
+    smpi_process()->set_replaying(false);
+    bcast__binomial_tree(&first_id, 1, MPI_INT, 0, this);
+    smpi_process()->set_replaying(replaying);
+  } else {
+    global_id_ += static_cast<int>(created.size());
+  }
+  for (size_t i = 0; i < created.size(); i++)
+    created[i]->id_ = first_id + static_cast<int>(i);
+  topo_initialized_ = true;
+}
+
+const std::vector<MPI_Comm>& Comm::get_topo_comms()
+{
+  if (this == MPI_COMM_UNINITIALIZED)
+    return smpi_process()->comm_world()->get_topo_comms();
+  init_topo();
+  return topo_comms_[rank()];
+}
+
+MPI_Comm Comm::get_topo_leaders_comm()
+{
+  if (this == MPI_COMM_UNINITIALIZED)
+    return smpi_process()->comm_world()->get_topo_leaders_comm();
+  get_topo_comms();
+  return topo_leaders_comms_[rank()];
+}
+
+const std::vector<int>& Comm::get_topo_leaders_map()
+{
+  if (this == MPI_COMM_UNINITIALIZED)
+    return smpi_process()->comm_world()->get_topo_leaders_map();
+  get_topo_comms();
+  return topo_leaders_map_;
+}
+
 MPI_Comm Comm::f2c(int id) {
   if(id == -2) {
     return MPI_COMM_SELF;
@@ -625,28 +791,24 @@ MPI_Comm Comm::split_type(int type, int /*key*/, const Info*)
   }
 }
 
-static inline std::string hash_message(int src, int dst, int tag){
-  return std::to_string(tag) + '_' + std::to_string(src) + '_' + std::to_string(dst);
-}
-
 unsigned int Comm::get_sent_messages_count(int src, int dst, int tag)
 {
-  return sent_messages_[hash_message(src, dst, tag)];
+  return sent_messages_[{src, dst, tag}];
 }
 
 void Comm::increment_sent_messages_count(int src, int dst, int tag)
 {
-  sent_messages_[hash_message(src, dst, tag)]++;
+  sent_messages_[{src, dst, tag}]++;
 }
 
 unsigned int Comm::get_received_messages_count(int src, int dst, int tag)
 {
-  return recv_messages_[hash_message(src, dst, tag)];
+  return recv_messages_[{src, dst, tag}];
 }
 
 void Comm::increment_received_messages_count(int src, int dst, int tag)
 {
-  recv_messages_[hash_message(src, dst, tag)]++;
+  recv_messages_[{src, dst, tag}]++;
 }
 
 unsigned int Comm::get_collectives_count()
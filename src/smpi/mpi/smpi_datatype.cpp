@@ -235,6 +235,13 @@ void Datatype::unref(MPI_Datatype datatype)
 void Datatype::commit()
 {
   flags_ |= DT_FLAG_COMMITED;
+  /* Flatten the layout of one element once for all, serialize() and unserialize() repeat it for each element */
+  if ((flags_ & DT_FLAG_DERIVED) && not plan_built_) {
+    flatten(plan_, 0, 1);
+    plan_.shrink_to_fit();
+    plan_built_ = true;
+    XBT_DEBUG("Flattened %s into %zu steps", name().c_str(), plan_.size());
+  }
 }
 
 bool Datatype::is_valid() const
@@ -376,20 +383,152 @@ int Datatype::copy(const void* sendbuf, int sendcount, MPI_Datatype sendtype, vo
   return sendcount > recvcount ? MPI_ERR_TRUNCATE : MPI_SUCCESS;
 }
 
-//Default serialization method : memcpy.
+/* Copy count blocks of size bytes located stride bytes apart to a contiguous buffer (pack) or the opposite (unpack).
+ * The common block sizes are instantiated separately, so that the memcpy of each block gets inlined. */
+template <size_t Size>
+static void pack_blocks(char* contiguous, const char* noncontiguous, size_t size, MPI_Aint stride, int count)
+{
+  const size_t len = Size != 0 ? Size : size;
+  for (int i = 0; i < count; i++) {
+    memcpy(contiguous, noncontiguous, len);
+    contiguous += len;
+    noncontiguous += stride;
+  }
+}
+
+template <size_t Size>
+static void unpack_blocks(const char* contiguous, char* noncontiguous, size_t size, MPI_Aint stride, int count)
+{
+  const size_t len = Size != 0 ? Size : size;
+  for (int i = 0; i < count; i++) {
+    memcpy(noncontiguous, contiguous, len);
+    contiguous += len;
+    noncontiguous += stride;
+  }
+}
+
+#define DISPATCH_BLOCK_SIZE(kernel, size, ...)                                                                         \
+  switch (size) {                                                                                                      \
+    case 4:                                                                                                            \
+      kernel<4>(__VA_ARGS__);                                                                                          \
+      break;                                                                                                           \
+    case 8:                                                                                                            \
+      kernel<8>(__VA_ARGS__);                                                                                          \
+      break;                                                                                                           \
+    case 16:                                                                                                           \
+      kernel<16>(__VA_ARGS__);                                                                                         \
+      break;                                                                                                           \
+    case 32:                                                                                                           \
+      kernel<32>(__VA_ARGS__);                                                                                         \
+      break;                                                                                                           \
+    default:                                                                                                           \
+      kernel<0>(__VA_ARGS__);                                                                                          \
+  }
+
+void Datatype::add_to_plan(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int block_length,
+                           MPI_Datatype type)
+{
+  if (block_length == 0 || type->size() == 0)
+    return;
+  if (not plan.empty() && plan.back().type == type) {
+    Datatype_plan_step& last = plan.back();
+    // right after the previous block: make it longer
+    if (last.block_count == 1 && offset == last.offset + static_cast<MPI_Aint>(last.block_length * type->size())) {
+      last.block_length += block_length;
+      return;
+    }
+    // same length as the previous blocks: try to extend the strided sequence
+    if (last.block_length == block_length) {
+      if (last.block_count == 1) {
+        last.block_stride = offset - last.offset;
+        last.block_count  = 2;
+        return;
+      }
+      if (offset == last.offset + last.block_count * last.block_stride) {
+        last.block_count++;
+        return;
+      }
+    }
+  }
+  plan.push_back({offset, 0, 1, block_length, type});
+}
+
+// Default flattening: one contiguous block
+void Datatype::flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count)
+{
+  add_to_plan(plan, offset + lb_, count, this);
+}
+
+/* The plan of the uncommitted types (used internally) is built in the scratch vector on each use */
+const std::vector<Datatype_plan_step>& Datatype::get_plan(std::vector<Datatype_plan_step>& scratch)
+{
+  if (plan_built_)
+    return plan_;
+  flatten(scratch, 0, 1);
+  return scratch;
+}
+
 void Datatype::serialize(const void* noncontiguous_buf, void* contiguous_buf, int count)
 {
   auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
-  const auto* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf) + lb_;
-  memcpy(contiguous_buf_char, noncontiguous_buf_char, count*size_);
+  const auto* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf);
+  if (not(flags_ & DT_FLAG_DERIVED)) { // Default serialization method : memcpy.
+    memcpy(contiguous_buf_char, noncontiguous_buf_char + lb_, count * size_);
+    return;
+  }
+
+  std::vector<Datatype_plan_step> scratch;
+  const std::vector<Datatype_plan_step>& plan = get_plan(scratch);
+  for (int i = 0; i < count; i++) {
+    const char* element = noncontiguous_buf_char + i * get_extent();
+    for (auto const& step : plan) {
+      size_t size = step.block_length * step.type->size();
+      if (step.block_count == 1)
+        memcpy(contiguous_buf_char, element + step.offset, size);
+      else
+        DISPATCH_BLOCK_SIZE(pack_blocks, size, contiguous_buf_char, element + step.offset, size, step.block_stride,
+                            step.block_count)
+      contiguous_buf_char += size * step.block_count;
+    }
+  }
 }
 
 void Datatype::unserialize(const void* contiguous_buf, void *noncontiguous_buf, int count, MPI_Op op){
   const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf) + lb_;
-  int n=count;
-  if(op!=MPI_OP_NULL)
-    op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, this);
+  auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf);
+  if (op == MPI_OP_NULL)
+    return;
+  if (not(flags_ & DT_FLAG_DERIVED)) {
+    int n = count;
+    op->apply(contiguous_buf_char, noncontiguous_buf_char + lb_, &n, this);
+    return;
+  }
+
+  /* Replacing the data is the common case: copy the blocks directly instead of applying the operation to each of
+   * them. Do what Op::apply would do beforehand. */
+  bool replace = (op == MPI_REPLACE);
+  if (replace) {
+    smpi_switch_data_segment(simgrid::s4u::Actor::self());
+    if (smpi_process()->replaying())
+      return;
+  }
+  std::vector<Datatype_plan_step> scratch;
+  const std::vector<Datatype_plan_step>& plan = get_plan(scratch);
+  for (int e = 0; e < count; e++) {
+    char* element = noncontiguous_buf_char + e * get_extent();
+    for (auto const& step : plan) {
+      size_t size = step.block_length * step.type->size();
+      if (replace) {
+        DISPATCH_BLOCK_SIZE(unpack_blocks, size, contiguous_buf_char, element + step.offset, size, step.block_stride,
+                            step.block_count)
+      } else {
+        for (int i = 0; i < step.block_count; i++)
+          op->apply(contiguous_buf_char + i * size, element + step.offset + i * step.block_stride,
+                    &step.block_length, step.type);
+      }
+      contiguous_buf_char += size * step.block_count;
+    }
+  }
 }
 
 int Datatype::create_contiguous(int count, MPI_Datatype old_type, MPI_Aint lb, MPI_Datatype* new_type){
@@ -5,11 +5,9 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "smpi_datatype_derived.hpp"
-#include "smpi_op.hpp"
 #include <xbt/log.h>
 
 #include <array>
-#include <cstring>
 
 namespace simgrid::smpi {
 
@@ -49,20 +47,9 @@ int Type_Contiguous::clone(MPI_Datatype* type)
   return MPI_SUCCESS;
 }
 
-void Type_Contiguous::serialize(const void* noncontiguous_buf, void* contiguous_buf, int count)
+void Type_Contiguous::flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count)
 {
-  auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
-  const auto* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf) + lb();
-  memcpy(contiguous_buf_char, noncontiguous_buf_char, old_type_->size() * count * block_count_);
-}
-
-void Type_Contiguous::unserialize(const void* contiguous_buf, void* noncontiguous_buf, int count, MPI_Op op)
-{
-  const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf) + lb();
-  int n= count*block_count_;
-  if(op!=MPI_OP_NULL)
-    op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, old_type_);
+  add_to_plan(plan, offset + lb(), count * block_count_, old_type_);
 }
 
 Type_Hvector::Type_Hvector(int size,MPI_Aint lb, MPI_Aint ub, int flags, int count, int block_length, MPI_Aint stride, MPI_Datatype old_type): Datatype(size, lb, ub, flags), block_count_(count), block_length_(block_length), block_stride_(stride), old_type_(old_type){
@@ -81,41 +68,18 @@ int Type_Hvector::clone(MPI_Datatype* type)
   return MPI_SUCCESS;
 }
 
-void Type_Hvector::serialize(const void* noncontiguous_buf, void *contiguous_buf,
-                    int count){
-  auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
-  const auto* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf);
-
+void Type_Hvector::flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count)
+{
   for (int i = 0; i < block_count_ * count; i++) {
     if (not(old_type_->flags() & DT_FLAG_DERIVED))
-      memcpy(contiguous_buf_char, noncontiguous_buf_char, block_length_ * old_type_->size());
+      add_to_plan(plan, offset, block_length_, old_type_);
     else
-      old_type_->serialize( noncontiguous_buf_char, contiguous_buf_char, block_length_);
+      old_type_->flatten(plan, offset, block_length_);
 
-    contiguous_buf_char += block_length_*old_type_->size();
-    if((i+1)%block_count_ ==0)
-      noncontiguous_buf_char += block_length_*old_type_->size();
+    if ((i + 1) % block_count_ == 0)
+      offset += block_length_ * old_type_->size();
     else
-      noncontiguous_buf_char += block_stride_;
-  }
-}
-
-void Type_Hvector::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
-                              int count, MPI_Op op){
-  const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf);
-
-  for (int i = 0; i < block_count_ * count; i++) {
-    if (not(old_type_->flags() & DT_FLAG_DERIVED)) {
-      if(op!=MPI_OP_NULL)
-        op->apply( contiguous_buf_char, noncontiguous_buf_char, &block_length_, old_type_);
-    }else
-      old_type_->unserialize( contiguous_buf_char, noncontiguous_buf_char, block_length_, op);
-    contiguous_buf_char += block_length_*old_type_->size();
-    if((i+1)%block_count_ ==0)
-      noncontiguous_buf_char += block_length_*old_type_->size();
-    else
-      noncontiguous_buf_char += block_stride_;
+      offset += block_stride_;
   }
 }
 
@@ -185,48 +149,24 @@ Type_Hindexed::~Type_Hindexed()
   }
 }
 
-void Type_Hindexed::serialize(const void* noncontiguous_buf, void *contiguous_buf,
-                int count){
-  auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
-  const auto* noncontiguous_buf_iter = static_cast<const char*>(noncontiguous_buf);
-  const auto* noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[0];
+void Type_Hindexed::flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count)
+{
+  if (block_count_ == 0)
+    return;
+  MPI_Aint block_offset = offset + block_indices_[0];
   for (int j = 0; j < count; j++) {
     for (int i = 0; i < block_count_; i++) {
       if (not(old_type_->flags() & DT_FLAG_DERIVED))
-        memcpy(contiguous_buf_char, noncontiguous_buf_char, block_lengths_[i] * old_type_->size());
+        add_to_plan(plan, block_offset, block_lengths_[i], old_type_);
       else
-        old_type_->serialize(noncontiguous_buf_char, contiguous_buf_char,block_lengths_[i]);
-
-      contiguous_buf_char += block_lengths_[i]*old_type_->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[i+1];
-      else
-        noncontiguous_buf_char += block_lengths_[i]*old_type_->get_extent();
-    }
-    noncontiguous_buf_iter=noncontiguous_buf_char;
-  }
-}
-
-void Type_Hindexed::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
-                          int count, MPI_Op op){
-  const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf) + block_indices_[0];
-  for (int j = 0; j < count; j++) {
-    for (int i = 0; i < block_count_; i++) {
-      if (not(old_type_->flags() & DT_FLAG_DERIVED)) {
-        if(op!=MPI_OP_NULL)
-          op->apply( contiguous_buf_char, noncontiguous_buf_char, &block_lengths_[i],
-                            old_type_);
-      }else
-        old_type_->unserialize( contiguous_buf_char,noncontiguous_buf_char,block_lengths_[i], op);
+        old_type_->flatten(plan, block_offset, block_lengths_[i]);
 
-      contiguous_buf_char += block_lengths_[i]*old_type_->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf) + block_indices_[i+1];
+      if (i < block_count_ - 1)
+        block_offset = offset + block_indices_[i + 1];
       else
-        noncontiguous_buf_char += block_lengths_[i]*old_type_->get_extent();
+        block_offset += block_lengths_[i] * old_type_->get_extent();
     }
-    noncontiguous_buf=static_cast<void*>(noncontiguous_buf_char);
+    offset = block_offset;
   }
 }
 
@@ -289,48 +229,24 @@ int Type_Struct::clone(MPI_Datatype* type)
   return MPI_SUCCESS;
 }
 
-void Type_Struct::serialize(const void* noncontiguous_buf, void *contiguous_buf,
-                        int count){
-  auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
-  const auto* noncontiguous_buf_iter = static_cast<const char*>(noncontiguous_buf);
-  const auto* noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[0];
+void Type_Struct::flatten(std::vector<Datatype_plan_step>& plan, MPI_Aint offset, int count)
+{
+  if (block_count_ == 0)
+    return;
+  MPI_Aint block_offset = offset + block_indices_[0];
   for (int j = 0; j < count; j++) {
     for (int i = 0; i < block_count_; i++) {
       if (not(old_types_[i]->flags() & DT_FLAG_DERIVED))
-        memcpy(contiguous_buf_char, noncontiguous_buf_char, block_lengths_[i] * old_types_[i]->size());
+        add_to_plan(plan, block_offset, block_lengths_[i], old_types_[i]);
       else
-        old_types_[i]->serialize( noncontiguous_buf_char,contiguous_buf_char,block_lengths_[i]);
+        old_types_[i]->flatten(plan, block_offset, block_lengths_[i]);
 
-
-      contiguous_buf_char += block_lengths_[i]*old_types_[i]->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[i+1];
-      else //let's hope this is MPI_UB ?
-        noncontiguous_buf_char += block_lengths_[i]*old_types_[i]->get_extent();
-    }
-    noncontiguous_buf_iter=noncontiguous_buf_char;
-  }
-}
-
-void Type_Struct::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
-                              int count, MPI_Op op){
-  const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf) + block_indices_[0];
-  for (int j = 0; j < count; j++) {
-    for (int i = 0; i < block_count_; i++) {
-      if (not(old_types_[i]->flags() & DT_FLAG_DERIVED)) {
-        if(op!=MPI_OP_NULL)
-          op->apply( contiguous_buf_char, noncontiguous_buf_char, &block_lengths_[i], old_types_[i]);
-      }else
-        old_types_[i]->unserialize( contiguous_buf_char, noncontiguous_buf_char,block_lengths_[i], op);
-
-      contiguous_buf_char += block_lengths_[i]*old_types_[i]->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char =  static_cast<char*>(noncontiguous_buf) + block_indices_[i+1];
-      else
-        noncontiguous_buf_char += block_lengths_[i]*old_types_[i]->get_extent();
+      if (i < block_count_ - 1)
+        block_offset = offset + block_indices_[i + 1];
+      else // let's hope this is MPI_UB ?
+        block_offset += block_lengths_[i] * old_types_[i]->get_extent();
     }
-    noncontiguous_buf=static_cast<void*>(noncontiguous_buf_char);
+    offset = block_offset;
   }
 }
 
@@ -37,14 +37,56 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_op, smpi, "Logging specific to SMPI (op)");
 
 #define APPLY_FUNC(a, b, length, type, func) \
 {                                          \
-  int i;                                   \
+  int n   = *(length);                     \
   type* x = (type*)(a);                    \
   type* y = (type*)(b);                    \
-  for(i = 0; i < *(length); i++) {         \
+  for (int i = 0; i < n; i++) {            \
     func(x[i], y[i]);                      \
   }                                        \
 }
 
+/* Kernels for the most common reductions on contiguous buffers. They are compiled for several instruction sets when
+ * the toolchain allows it, and the best version for the host CPU is selected when the library gets loaded. */
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define SMPI_OP_KERNEL_ATTRS __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef SMPI_OP_KERNEL_ATTRS
+#define SMPI_OP_KERNEL_ATTRS
+#endif
+
+#define DEFINE_OP_KERNEL(name, type, func)                                                                             \
+  SMPI_OP_KERNEL_ATTRS static void name(const type* x, type* y, int n)                                                 \
+  {                                                                                                                    \
+    for (int i = 0; i < n; i++)                                                                                        \
+      func(x[i], y[i]);                                                                                                \
+  }
+
+#define DEFINE_ARITH_KERNELS(suffix, type)                                                                             \
+  DEFINE_OP_KERNEL(max_##suffix, type, MAX_OP)                                                                         \
+  DEFINE_OP_KERNEL(min_##suffix, type, MIN_OP)                                                                         \
+  DEFINE_OP_KERNEL(sum_##suffix, type, SUM_OP)                                                                         \
+  DEFINE_OP_KERNEL(prod_##suffix, type, PROD_OP)
+
+#define DEFINE_BITWISE_KERNELS(suffix, type)                                                                           \
+  DEFINE_OP_KERNEL(band_##suffix, type, BAND_OP)                                                                       \
+  DEFINE_OP_KERNEL(bor_##suffix, type, BOR_OP)                                                                         \
+  DEFINE_OP_KERNEL(bxor_##suffix, type, BXOR_OP)
+
+DEFINE_ARITH_KERNELS(float, float)
+DEFINE_ARITH_KERNELS(double, double)
+DEFINE_ARITH_KERNELS(int, int)
+DEFINE_ARITH_KERNELS(long, long)
+DEFINE_ARITH_KERNELS(unsigned, unsigned int)
+DEFINE_ARITH_KERNELS(unsigned_long, unsigned long)
+DEFINE_BITWISE_KERNELS(int, int)
+DEFINE_BITWISE_KERNELS(long, long)
+DEFINE_BITWISE_KERNELS(unsigned, unsigned int)
+DEFINE_BITWISE_KERNELS(unsigned_long, unsigned long)
+DEFINE_BITWISE_KERNELS(byte, int8_t)
+DEFINE_BITWISE_KERNELS(unsigned_char, unsigned char)
+
 #define APPLY_BEGIN_OP_LOOP()                                                                                          \
   MPI_Datatype datatype_base = *datatype;                                                                              \
   while (datatype_base->duplicated_datatype() != MPI_DATATYPE_NULL)                                                    \
@@ -55,6 +97,27 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_op, smpi, "Logging specific to SMPI (op)");
     APPLY_FUNC(a, b, length, type, op)                                                                                 \
   } else
 
+#define APPLY_KERNEL(dtype, type, kernel)                                                                              \
+  if (datatype_base == (dtype)) {                                                                                      \
+    kernel(static_cast<const type*>(a), static_cast<type*>(b), *length);                                               \
+  } else
+
+#define APPLY_ARITH_KERNELS(op)                                                                                        \
+  APPLY_KERNEL(MPI_FLOAT, float, op##_float)                                                                           \
+  APPLY_KERNEL(MPI_DOUBLE, double, op##_double)                                                                        \
+  APPLY_KERNEL(MPI_INT, int, op##_int)                                                                                 \
+  APPLY_KERNEL(MPI_LONG, long, op##_long)                                                                              \
+  APPLY_KERNEL(MPI_UNSIGNED, unsigned int, op##_unsigned)                                                              \
+  APPLY_KERNEL(MPI_UNSIGNED_LONG, unsigned long, op##_unsigned_long)
+
+#define APPLY_BITWISE_KERNELS(op)                                                                                      \
+  APPLY_KERNEL(MPI_INT, int, op##_int)                                                                                 \
+  APPLY_KERNEL(MPI_LONG, long, op##_long)                                                                              \
+  APPLY_KERNEL(MPI_UNSIGNED, unsigned int, op##_unsigned)                                                              \
+  APPLY_KERNEL(MPI_UNSIGNED_LONG, unsigned long, op##_unsigned_long)                                                   \
+  APPLY_KERNEL(MPI_BYTE, int8_t, op##_byte)                                                                            \
+  APPLY_KERNEL(MPI_UNSIGNED_CHAR, unsigned char, op##_unsigned_char)
+
 #define APPLY_BASIC_OP_LOOP(op)\
 APPLY_OP_LOOP(MPI_CHAR, char,op)\
 APPLY_OP_LOOP(MPI_SHORT, short,op)\
@@ -127,6 +190,7 @@ APPLY_OP_LOOP(MPI_COMPLEX32, double_double,op)
 static void max_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
   APPLY_BEGIN_OP_LOOP()
+  APPLY_ARITH_KERNELS(max)
   APPLY_BASIC_OP_LOOP(MAX_OP)
   APPLY_FLOAT_OP_LOOP(MAX_OP)
   APPLY_END_OP_LOOP(MAX_OP)
@@ -135,6 +199,7 @@ static void max_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 static void min_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
   APPLY_BEGIN_OP_LOOP()
+  APPLY_ARITH_KERNELS(min)
   APPLY_BASIC_OP_LOOP(MIN_OP)
   APPLY_FLOAT_OP_LOOP(MIN_OP)
   APPLY_END_OP_LOOP(MIN_OP)
@@ -143,6 +208,7 @@ static void min_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 static void sum_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
   APPLY_BEGIN_OP_LOOP()
+  APPLY_ARITH_KERNELS(sum)
   APPLY_BASIC_OP_LOOP(SUM_OP)
   APPLY_FLOAT_OP_LOOP(SUM_OP)
   APPLY_COMPLEX_OP_LOOP(SUM_OP)
@@ -153,6 +219,7 @@ static void sum_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 static void prod_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
   APPLY_BEGIN_OP_LOOP()
+  APPLY_ARITH_KERNELS(prod)
   APPLY_BASIC_OP_LOOP(PROD_OP)
   APPLY_FLOAT_OP_LOOP(PROD_OP)
   APPLY_COMPLEX_OP_LOOP(PROD_OP)
@@ -190,6 +257,7 @@ static void lxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 static void band_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
   APPLY_BEGIN_OP_LOOP()
+  APPLY_BITWISE_KERNELS(band)
   APPLY_BASIC_OP_LOOP(BAND_OP)
   APPLY_BOOL_OP_LOOP(BAND_OP)
   APPLY_BYTE_OP_LOOP(BAND_OP)
@@ -199,6 +267,7 @@ static void band_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 static void bor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
   APPLY_BEGIN_OP_LOOP()
+  APPLY_BITWISE_KERNELS(bor)
   APPLY_BASIC_OP_LOOP(BOR_OP)
   APPLY_BOOL_OP_LOOP(BOR_OP)
   APPLY_BYTE_OP_LOOP(BOR_OP)
@@ -208,6 +277,7 @@ static void bor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 static void bxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
   APPLY_BEGIN_OP_LOOP()
+  APPLY_BITWISE_KERNELS(bxor)
   APPLY_BASIC_OP_LOOP(BXOR_OP)
   APPLY_BOOL_OP_LOOP(BXOR_OP)
   APPLY_BYTE_OP_LOOP(BXOR_OP)
@@ -21,6 +21,7 @@
 #include "src/kernel/actor/SimcallObserver.hpp"
 #include "src/mc/mc_replay.hpp"
 #include "src/smpi/include/smpi_actor.hpp"
+#include "xbt/mallocator.h"
 
 #include <algorithm>
 #include <array>
@@ -36,6 +37,44 @@ extern std::function<void(simgrid::kernel::activity::CommImpl*, void*, size_t)>
 
 namespace simgrid::smpi {
 
+/* A request is created and destroyed for every message, so recycle their memory.
+ * The pool is created by the first request, and again by the first one after free_pool() */
+static xbt_mallocator_t request_pool = nullptr;
+
+static void* request_block_new()
+{
+  return ::operator new(sizeof(Request));
+}
+static void request_block_free(void* block)
+{
+  ::operator delete(block);
+}
+
+void* Request::operator new(size_t size)
+{
+  if (size != sizeof(Request))
+    return ::operator new(size);
+  if (request_pool == nullptr)
+    request_pool = xbt_mallocator_new(1024, request_block_new, request_block_free, nullptr);
+  return xbt_mallocator_get(request_pool);
+}
+
+void Request::operator delete(void* ptr, size_t size)
+{
+  if (request_pool == nullptr || size != sizeof(Request))
+    ::operator delete(ptr);
+  else
+    xbt_mallocator_release(request_pool, ptr);
+}
+
+void Request::free_pool()
+{
+  if (request_pool != nullptr) {
+    xbt_mallocator_free(request_pool);
+    request_pool = nullptr;
+  }
+}
+
 Request::Request(const void* buf, int count, MPI_Datatype datatype, aid_t src, aid_t dst, int tag, MPI_Comm comm,
                  unsigned flags, MPI_Op op)
     : buf_(const_cast<void*>(buf))
@@ -186,15 +225,14 @@ bool Request::match_recv(void* a, void* b, simgrid::kernel::activity::CommImpl*)
   if (not match || ref->comm_ == MPI_COMM_UNINITIALIZED || ref->comm_->is_smp_comm())
     return match;
 
-  if (ref->comm_->get_received_messages_count(ref->comm_->group()->rank(req->src_),
-                                              ref->comm_->group()->rank(req->dst_), req->tag_) == req->message_id_) {
+  int src_rank                = ref->comm_->group()->rank(req->src_);
+  int dst_rank                = ref->comm_->group()->rank(req->dst_);
+  unsigned int received_count = ref->comm_->get_received_messages_count(src_rank, dst_rank, req->tag_);
+  if (received_count == req->message_id_) {
     if (((ref->flags_ & MPI_REQ_PROBE) == 0) && ((req->flags_ & MPI_REQ_PROBE) == 0)) {
       XBT_DEBUG("increasing count in comm %p, which was %u from pid %ld, to pid %ld with tag %d", ref->comm_,
-                ref->comm_->get_received_messages_count(ref->comm_->group()->rank(req->src_),
-                                                        ref->comm_->group()->rank(req->dst_), req->tag_),
-                req->src_, req->dst_, req->tag_);
-      ref->comm_->increment_received_messages_count(ref->comm_->group()->rank(req->src_),
-                                                    ref->comm_->group()->rank(req->dst_), req->tag_);
+                received_count, req->src_, req->dst_, req->tag_);
+      ref->comm_->increment_received_messages_count(src_rank, dst_rank, req->tag_);
       if (ref->real_size_ > req->real_size_) {
         ref->real_size_ = req->real_size_;
       }
@@ -205,10 +243,7 @@ bool Request::match_recv(void* a, void* b, simgrid::kernel::activity::CommImpl*)
     ref->detached_sender_ = nullptr;
     XBT_DEBUG("Refusing to match message, as its ID is not the one I expect. in comm %p, %u != %u, "
               "from pid %ld to pid %ld, with tag %d",
-              ref->comm_,
-              ref->comm_->get_received_messages_count(ref->comm_->group()->rank(req->src_),
-                                                      ref->comm_->group()->rank(req->dst_), req->tag_),
-              req->message_id_, req->src_, req->dst_, req->tag_);
+              ref->comm_, received_count, req->message_id_, req->src_, req->dst_, req->tag_);
   }
   return match;
 }
@@ -530,8 +565,10 @@ void Request::start()
       TRACE_smpi_send(src_, src_, dst_, tag_, size_);
     this->print_request("New send");
 
-    message_id_=comm_->get_sent_messages_count(comm_->group()->rank(src_), comm_->group()->rank(dst_), tag_);
-    comm_->increment_sent_messages_count(comm_->group()->rank(src_), comm_->group()->rank(dst_), tag_);
+    int src_rank = comm_->group()->rank(src_);
+    int dst_rank = comm_->group()->rank(dst_);
+    message_id_  = comm_->get_sent_messages_count(src_rank, dst_rank, tag_);
+    comm_->increment_sent_messages_count(src_rank, dst_rank, tag_);
 
     void* buf = buf_;
     if ((flags_ & MPI_REQ_SSEND) == 0 &&
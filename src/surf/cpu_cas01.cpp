@@ -195,12 +195,12 @@ void CpuCas01::set_factor_cb(const std::function<s4u::Host::CpuFactorCb>& cb)
 CpuCas01Action::CpuCas01Action(Model* model, double cost, bool failed, double speed, lmm::Constraint* constraint,
                                int requested_core)
     : CpuAction(model, cost, failed,
-                model->get_maxmin_system()->variable_new(this, 1.0 / requested_core, requested_core * speed, 1))
+                model->get_maxmin_system()->variable_new_with_elements(this, 1.0 / requested_core,
+                                                                       requested_core * speed, {{constraint, 1.0}}))
     , requested_core_(requested_core)
 {
   if (model->is_update_lazy())
     set_last_update();
-  model->get_maxmin_system()->expand(constraint, get_variable(), 1.0);
 }
 
 } // namespace simgrid::kernel::resource
@@ -115,7 +115,7 @@ double CpuTiProfile::integrate_simple_point(double a) const
 {
   double integral = 0;
   double a_aux    = a;
-  long ind        = binary_search(time_points_, a);
+  long ind        = cached_search(time_points_, a, time_cursor_);
   integral += integral_[ind];
 
   XBT_DEBUG("a %f ind %ld integral %f ind + 1 %f ind %f time +1 %f time %f", a, ind, integral, integral_[ind + 1],
@@ -183,6 +183,58 @@ double CpuTiTmgr::solve(double a, double amount) const
   return last_time_ * floor(a / last_time_) + (quotient * last_time_) + reduced_b;
 }
 
+/**
+ * @brief Computes the time needed to execute several amounts on cpu, all starting at the same date.
+ *
+ * This gives the same results as solve() on each amount, but the integrals that only depend on the initial date are
+ * computed once. When the amounts are sorted by increasing value, the successive searches in the profile only go
+ * forward from the previous one, which makes each of them O(1) in most cases.
+ *
+ * @param a        Initial time
+ * @param amounts  Amounts to be executed, replaced by the corresponding end times
+ */
+void CpuTiTmgr::solve_sorted(double a, std::vector<double>& amounts) const
+{
+  if ((a < 0.0) && (a > -EPSILON))
+    a = 0.0;
+  xbt_assert(a >= 0.0, "Error, invalid date %.2f.", a);
+
+  double base_time       = 0.0;
+  double reduced_a       = 0.0;
+  double amount_till_end = 0.0;
+  double integral_a      = 0.0;
+  double integral_0      = 0.0;
+  if (type_ == Type::DYNAMIC) {
+    base_time       = last_time_ * floor(a / last_time_);
+    reduced_a       = a - last_time_ * static_cast<int>(floor(a / last_time_));
+    amount_till_end = integrate(reduced_a, last_time_);
+    integral_a      = profile_->integrate_simple_point(reduced_a);
+    integral_0      = profile_->integrate_simple_point(0.0);
+  }
+
+  for (double& amount : amounts) {
+    if ((amount < 0.0) && (amount > -EPSILON))
+      amount = 0.0;
+    xbt_assert(amount >= 0.0,
+               "Error, invalid amount %.2f. You probably have a task executing with negative computation amount. "
+               "Check your code.",
+               amount);
+
+    if (amount < EPSILON) {
+      amount = a;
+    } else if (type_ == Type::FIXED) {
+      amount = a + (amount / value_);
+    } else {
+      double quotient       = floor(amount / total_);
+      double reduced_amount = total_ * ((amount / total_) - floor(amount / total_));
+      double reduced_b      = amount_till_end > reduced_amount
+                                  ? profile_->solve_integral(integral_a + reduced_amount)
+                                  : last_time_ + profile_->solve_integral(integral_0 + (reduced_amount - amount_till_end));
+      amount = base_time + (quotient * last_time_) + reduced_b;
+    }
+  }
+}
+
 /**
  * @brief Auxiliary function to solve integral.
  *  It returns the date when the requested amount of flops is available
@@ -192,10 +244,19 @@ double CpuTiTmgr::solve(double a, double amount) const
  */
 double CpuTiProfile::solve_simple(double a, double amount) const
 {
-  double integral_a = integrate_simple_point(a);
-  long ind          = binary_search(integral_, integral_a + amount);
-  double time       = time_points_[ind];
-  time += (integral_a + amount - integral_[ind]) /
+  return solve_integral(integrate_simple_point(a) + amount);
+}
+
+/**
+ * @brief Auxiliary function to solve integral.
+ *  It returns the date at which the integral of the profile since its beginning reaches the given value
+ * @param integral  Value of the integral
+ */
+double CpuTiProfile::solve_integral(double integral) const
+{
+  long ind    = cached_search(integral_, integral, integral_cursor_);
+  double time = time_points_[ind];
+  time += (integral - integral_[ind]) /
           ((integral_[ind + 1] - integral_[ind]) / (time_points_[ind + 1] - time_points_[ind]));
 
   return time;
@@ -236,6 +297,9 @@ CpuTiTmgr::CpuTiTmgr(kernel::profile::Profile* speed_profile, double value) : sp
   }
 
   xbt_assert(speed_profile->is_repeating());
+  xbt_assert(not speed_profile->is_streamed(),
+             "The CPU TI model needs the whole profile %s in memory: it cannot be streamed",
+             speed_profile->get_name().c_str());
 
   /* only one point available, fixed trace */
   if (speed_profile->get_event_list().size() == 1) {
@@ -272,6 +336,28 @@ long CpuTiProfile::binary_search(const std::vector<double>& array, double a)
   return std::distance(begin(array), pos) - 1;
 }
 
+/**
+ * @brief Same as binary_search(), but first looks at the few intervals following the one found by the previous search.
+ * @param array    Array
+ * @param a        Value to search
+ * @param cursor   Index returned by the previous search in that array, updated with the new one
+ * @return Index of point
+ */
+long CpuTiProfile::cached_search(const std::vector<double>& array, double a, long& cursor)
+{
+  constexpr int MAX_STEPS = 4;
+  auto last               = static_cast<long>(array.size()) - 1;
+  if (array[cursor] <= a) {
+    for (int step = 0; step < MAX_STEPS; step++) {
+      if (cursor == last || a < array[cursor + 1])
+        return cursor;
+      cursor++;
+    }
+  }
+  cursor = binary_search(array, a);
+  return cursor;
+}
+
 /*********
  * Model *
  *********/
@@ -420,6 +506,25 @@ void CpuTi::update_actions_finish_time(double now)
     sum_priority_ += 1.0 / action.get_sharing_penalty();
   }
 
+  /* Compute the finish times of all running actions in one sweep over the profile, by increasing amount of work */
+  running_actions_.clear();
+  for (CpuTiAction& action : action_set_) {
+    if (action.get_state_set() == get_model()->get_started_action_set() && action.is_running() &&
+        action.get_sharing_penalty() > 0) {
+      /* total area needed to finish the action. Used in trace integration */
+      double total_area = (action.get_remains() * sum_priority_ * action.get_sharing_penalty()) / speed_.peak;
+      running_actions_.emplace_back(total_area, &action);
+    }
+  }
+  std::sort(running_actions_.begin(), running_actions_.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  areas_.clear();
+  for (auto const& [area, _] : running_actions_)
+    areas_.push_back(area);
+  speed_integrated_trace_->solve_sorted(now, areas_);
+  for (size_t i = 0; i < running_actions_.size(); i++)
+    running_actions_[i].second->set_finish_time(areas_[i]);
+
   for (CpuTiAction& action : action_set_) {
     double min_finish = NO_MAX_DURATION;
     /* action not running, skip it */
@@ -428,10 +533,6 @@ void CpuTi::update_actions_finish_time(double now)
 
     /* verify if the action is really running on cpu */
     if (action.is_running() && action.get_sharing_penalty() > 0) {
-      /* total area needed to finish the action. Used in trace integration */
-      double total_area = (action.get_remains() * sum_priority_ * action.get_sharing_penalty()) / speed_.peak;
-
-      action.set_finish_time(speed_integrated_trace_->solve(now, total_area));
       /* verify which event will happen before (max_duration or finish time) */
       if (action.get_max_duration() != NO_MAX_DURATION &&
           action.get_start_time() + action.get_max_duration() < action.get_finish_time())
@@ -26,6 +26,10 @@ class XBT_PRIVATE CpuTiAction;
 class CpuTiProfile {
   std::vector<double> time_points_;
   std::vector<double> integral_;
+  /* Segments found by the last lookups. Successive lookups are usually close to each other (the dates only go
+   * forward), so they are first searched from there before falling back to a binary search. */
+  mutable long time_cursor_     = 0;
+  mutable long integral_cursor_ = 0;
 
 public:
   explicit CpuTiProfile(const profile::Profile* profile);
@@ -35,8 +39,10 @@ public:
   double integrate_simple(double a, double b) const;
   double integrate_simple_point(double a) const;
   double solve_simple(double a, double amount) const;
+  double solve_integral(double integral) const;
 
   static long binary_search(const std::vector<double>& array, double a);
+  static long cached_search(const std::vector<double>& array, double a, long& cursor);
 };
 
 class CpuTiTmgr {
@@ -62,6 +68,7 @@ public:
 
   double integrate(double a, double b) const;
   double solve(double a, double amount) const;
+  void solve_sorted(double a, std::vector<double>& amounts) const;
   double get_power_scale(double a) const;
 };
 
@@ -125,6 +132,9 @@ public:
   ActionTiList action_set_;                     /*< set with all actions running on cpu */
   double sum_priority_ = 0;                  /*< the sum of actions' priority that are running on cpu */
   double last_update_  = 0;                  /*< last update of actions' remaining amount done */
+  /* Scratch buffers of update_actions_finish_time(), kept to avoid reallocating them at each update */
+  std::vector<std::pair<double, CpuTiAction*>> running_actions_;
+  std::vector<double> areas_;
 
   boost::intrusive::list_member_hook<> cpu_ti_hook;
 };
@@ -105,6 +105,9 @@ void surf_network_model_init_SMPI()
 
 namespace simgrid::kernel::resource {
 
+/* Amount of host pairs for which the setup of the communications is cached */
+static constexpr size_t MAX_COMM_SETUPS = 1 << 16;
+
 NetworkCm02Model::NetworkCm02Model(const std::string& name) : NetworkModel(name)
 {
   std::string optim = config::get_value<std::string>("network/optim");
@@ -123,6 +126,12 @@ NetworkCm02Model::NetworkCm02Model(const std::string& name) : NetworkModel(name)
   loopback_->set_sharing_policy(s4u::Link::SharingPolicy::FATPIPE, {});
   loopback_->set_latency(config::get_value<double>("network/loopback-lat"));
   loopback_->get_iface()->seal();
+
+  /* The netpoint of a destroyed host may be reused by another one */
+  s4u::Host::on_destruction_cb([setups = std::weak_ptr<CommSetups>(comm_setups_)](s4u::Host const&) {
+    if (auto cache = setups.lock())
+      cache->clear();
+  });
 }
 
 StandardLinkImpl* NetworkCm02Model::create_link(const std::string& name, const std::vector<double>& bandwidths)
@@ -198,10 +207,22 @@ void NetworkCm02Model::update_actions_state_full(double /*now*/, double delta)
   }
 }
 
-void NetworkCm02Model::comm_action_expand_constraints(const s4u::Host* src, const s4u::Host* dst,
-                                                      const NetworkCm02Action* action,
-                                                      const std::vector<StandardLinkImpl*>& route,
-                                                      const std::vector<StandardLinkImpl*>& back_route) const
+NetworkCm02Model::LinkWeights NetworkCm02Model::comm_get_link_weights(const std::vector<StandardLinkImpl*>& route,
+                                                                     double weight)
+{
+  LinkWeights weights;
+  weights.reserve(route.size());
+  for (auto const* link : route) {
+    if (link->get_sharing_policy() != s4u::Link::SharingPolicy::WIFI)
+      weights.emplace_back(link->get_constraint(), weight);
+  }
+  return weights;
+}
+
+NetworkCm02Model::LinkWeights NetworkCm02Model::comm_get_elements(const s4u::Host* src, const s4u::Host* dst,
+                                                                 const std::vector<StandardLinkImpl*>& route,
+                                                                 const LinkWeights& route_weights,
+                                                                 const LinkWeights& back_weights, bool& disabled) const
 {
   /* expand route links constraints for route and back_route */
   const WifiLinkImpl* src_wifi_link = nullptr;
@@ -213,44 +234,37 @@ void NetworkCm02Model::comm_action_expand_constraints(const s4u::Host* src, cons
     dst_wifi_link = static_cast<WifiLinkImpl*>(route.back());
   }
 
+  LinkWeights elements;
+  elements.reserve(route_weights.size() + back_weights.size() + 4);
+  disabled = false;
+
   /* WI-FI links needs special treatment, do it here */
   if (src_wifi_link != nullptr) {
     if (src_wifi_link->get_host_rate(src) > 0)
-      get_maxmin_system()->expand(src_wifi_link->get_constraint(), action->get_variable(),
-                                  1.0 / src_wifi_link->get_host_rate(src));
-    else {
-      get_maxmin_system()->update_variable_penalty(action->get_variable(), 0);
-    }
+      elements.emplace_back(src_wifi_link->get_constraint(), 1.0 / src_wifi_link->get_host_rate(src));
+    else
+      disabled = true;
   }
 
   if (dst_wifi_link != nullptr) {
     if (dst_wifi_link->get_host_rate(dst) > 0)
-      get_maxmin_system()->expand(dst_wifi_link->get_constraint(), action->get_variable(),
-                                  1.0 / dst_wifi_link->get_host_rate(dst));
-    else {
-      get_maxmin_system()->update_variable_penalty(action->get_variable(), 0);
-    }
+      elements.emplace_back(dst_wifi_link->get_constraint(), 1.0 / dst_wifi_link->get_host_rate(dst));
+    else
+      disabled = true;
   }
 
-  for (auto const* link : route) {
-    if (link->get_sharing_policy() != s4u::Link::SharingPolicy::WIFI)
-      get_maxmin_system()->expand(link->get_constraint(), action->get_variable(), 1.0);
-  }
+  elements.insert(elements.end(), route_weights.begin(), route_weights.end());
 
   if (cfg_crosstraffic) {
     XBT_DEBUG("Crosstraffic active: adding backward flow using 5%% of the available bandwidth");
     if (dst_wifi_link != nullptr)
-      get_maxmin_system()->expand(dst_wifi_link->get_constraint(), action->get_variable(),
-                                  .05 / dst_wifi_link->get_host_rate(dst));
+      elements.emplace_back(dst_wifi_link->get_constraint(), .05 / dst_wifi_link->get_host_rate(dst));
     if (src_wifi_link != nullptr)
-      get_maxmin_system()->expand(src_wifi_link->get_constraint(), action->get_variable(),
-                                  .05 / src_wifi_link->get_host_rate(src));
+      elements.emplace_back(src_wifi_link->get_constraint(), .05 / src_wifi_link->get_host_rate(src));
 
-    for (auto const* link : back_route) {
-      if (link->get_sharing_policy() != s4u::Link::SharingPolicy::WIFI)
-        get_maxmin_system()->expand(link->get_constraint(), action->get_variable(), .05);
-    }
+    elements.insert(elements.end(), back_weights.begin(), back_weights.end());
   }
+  return elements;
 }
 
 NetworkCm02Action* NetworkCm02Model::comm_action_create(s4u::Host* src, s4u::Host* dst, double size,
@@ -341,11 +355,13 @@ void NetworkCm02Model::comm_action_set_bounds(const s4u::Host* src, const s4u::H
                   [&s4u_netzones](kernel::routing::NetZoneImpl* n) { s4u_netzones.insert(n->get_iface()); });
   }
 
-  double bw_factor = get_bandwidth_factor(size, src, dst, s4u_route, s4u_netzones);
-  xbt_assert(bw_factor != 0, "Invalid param for comm %s -> %s. Bandwidth factor cannot be 0", src->get_cname(),
-             dst->get_cname());
-  action->set_rate_factor(bw_factor);
+  double bw_factor  = get_bandwidth_factor(size, src, dst, s4u_route, s4u_netzones);
+  double lat_factor = get_latency_factor(size, src, dst, s4u_route, s4u_netzones);
+  comm_action_apply_bounds(src, dst, action, bw_factor, lat_factor, comm_get_bandwidth_bound(route), rate);
+}
 
+double NetworkCm02Model::comm_get_bandwidth_bound(const std::vector<StandardLinkImpl*>& route)
+{
   /* get mininum bandwidth among links in the route and multiply by correct factor
    * ignore wi-fi links, they're not considered for bw_factors */
   double bandwidth_bound = -1.0;
@@ -355,6 +371,16 @@ void NetworkCm02Model::comm_action_set_bounds(const s4u::Host* src, const s4u::H
     if (bandwidth_bound == -1.0 || l->get_bandwidth() < bandwidth_bound)
       bandwidth_bound = l->get_bandwidth();
   }
+  return bandwidth_bound;
+}
+
+void NetworkCm02Model::comm_action_apply_bounds(const s4u::Host* src, const s4u::Host* dst, NetworkCm02Action* action,
+                                                double bw_factor, double lat_factor, double bandwidth_bound,
+                                                double rate) const
+{
+  xbt_assert(bw_factor != 0, "Invalid param for comm %s -> %s. Bandwidth factor cannot be 0", src->get_cname(),
+             dst->get_cname());
+  action->set_rate_factor(bw_factor);
 
   /* increase rate given by user considering the factor, since the actual rate will be
    * modified by it */
@@ -365,57 +391,141 @@ void NetworkCm02Model::comm_action_set_bounds(const s4u::Host* src, const s4u::H
   action->set_user_bound(bandwidth_bound);
 
   action->lat_current_ = action->latency_;
-  action->latency_ *= get_latency_factor(size, src, dst, s4u_route, s4u_netzones);
+  action->latency_ *= lat_factor;
 }
 
 void NetworkCm02Model::comm_action_set_variable(NetworkCm02Action* action, const std::vector<StandardLinkImpl*>& route,
-                                                const std::vector<StandardLinkImpl*>& back_route, bool streamed)
+                                                const LinkWeights& elements, bool disabled, bool streamed)
 {
-  size_t constraints_per_variable = route.size();
-  constraints_per_variable += back_route.size();
-  if (streamed) {
-    // setting the number of variable for a communication action involved in a I/O streaming operation
-    // requires to reserve some extra space for the constraints related to the source disk (global and read
-    // bandwidth) and destination disk (global and write bandwidth). We thus add 4 constraints.
-    constraints_per_variable += 4;
+  // setting the number of variable for a communication action involved in a I/O streaming operation
+  // requires to reserve some extra space for the constraints related to the source disk (global and read
+  // bandwidth) and destination disk (global and write bandwidth). We thus add 4 constraints.
+  size_t extra_constraints = streamed ? 4 : 0;
+
+  /* compute the bound of the variable depending on user configuration */
+  double bound;
+  if (action->get_user_bound() < 0) {
+    bound = (action->lat_current_ > 0 && cfg_tcp_gamma > 0) ? cfg_tcp_gamma / (2.0 * action->lat_current_) : -1.0;
+  } else {
+    bound = (action->lat_current_ > 0 && cfg_tcp_gamma > 0)
+                ? std::min(action->get_user_bound(), cfg_tcp_gamma / (2.0 * action->lat_current_))
+                : action->get_user_bound();
   }
 
-  if (action->latency_ > 0) {
-    action->set_variable(get_maxmin_system()->variable_new(action, 0.0, -1.0, constraints_per_variable));
-    if (is_update_lazy()) {
-      // add to the heap the event when the latency is paid
-      double date = action->latency_ + action->get_last_update();
+  /* the variable only gets a penalty once the latency is paid, and never if a host is detached from its wifi link */
+  double penalty = (action->latency_ > 0 || disabled) ? 0.0 : 1.0;
+  action->set_variable(
+      get_maxmin_system()->variable_new_with_elements(action, penalty, bound, elements, extra_constraints));
 
-      ActionHeap::Type type = route.empty() ? ActionHeap::Type::normal : ActionHeap::Type::latency;
+  if (action->latency_ > 0 && is_update_lazy()) {
+    // add to the heap the event when the latency is paid
+    double date = action->latency_ + action->get_last_update();
 
-      XBT_DEBUG("Added action (%p) one latency event at date %f", action, date);
-      get_action_heap().insert(action, date, type);
-    }
-  } else
-    action->set_variable(get_maxmin_system()->variable_new(action, 1.0, -1.0, constraints_per_variable));
+    ActionHeap::Type type = route.empty() ? ActionHeap::Type::normal : ActionHeap::Type::latency;
 
-  /* after setting the variable, update the bounds depending on user configuration */
-  if (action->get_user_bound() < 0) {
-    get_maxmin_system()->update_variable_bound(
-        action->get_variable(),
-        (action->lat_current_ > 0 && cfg_tcp_gamma > 0) ? cfg_tcp_gamma / (2.0 * action->lat_current_) : -1.0);
-  } else {
-    get_maxmin_system()->update_variable_bound(
-        action->get_variable(), (action->lat_current_ > 0 && cfg_tcp_gamma > 0)
-                                    ? std::min(action->get_user_bound(), cfg_tcp_gamma / (2.0 * action->lat_current_))
-                                    : action->get_user_bound());
+    XBT_DEBUG("Added action (%p) one latency event at date %f", action, date);
+    get_action_heap().insert(action, date, type);
+  }
+}
+
+NetworkCm02Model::CommSetup& NetworkCm02Model::comm_get_setup(const s4u::Host* src, const s4u::Host* dst)
+{
+  auto [it, inserted] = comm_setups_->try_emplace({src->get_netpoint(), dst->get_netpoint()});
+  CommSetup& setup    = it->second;
+  setup.last_use      = ++comm_setups_uses_;
+  if (not inserted) {
+    if (setup.links_version == comm_get_links_version(setup))
+      return setup;
+    XBT_DEBUG("A link between %s and %s changed: compute the setup again", src->get_cname(), dst->get_cname());
+    setup.route.clear();
+    setup.back_route.clear();
+  } else if (comm_setups_->size() > MAX_COMM_SETUPS) { // Don't let all-to-all patterns on large platforms eat the memory
+    comm_evict_setups();                                 // The new setup is the most recent one, so it is kept
+  }
+
+  std::unordered_set<kernel::routing::NetZoneImpl*> netzones;
+  setup.latency = 0.0;
+  kernel::routing::NetZoneImpl::get_global_route_with_netzones(src->get_netpoint(), dst->get_netpoint(), setup.route,
+                                                               &setup.latency, netzones);
+  xbt_assert(not setup.route.empty() || setup.latency > 0,
+             "You're trying to send data from %s to %s but there is no connecting path between these two hosts.",
+             src->get_cname(), dst->get_cname());
+  if (cfg_crosstraffic)
+    dst->route_to(src, setup.back_route, nullptr);
+
+  setup.sharing_penalty = setup.latency;
+  if (cfg_weight_S_parameter > 0) {
+    setup.sharing_penalty = std::accumulate(setup.route.begin(), setup.route.end(), setup.sharing_penalty,
+                                            [](double total, StandardLinkImpl* const& link) {
+                                              return total + cfg_weight_S_parameter / link->get_bandwidth();
+                                            });
   }
+  setup.bandwidth_bound = comm_get_bandwidth_bound(setup.route);
+  setup.route_weights   = comm_get_link_weights(setup.route, 1.0);
+  setup.back_weights    = comm_get_link_weights(setup.back_route, .05);
+  setup.links_version   = comm_get_links_version(setup);
+  XBT_DEBUG("Cached the setup of the communications from %s to %s (%zu links)", src->get_cname(), dst->get_cname(),
+            setup.route.size());
+  return setup;
+}
+
+unsigned long NetworkCm02Model::comm_get_links_version(const CommSetup& setup)
+{
+  auto add_version = [](unsigned long total, const StandardLinkImpl* link) {
+    return total + link->get_metrics_version();
+  };
+  unsigned long version = std::accumulate(setup.route.begin(), setup.route.end(), 0UL, add_version);
+  return std::accumulate(setup.back_route.begin(), setup.back_route.end(), version, add_version);
+}
+
+void NetworkCm02Model::comm_evict_setups()
+{
+  std::vector<unsigned long> uses;
+  uses.reserve(comm_setups_->size());
+  for (auto const& [_, setup] : *comm_setups_)
+    uses.push_back(setup.last_use);
+  auto median = uses.begin() + uses.size() / 2;
+  std::nth_element(uses.begin(), median, uses.end());
+  unsigned long limit = *median;
+  for (auto it = comm_setups_->begin(); it != comm_setups_->end();)
+    it = it->second.last_use < limit ? comm_setups_->erase(it) : std::next(it);
+  XBT_DEBUG("Evicted the oldest setups of the communications, %zu are left", comm_setups_->size());
 }
 
 Action* NetworkCm02Model::communicate(s4u::Host* src, s4u::Host* dst, double size, double rate, bool streamed)
 {
+  XBT_IN("(%s,%s,%g,%g)", src->get_cname(), dst->get_cname(), size, rate);
+
+  /* The factor callbacks may depend on anything, and failed communications are rare: only cache the other cases */
+  if (not has_network_factor_cb()) {
+    CommSetup& setup = comm_get_setup(src, dst);
+    auto is_off      = [](const StandardLinkImpl* link) { return not link->is_on(); };
+    if (std::none_of(setup.route.begin(), setup.route.end(), is_off) &&
+        std::none_of(setup.back_route.begin(), setup.back_route.end(), is_off)) {
+      // Without callback, the factors only depend on the size: they are found by a binary search over the size buckets
+      static const std::vector<s4u::Link*> no_links;
+      static const std::unordered_set<s4u::NetZone*> no_netzones;
+      double bw_factor  = get_bandwidth_factor(size, src, dst, no_links, no_netzones);
+      double lat_factor = get_latency_factor(size, src, dst, no_links, no_netzones);
+
+      NetworkCm02Action* action = comm_action_create(src, dst, size, setup.route, false);
+      action->sharing_penalty_  = setup.sharing_penalty;
+      action->latency_          = setup.latency;
+      comm_action_apply_bounds(src, dst, action, bw_factor, lat_factor, setup.bandwidth_bound, rate);
+      bool disabled;
+      LinkWeights elements =
+          comm_get_elements(src, dst, setup.route, setup.route_weights, setup.back_weights, disabled);
+      comm_action_set_variable(action, setup.route, elements, disabled, streamed);
+      XBT_OUT();
+      return action;
+    }
+  }
+
   double latency = 0.0;
   std::vector<StandardLinkImpl*> back_route;
   std::vector<StandardLinkImpl*> route;
   std::unordered_set<kernel::routing::NetZoneImpl*> netzones;
 
-  XBT_IN("(%s,%s,%g,%g)", src->get_cname(), dst->get_cname(), size, rate);
-
   bool failed = comm_get_route_info(src, dst, latency, route, back_route, netzones);
 
   NetworkCm02Action* action = comm_action_create(src, dst, size, route, failed);
@@ -432,11 +542,12 @@ Action* NetworkCm02Model::communicate(s4u::Host* src, s4u::Host* dst, double siz
   /* setting bandwidth and latency bounds considering route and configured bw/lat factors */
   comm_action_set_bounds(src, dst, size, action, route, netzones, rate);
 
-  /* creating the maxmin variable associated to this action */
-  comm_action_set_variable(action, route, back_route, streamed);
-
-  /* expand maxmin system to consider this communication in bw constraint for each link in route and back_route */
-  comm_action_expand_constraints(src, dst, action, route, back_route);
+  /* creating the maxmin variable associated to this action, using the bw constraint of each link in route and
+   * back_route */
+  bool disabled;
+  LinkWeights elements = comm_get_elements(src, dst, route, comm_get_link_weights(route, 1.0),
+                                           comm_get_link_weights(back_route, .05), disabled);
+  comm_action_set_variable(action, route, elements, disabled, streamed);
   XBT_OUT();
 
   return action;
@@ -484,6 +595,7 @@ void NetworkCm02Link::set_bandwidth(double value)
   bandwidth_.peak = value;
 
   get_model()->get_maxmin_system()->update_constraint_bound(get_constraint(), (bandwidth_.peak * bandwidth_.scale));
+  metrics_version_++;
 
   StandardLinkImpl::on_bandwidth_change();
 
@@ -514,6 +626,7 @@ void NetworkCm02Link::set_latency(double value)
 
   latency_.scale = 1.0;
   latency_.peak  = value;
+  metrics_version_++;
 
   while (const auto* var = get_constraint()->get_variable_safe(&elem, &nextelem, &numelem)) {
     auto* action = static_cast<NetworkCm02Action*>(var->get_id());
@@ -10,6 +10,11 @@
 #include "src/kernel/resource/StandardLinkImpl.hpp"
 #include "xbt/base.h"
 
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 /***********
  * Classes *
  ***********/
@@ -25,6 +30,33 @@ class XBT_PRIVATE NetworkSmpiModel;
  *********/
 
 class NetworkCm02Model : public NetworkModel {
+  using LinkWeights = lmm::System::ElementList;
+
+  /** @brief Everything that only depends on the endpoints of a communication, and on the route between them.
+   *
+   * Only used when no factor callback is set. Computed again when the bandwidth or the latency of one of its links
+   * changed, which is detected with the sum of their metrics versions. */
+  struct CommSetup {
+    std::vector<StandardLinkImpl*> route;
+    std::vector<StandardLinkImpl*> back_route;
+    double latency;
+    double sharing_penalty; // latency plus the weight-S penalty of each link
+    double bandwidth_bound;
+    LinkWeights route_weights; // constraints of the non-wifi links and their weight in the variable
+    LinkWeights back_weights;  // same for the back route, if crosstraffic is enabled
+    unsigned long links_version = 0; // sum of the metrics versions of the links of both routes
+    unsigned long last_use      = 0; // to evict the setups not used recently
+  };
+  using CommSetups = std::map<std::pair<const routing::NetPoint*, const routing::NetPoint*>, CommSetup>;
+  std::shared_ptr<CommSetups> comm_setups_ = std::make_shared<CommSetups>(); // shared with the host destruction cb
+  unsigned long comm_setups_uses_          = 0;
+
+  /** @brief Get the cached setup of the communications from src to dst, computing it if needed */
+  CommSetup& comm_get_setup(const s4u::Host* src, const s4u::Host* dst);
+  /** @brief Compute the sum of the metrics versions of the links used by a setup */
+  static unsigned long comm_get_links_version(const CommSetup& setup);
+  /** @brief Forget the half of the cached setups that were not used for the longest time */
+  void comm_evict_setups();
   /** @brief Get route information (2-way) */
   bool comm_get_route_info(const s4u::Host* src, const s4u::Host* dst, /* OUT */ double& latency,
                            std::vector<StandardLinkImpl*>& route, std::vector<StandardLinkImpl*>& back_route,
@@ -32,17 +64,25 @@ class NetworkCm02Model : public NetworkModel {
   /** @brief Create network action for this communication */
   NetworkCm02Action* comm_action_create(s4u::Host* src, s4u::Host* dst, double size,
                                         const std::vector<StandardLinkImpl*>& route, bool failed);
-  /** @brief Expand link contraint considering this new communication action */
-  void comm_action_expand_constraints(const s4u::Host* src, const s4u::Host* dst, const NetworkCm02Action* action,
-                                      const std::vector<StandardLinkImpl*>& route,
-                                      const std::vector<StandardLinkImpl*>& back_route) const;
+  /** @brief Get the link constraints of a new communication action, with its weight in each of them.
+   * disabled is set if one of the hosts is not attached to its wifi link. */
+  LinkWeights comm_get_elements(const s4u::Host* src, const s4u::Host* dst, const std::vector<StandardLinkImpl*>& route,
+                                const LinkWeights& route_weights, const LinkWeights& back_weights,
+                                bool& disabled) const;
+  /** @brief Compute the weights of the non-wifi links of a route in the variable of the communications using it */
+  static LinkWeights comm_get_link_weights(const std::vector<StandardLinkImpl*>& route, double weight);
+  /** @brief Get the minimal bandwidth among the non-wifi links of a route */
+  static double comm_get_bandwidth_bound(const std::vector<StandardLinkImpl*>& route);
   /** @brief Set communication bounds for latency and bandwidth */
   void comm_action_set_bounds(const s4u::Host* src, const s4u::Host* dst, double size, NetworkCm02Action* action,
                               const std::vector<StandardLinkImpl*>& route,
                               const std::unordered_set<kernel::routing::NetZoneImpl*>& netzones, double rate) const;
-  /** @brief Create maxmin variable in communication action */
+  /** @brief Set communication bounds once the factors and the bandwidth of the route are known */
+  void comm_action_apply_bounds(const s4u::Host* src, const s4u::Host* dst, NetworkCm02Action* action,
+                                double bw_factor, double lat_factor, double bandwidth_bound, double rate) const;
+  /** @brief Create maxmin variable in communication action, expanded over the provided constraints */
   void comm_action_set_variable(NetworkCm02Action* action, const std::vector<StandardLinkImpl*>& route,
-                                const std::vector<StandardLinkImpl*>& back_route, bool streamed);
+                                const LinkWeights& elements, bool disabled, bool streamed);
 
 public:
   explicit NetworkCm02Model(const std::string& name);
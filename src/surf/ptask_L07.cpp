@@ -175,9 +175,18 @@ L07Action::L07Action(Model* model, const std::vector<s4u::Host*>& host_list, con
   if (flops_amount != nullptr)
     used_host_nb += std::count_if(flops_amount, flops_amount + host_nb, [](double x) { return x > 0.0; });
 
+  /* Expand it for the CPUs even if there is nothing to compute, to make sure that it gets expended even if there is no
+   * communication either */
+  lmm::System::ElementList cpu_elements;
+  cpu_elements.reserve(host_nb);
+  for (size_t i = 0; i < host_nb; i++)
+    cpu_elements.emplace_back(host_list[i]->get_cpu()->get_constraint(),
+                              (flops_amount == nullptr ? 0.0 : flops_amount[i]));
+
   /* Compute the number of affected resources... */
+  lmm::System::ElementList link_elements;
   if (bytes_amount != nullptr) {
-    std::unordered_set<const char*> affected_links;
+    std::unordered_set<const StandardLinkImpl*> affected_links;
 
     for (size_t k = 0; k < host_nb * host_nb; k++) {
       if (bytes_amount[k] <= 0)
@@ -188,8 +197,10 @@ L07Action::L07Action(Model* model, const std::vector<s4u::Host*>& host_list, con
       host_list_[k / host_nb]->route_to(host_list_[k % host_nb], route, &lat);
       latency = std::max(latency, lat);
 
-      for (auto const& link : route)
-        affected_links.insert(link->get_cname());
+      for (auto const* link : route) {
+        affected_links.insert(link);
+        link_elements.emplace_back(link->get_constraint(), bytes_amount[k]);
+      }
     }
 
     link_nb = affected_links.size();
@@ -198,29 +209,11 @@ L07Action::L07Action(Model* model, const std::vector<s4u::Host*>& host_list, con
   XBT_DEBUG("Creating a parallel task (%p) with %zu hosts and %zu unique links.", this, host_nb, link_nb);
   latency_ = latency;
 
-  set_variable(model->get_maxmin_system()->variable_new(this, 1.0, (rate > 0 ? rate : -1.0), host_nb + link_nb));
-
-  if (latency_ > 0)
-    model->get_maxmin_system()->update_variable_penalty(get_variable(), 0.0);
-
-  /* Expand it for the CPUs even if there is nothing to compute, to make sure that it gets expended even if there is no
-   * communication either */
-  for (size_t i = 0; i < host_nb; i++) {
-    model->get_maxmin_system()->expand(host_list[i]->get_cpu()->get_constraint(), get_variable(),
-                                       (flops_amount == nullptr ? 0.0 : flops_amount[i]), true);
-  }
-
-  if (bytes_amount != nullptr) {
-    for (size_t k = 0; k < host_nb * host_nb; k++) {
-      if (bytes_amount[k] <= 0.0)
-        continue;
-      std::vector<StandardLinkImpl*> route;
-      host_list_[k / host_nb]->route_to(host_list_[k % host_nb], route, nullptr);
-
-      for (auto const& link : route)
-        model->get_maxmin_system()->expand(link->get_constraint(), this->get_variable(), bytes_amount[k]);
-    }
-  }
+  auto* system = model->get_maxmin_system();
+  set_variable(system->variable_new(this, (latency_ > 0 ? 0.0 : 1.0), (rate > 0 ? rate : -1.0), host_nb + link_nb));
+  /* A host may appear several times in a ptask, but each occurrence has its own element on the CPU constraint */
+  system->expand(get_variable(), cpu_elements, true);
+  system->expand(get_variable(), link_elements);
 
   if (link_nb + used_host_nb == 0) {
     this->set_cost(1.0);
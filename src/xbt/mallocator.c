@@ -116,6 +116,16 @@ xbt_mallocator_t xbt_mallocator_new(int size, pvoid_f_void_t new_f, void_f_pvoid
   return m;
 }
 
+/** @brief Get the amount of requests, of recycled objects and the peak footprint of a mallocator */
+s_xbt_mallocator_stats_t xbt_mallocator_get_stats(xbt_mallocator_t m)
+{
+  xbt_assert(m != NULL, "Invalid parameter");
+  lock_acquire(m);
+  s_xbt_mallocator_stats_t stats = {m->requests, m->hits, m->peak_footprint};
+  lock_release(m);
+  return stats;
+}
+
 /** @brief Destructor
  * @param m the mallocator you want to destroy
  *
@@ -127,7 +137,8 @@ void xbt_mallocator_free(xbt_mallocator_t m)
 {
   xbt_assert(m != NULL, "Invalid parameter");
 
-  XBT_VERB("Frees mallocator %p (size:%d/%d)", m, m->current_size, m->max_size);
+  XBT_VERB("Frees mallocator %p (size:%d/%d, hit rate: %lu/%lu, peak footprint: %d objects)", m, m->current_size,
+           m->max_size, m->hits, m->requests, m->peak_footprint);
   for (int i = 0; i < m->current_size; i++) {
     m->free_f(m->objects[i]);
   }
@@ -155,17 +166,22 @@ void *xbt_mallocator_get(xbt_mallocator_t m)
 
   if (m->objects != NULL) { // this mallocator is active, stop thinking and go for it!
     lock_acquire(m);
+    m->requests++;
     if (m->current_size <= 0) {
       /* No object is ready yet. Create a bunch of them to try to group the
        * mallocs on the same memory pages (to help the cache lines) */
-      int amount = MIN(m->max_size / 2, 1000);
+      int amount = MAX(MIN(m->max_size / 2, 1000), 1);
       for (int i = 0; i < amount; i++)
         m->objects[i] = m->new_f();
       m->current_size = amount;
+    } else {
+      m->hits++;
     }
 
     /* there is at least an available object, now */
     object = m->objects[--m->current_size];
+    m->in_use++;
+    m->peak_footprint = MAX(m->peak_footprint, m->in_use + m->current_size);
     lock_release(m);
   } else {
     if (xbt_mallocator_is_active()) {
@@ -174,6 +190,7 @@ void *xbt_mallocator_get(xbt_mallocator_t m)
       lock_reset(m);
       return xbt_mallocator_get(m);
     } else {
+      m->requests++;
       object = m->new_f();
     }
   }
@@ -200,6 +217,8 @@ void xbt_mallocator_release(xbt_mallocator_t m, void *object)
      return;
   if (m->objects != NULL) { // Go for it
     lock_acquire(m);
+    if (m->in_use > 0) // Objects obtained before the activation of the mallocator are not accounted
+      m->in_use--;
     if (m->current_size < m->max_size) {
       /* there is enough place to push the object */
       m->objects[m->current_size++] = object;
@@ -19,6 +19,10 @@ typedef struct s_xbt_mallocator {
   void_f_pvoid_t free_f;        /* function to call when we have got too many objects */
   void_f_pvoid_t reset_f;       /* function to call when an object is released by the user */
   atomic_flag lock;             /* lock to ensure the mallocator is thread-safe */
+  unsigned long requests;       /* number of calls to xbt_mallocator_get() */
+  unsigned long hits;           /* number of these calls served without calling new_f() */
+  int in_use;                   /* number of objects currently given to the user */
+  int peak_footprint;           /* maximal number of objects ever allocated at the same time (in use or stored) */
 } s_xbt_mallocator_t;
 
 #endif
@@ -4,15 +4,31 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "simgrid/Exception.hpp"
+#include "xbt/config.hpp"
 #include "xbt/log.h"
 #include "xbt/replay.hpp"
 
 #include <boost/algorithm/string.hpp>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(replay,xbt,"Replay trace reader");
 
 namespace simgrid::xbt {
 
+static config::Flag<int> cfg_prefetch_threads{
+    "replay/prefetch-threads",
+    "Amount of threads parsing the per-actor trace files ahead of their replay (0: each actor parses its own file)", 0,
+    [](int val) { xbt_assert(val >= 0, "replay/prefetch-threads must be positive or null"); }};
+static config::Flag<int> cfg_prefetch_buffer{
+    "replay/prefetch-buffer", "Amount of actions parsed at once for each actor when using replay/prefetch-threads", 128,
+    [](int val) { xbt_assert(val > 0, "replay/prefetch-buffer must be positive"); }};
+
 static std::ifstream action_fs;
 
 std::unordered_map<std::string, action_fun> action_funs;
@@ -27,27 +43,204 @@ static void read_and_trim_line(std::ifstream& fs, std::string* line)
   XBT_DEBUG("got from trace: %s", line->c_str());
 }
 
+/* Same as boost::split on a trimmed line, but reusing the strings already allocated in the action */
+static void split_line(const std::string& line, ReplayAction* action)
+{
+  size_t count = 0;
+  size_t start = line.find_first_not_of(" \t");
+  while (start != std::string::npos) {
+    size_t end = std::min(line.find_first_of(" \t", start), line.size());
+    if (count == action->size())
+      action->emplace_back();
+    (*action)[count].assign(line, start, end - start);
+    count++;
+    start = line.find_first_not_of(" \t", end);
+  }
+  action->resize(count);
+}
+
+/** Pool of threads parsing the per-actor trace files ahead of their replay (see replay/prefetch-threads) */
+class ReplayParserPool {
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::queue<std::function<void()>> jobs_;
+  bool stopping_ = false;
+
+  void worker();
+
+public:
+  explicit ReplayParserPool(int thread_count);
+  ReplayParserPool(const ReplayParserPool&) = delete;
+  ReplayParserPool& operator=(const ReplayParserPool&) = delete;
+  ~ReplayParserPool();
+  void submit(std::function<void()>&& job);
+};
+
+/* Created on first use, which may happen concurrently with parallel contexts */
+static ReplayParserPool& get_parser_pool()
+{
+  static ReplayParserPool pool(cfg_prefetch_threads);
+  return pool;
+}
+
+ReplayParserPool::ReplayParserPool(int thread_count)
+{
+  XBT_VERB("Start %d threads to parse the trace files", thread_count);
+  for (int i = 0; i < thread_count; i++)
+    threads_.emplace_back(&ReplayParserPool::worker, this);
+}
+
+ReplayParserPool::~ReplayParserPool()
+{
+  {
+    std::scoped_lock lock(mutex_);
+    stopping_ = true;
+  }
+  cond_.notify_all();
+  for (auto& thread : threads_)
+    thread.join();
+}
+
+void ReplayParserPool::submit(std::function<void()>&& job)
+{
+  {
+    std::scoped_lock lock(mutex_);
+    jobs_.push(std::move(job));
+  }
+  cond_.notify_one();
+}
+
+void ReplayParserPool::worker()
+{
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock(mutex_);
+      cond_.wait(lock, [this] { return stopping_ || not jobs_.empty(); });
+      if (jobs_.empty())
+        return;
+      job = std::move(jobs_.front());
+      jobs_.pop();
+    }
+    job();
+  }
+}
+
+/** Reader of a per-actor trace file.
+ *
+ * When replay/prefetch-threads is set, the file is parsed by the thread pool in two buffers of preallocated actions:
+ * the actor replays one buffer while the other one is filled. A buffer is handed over by setting its ready flag, and
+ * only one of them is being filled at a given time so that the file is read in order. The actions are replayed in the
+ * order of the file in any case, so the simulation does not depend on the parsing threads.
+ */
 class ReplayReader {
+  struct Buffer {
+    std::vector<ReplayAction> actions;
+    size_t size = 0;
+    bool eof    = false;
+    std::atomic<bool> ready{false};
+  };
+
   std::ifstream fs;
   std::string line;
+  ReplayAction action_;
+
+  bool prefetch_ = false;
+  std::array<Buffer, 2> buffers_;
+  unsigned current_ = 0;
+  size_t position_  = 0;
+  std::atomic<int> pending_jobs_{0};
+
+  void fill(Buffer& buffer);
+  static void wait_ready(const Buffer& buffer);
 
 public:
-  explicit ReplayReader(const char* filename) : fs(filename, std::ifstream::in)
-  {
-    XBT_VERB("Prepare to replay file '%s'", filename);
-    xbt_assert(fs.is_open(), "Cannot read replay file '%s'", filename);
-  }
+  explicit ReplayReader(const char* filename);
   ReplayReader(const ReplayReader&) = delete;
   ReplayReader& operator=(const ReplayReader&) = delete;
-  bool get(ReplayAction* action);
+  ~ReplayReader();
+  /** Returns the next action of the file, which remains valid until the next call, or nullptr at the end of file */
+  ReplayAction* next();
 };
 
-bool ReplayReader::get(ReplayAction* action)
+ReplayReader::ReplayReader(const char* filename) : fs(filename, std::ifstream::in)
+{
+  XBT_VERB("Prepare to replay file '%s'", filename);
+  xbt_assert(fs.is_open(), "Cannot read replay file '%s'", filename);
+  if (cfg_prefetch_threads == 0)
+    return;
+
+  prefetch_ = true;
+  for (auto& buffer : buffers_)
+    buffer.actions.resize(cfg_prefetch_buffer);
+  pending_jobs_++;
+  get_parser_pool().submit([this] {
+    fill(buffers_[0]);
+    if (not buffers_[0].eof)
+      fill(buffers_[1]);
+    pending_jobs_--;
+  });
+}
+
+ReplayReader::~ReplayReader()
+{
+  // The parsing threads may still be filling a buffer if the actor was interrupted
+  while (pending_jobs_.load() > 0)
+    std::this_thread::yield();
+}
+
+void ReplayReader::fill(Buffer& buffer)
 {
-  read_and_trim_line(fs, &line);
+  buffer.size = 0;
+  while (buffer.size < buffer.actions.size()) {
+    read_and_trim_line(fs, &line);
+    if (fs.eof())
+      break;
+    split_line(line, &buffer.actions[buffer.size]);
+    buffer.size++;
+  }
+  buffer.eof = fs.eof();
+  buffer.ready.store(true, std::memory_order_release);
+}
 
-  boost::split(*action, line, boost::is_any_of(" \t"), boost::token_compress_on);
-  return not fs.eof();
+void ReplayReader::wait_ready(const Buffer& buffer)
+{
+  while (not buffer.ready.load(std::memory_order_acquire))
+    std::this_thread::yield();
+}
+
+ReplayAction* ReplayReader::next()
+{
+  if (not prefetch_) {
+    read_and_trim_line(fs, &line);
+    if (fs.eof())
+      return nullptr;
+    split_line(line, &action_);
+    return &action_;
+  }
+
+  Buffer* buffer = &buffers_[current_];
+  wait_ready(*buffer);
+  while (position_ == buffer->size) {
+    if (buffer->eof)
+      return nullptr;
+    // The other buffer was requested when this one was handed over: switch to it, and refill this one meanwhile
+    Buffer& other = buffers_[1 - current_];
+    wait_ready(other);
+    buffer->ready.store(false, std::memory_order_relaxed);
+    if (not other.eof) {
+      pending_jobs_++;
+      get_parser_pool().submit([this, buffer] {
+        fill(*buffer);
+        pending_jobs_--;
+      });
+    }
+    current_  = 1 - current_;
+    position_ = 0;
+    buffer    = &other;
+  }
+  return &buffer->actions[position_++];
 }
 
 static std::unique_ptr<ReplayAction> get_action(const char* name)
@@ -102,6 +295,48 @@ static void handle_action(ReplayAction& action)
   }
 }
 
+/* Folded loops (see tracing/smpi/format/ti-fold): "<actor> loop <iterations> <length>" is followed by the <length>
+ * actions of its body, which may contain other loops. The body is read once, and replayed the given amount of times. */
+static bool is_loop(const ReplayAction& action)
+{
+  return action.size() == 4 && action[1] == "loop";
+}
+
+static void replay_body(const std::vector<ReplayAction>& body, size_t begin, size_t end)
+{
+  for (size_t i = begin; i < end; i++) {
+    if (is_loop(body[i])) {
+      unsigned long iterations = std::stoul(body[i][2]);
+      size_t length            = std::stoul(body[i][3]);
+      xbt_assert(i + length < end, "Replay Error: a loop of %s is longer than its enclosing loop", body[i][0].c_str());
+      for (unsigned long k = 0; k < iterations; k++)
+        replay_body(body, i + 1, i + 1 + length);
+      i += length;
+    } else {
+      ReplayAction action = body[i]; // The action functions may modify their parameter
+      handle_action(action);
+    }
+  }
+}
+
+static void handle_loop(const ReplayAction& header, const std::function<const ReplayAction*()>& next_action)
+{
+  std::string actor        = header[0];
+  unsigned long iterations = std::stoul(header[2]);
+  size_t length            = std::stoul(header[3]);
+  XBT_DEBUG("%s replays a loop of %lu iterations over %zu actions", actor.c_str(), iterations, length);
+
+  std::vector<ReplayAction> body;
+  body.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    const ReplayAction* action = next_action();
+    xbt_assert(action != nullptr, "Replay Error: the trace of %s ends within a loop", actor.c_str());
+    body.push_back(*action);
+  }
+  for (unsigned long k = 0; k < iterations; k++)
+    replay_body(body, 0, length);
+}
+
 /**
  * @ingroup XBT_replay
  * @brief function used internally to actually run the replay
@@ -113,11 +348,19 @@ int replay_runner(const char* actor_name, const char* trace_filename)
     xbt_assert(trace_filename == nullptr,
                "Passing nullptr to replay_runner() means that you want to use a shared trace, but you did not provide "
                "any. Please use xbt_replay_set_tracefile().");
+    std::unique_ptr<ReplayAction> body_action;
+    auto next_action = [&body_action, actor_name]() {
+      body_action = get_action(actor_name);
+      return body_action.get();
+    };
     while (true) {
       auto evt = simgrid::xbt::get_action(actor_name);
       if (not evt)
         break;
-      simgrid::xbt::handle_action(*evt);
+      if (is_loop(*evt))
+        handle_loop(*evt, next_action);
+      else
+        simgrid::xbt::handle_action(*evt);
     }
     action_queues.erase(actor_name_string);
   } else { // Should have got my trace file in argument
@@ -125,15 +368,17 @@ int replay_runner(const char* actor_name, const char* trace_filename)
                "Trace replay cannot mix shared and unshared traces for now. Please don't set a shared tracefile with "
                "xbt_replay_set_tracefile() if you use actor-specific trace files using the second parameter of "
                "replay_runner().");
-    simgrid::xbt::ReplayAction evt;
     simgrid::xbt::ReplayReader reader(trace_filename);
-    while (reader.get(&evt)) {
-      if (evt.front().compare(actor_name) == 0) {
-        simgrid::xbt::handle_action(evt);
+    auto next_action = [&reader]() { return reader.next(); };
+    while (simgrid::xbt::ReplayAction* evt = reader.next()) {
+      if (evt->front().compare(actor_name) == 0) {
+        if (is_loop(*evt))
+          handle_loop(*evt, next_action);
+        else
+          simgrid::xbt::handle_action(*evt);
       } else {
-        XBT_WARN("Ignore trace element not for me (target='%s', I am '%s')", evt.front().c_str(), actor_name);
+        XBT_WARN("Ignore trace element not for me (target='%s', I am '%s')", evt->front().c_str(), actor_name);
       }
-      evt.clear();
     }
   }
   return 0;
@@ -35,15 +35,6 @@ struct some_struct {
 };
 some_struct test_some_struct;
 
-static simgrid::mc::Frame* find_function_by_name(
-    simgrid::mc::ObjectInformation* info, const char* name)
-{
-  for (auto& [_, entry] : info->subprograms)
-    if (entry.name == name)
-      return &entry;
-  return nullptr;
-}
-
 static simgrid::mc::Variable* find_local_variable(
     simgrid::mc::Frame* frame, const char* argument_name)
 {
@@ -64,9 +55,12 @@ static simgrid::mc::Variable* find_local_variable(
 static void test_local_variable(simgrid::mc::ObjectInformation* info, const char* function, const char* variable,
                                 const void* address, unw_cursor_t* cursor)
 {
-  simgrid::mc::Frame* subprogram = find_function_by_name(info, function);
+  // The subprograms are loaded with the compilation unit of the instruction
+  unw_word_t ip;
+  unw_get_reg(cursor, UNW_REG_IP, &ip);
+  simgrid::mc::Frame* subprogram = info->find_function((void*)ip);
   assert(subprogram);
-  // TODO, Lookup frame by IP and test against name instead
+  xbt_assert(subprogram->name == function, "Expected the function %s but found %s", function, subprogram->name.c_str());
 
   const simgrid::mc::Variable* var = find_local_variable(subprogram, variable);
   assert(var);
@@ -0,0 +1,74 @@
+/* Copyright (c) 2023. The SimGrid Team. All rights reserved.          */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Benchmark of the CPU models on hosts whose speed varies a lot over time.
+ *
+ * Every host gets its own speed profile, made of many random values. Cas01 has to process every event of these
+ * profiles, while TI integrates them and only wakes up when an action terminates. Both models must compute the same
+ * simulated times, so run this program once with --cfg=cpu/optim:TI and once with --cfg=cpu/optim:Lazy, adding
+ * --log=cpu_ti_bench.thres:verbose to display the wall-clock time of the simulation.
+ */
+
+#include "simgrid/kernel/ProfileBuilder.hpp"
+#include "xbt/random.hpp"
+#include "xbt/xbt_os_time.h"
+#include <simgrid/s4u.hpp>
+
+#include <sstream>
+#include <string>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(cpu_ti_bench, "Messages specific for this benchmark");
+
+namespace sg4 = simgrid::s4u;
+
+static void worker(int tasks)
+{
+  for (int i = 0; i < tasks; i++)
+    sg4::this_actor::execute(1e8 * (1 + i % 7));
+}
+
+static simgrid::kernel::profile::Profile* random_profile(const std::string& name, int events)
+{
+  std::stringstream profile;
+  double date = 0;
+  for (int i = 0; i < events; i++) {
+    profile << date << " " << simgrid::xbt::random::uniform_real(0.1, 1.0) << "\n";
+    date += simgrid::xbt::random::uniform_real(0.001, 0.01);
+  }
+  profile << "LOOPAFTER " << simgrid::xbt::random::uniform_real(0.001, 0.01) << "\n";
+  return simgrid::kernel::profile::ProfileBuilder::from_string(name, profile.str(), -1);
+}
+
+int main(int argc, char* argv[])
+{
+  sg4::Engine e(&argc, argv);
+  xbt_assert(argc == 5, "Usage: %s <hosts> <events per profile> <actors per host> <tasks per actor>", argv[0]);
+  int nb_hosts  = std::stoi(argv[1]);
+  int nb_events = std::stoi(argv[2]);
+  int nb_actors = std::stoi(argv[3]);
+  int nb_tasks  = std::stoi(argv[4]);
+
+  simgrid::xbt::random::set_mersenne_seed(42);
+  auto* zone = sg4::create_full_zone("world");
+  for (int i = 0; i < nb_hosts; i++) {
+    std::string name = "host-" + std::to_string(i);
+    zone->create_host(name, 1e9)->set_speed_profile(random_profile(name + "-speed", nb_events))->seal();
+  }
+  zone->seal();
+
+  for (auto* host : e.get_all_hosts())
+    for (int i = 0; i < nb_actors; i++)
+      sg4::Actor::create("worker", host, worker, nb_tasks);
+
+  xbt_os_timer_t timer = xbt_os_timer_new();
+  xbt_os_walltimer_start(timer);
+  e.run();
+  xbt_os_walltimer_stop(timer);
+
+  XBT_INFO("Simulation done: %d hosts running %d actors each", nb_hosts, nb_actors);
+  XBT_VERB("Wall-clock time: %f s", xbt_os_timer_elapsed(timer));
+  xbt_os_timer_free(timer);
+  return 0;
+}
@@ -0,0 +1,161 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Check and benchmark the reduction kernels of the predefined operations, through MPI_Reduce_local.
+ *
+ * Each operation is compared to a plain scalar loop, reading the length through a pointer as the generic reduction
+ * loops of SMPI. Use --log=reduce_local.thres:verbose to display the time spent per element by both versions.
+ *
+ * Usage: coll-reduce-local [count] [repetitions] */
+
+#include <mpi.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xbt/xbt_os_time.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(reduce_local, "Messages of the reduction kernels benchmark");
+
+#define SCALAR_LOOP(type, expr)                                                                                        \
+  {                                                                                                                    \
+    const type* x = (const type*)(in);                                                                                 \
+    type* y       = (type*)(inout);                                                                                    \
+    for (int i = 0; i < *length; i++)                                                                                  \
+      y[i] = (expr);                                                                                                   \
+  }
+
+#define SCALAR_OPS(type)                                                                                               \
+  if (op == MPI_SUM)                                                                                                   \
+    SCALAR_LOOP(type, x[i] + y[i])                                                                                     \
+  else if (op == MPI_PROD)                                                                                             \
+    SCALAR_LOOP(type, x[i] * y[i])                                                                                     \
+  else if (op == MPI_MIN)                                                                                              \
+    SCALAR_LOOP(type, x[i] < y[i] ? x[i] : y[i])                                                                       \
+  else if (op == MPI_MAX)                                                                                              \
+    SCALAR_LOOP(type, x[i] < y[i] ? y[i] : x[i])
+
+#define SCALAR_BITWISE_OPS(type)                                                                                       \
+  if (op == MPI_BAND)                                                                                                  \
+    SCALAR_LOOP(type, x[i] & y[i])                                                                                     \
+  else if (op == MPI_BOR)                                                                                              \
+    SCALAR_LOOP(type, x[i] | y[i])                                                                                     \
+  else if (op == MPI_BXOR)                                                                                             \
+    SCALAR_LOOP(type, x[i] ^ y[i])
+
+static void scalar_reduce(const void* in, void* inout, const int* length, MPI_Datatype type, MPI_Op op)
+{
+  if (type == MPI_FLOAT) {
+    SCALAR_OPS(float)
+  } else if (type == MPI_DOUBLE) {
+    SCALAR_OPS(double)
+  } else if (type == MPI_INT) {
+    SCALAR_OPS(int)
+    SCALAR_BITWISE_OPS(int)
+  } else if (type == MPI_LONG) {
+    SCALAR_OPS(long)
+    SCALAR_BITWISE_OPS(long)
+  } else if (type == MPI_UNSIGNED) {
+    SCALAR_OPS(unsigned int)
+    SCALAR_BITWISE_OPS(unsigned int)
+  } else if (type == MPI_UNSIGNED_LONG) {
+    SCALAR_OPS(unsigned long)
+    SCALAR_BITWISE_OPS(unsigned long)
+  } else if (type == MPI_BYTE) {
+    SCALAR_BITWISE_OPS(int8_t)
+  } else if (type == MPI_UNSIGNED_CHAR) {
+    SCALAR_BITWISE_OPS(unsigned char)
+  }
+}
+
+static void fill(void* buffer, int count, MPI_Datatype type, int seed)
+{
+  for (int i = 0; i < count; i++) {
+    int value = (i * 7 + seed) % 13 + 1;
+    if (type == MPI_FLOAT)
+      ((float*)buffer)[i] = (float)value / 4;
+    else if (type == MPI_DOUBLE)
+      ((double*)buffer)[i] = (double)value / 4;
+    else if (type == MPI_INT)
+      ((int*)buffer)[i] = value;
+    else if (type == MPI_LONG)
+      ((long*)buffer)[i] = value;
+    else if (type == MPI_UNSIGNED)
+      ((unsigned int*)buffer)[i] = value;
+    else if (type == MPI_UNSIGNED_LONG)
+      ((unsigned long*)buffer)[i] = value;
+    else if (type == MPI_BYTE)
+      ((int8_t*)buffer)[i] = (int8_t)value;
+    else
+      ((unsigned char*)buffer)[i] = (unsigned char)value;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int count       = 1 << 16;
+  int repetitions = 100;
+  MPI_Datatype types[]     = {MPI_FLOAT,    MPI_DOUBLE,          MPI_INT,    MPI_LONG,
+                              MPI_UNSIGNED, MPI_UNSIGNED_LONG,   MPI_BYTE,   MPI_UNSIGNED_CHAR};
+  const char* type_names[] = {"MPI_FLOAT",    "MPI_DOUBLE",        "MPI_INT",  "MPI_LONG",
+                              "MPI_UNSIGNED", "MPI_UNSIGNED_LONG", "MPI_BYTE", "MPI_UNSIGNED_CHAR"};
+  MPI_Op ops[]             = {MPI_SUM, MPI_PROD, MPI_MIN, MPI_MAX, MPI_BAND, MPI_BOR, MPI_BXOR};
+  const char* op_names[]   = {"MPI_SUM", "MPI_PROD", "MPI_MIN", "MPI_MAX", "MPI_BAND", "MPI_BOR", "MPI_BXOR"};
+
+  MPI_Init(&argc, &argv);
+  if (argc > 1)
+    count = atoi(argv[1]);
+  if (argc > 2)
+    repetitions = atoi(argv[2]);
+
+  size_t size          = count * sizeof(long) > count * sizeof(double) ? count * sizeof(long) : count * sizeof(double);
+  void* in             = malloc(size);
+  void* inout          = malloc(size);
+  void* expected       = malloc(size);
+  xbt_os_timer_t timer = xbt_os_timer_new();
+
+  for (int t = 0; t < 8; t++) {
+    int type_size;
+    MPI_Type_size(types[t], &type_size);
+    for (int o = 0; o < 7; o++) {
+      if (o >= 4 && (types[t] == MPI_FLOAT || types[t] == MPI_DOUBLE))
+        continue; // no bitwise operation on floating point values
+      if (o < 4 && (types[t] == MPI_BYTE || types[t] == MPI_UNSIGNED_CHAR))
+        continue; // only the bitwise operations have dedicated kernels on bytes
+
+      /* PROD would overflow or vanish after a few repetitions, so only do one of them */
+      int reps = ops[o] == MPI_PROD ? 1 : repetitions;
+      fill(in, count, types[t], 1);
+      fill(expected, count, types[t], 2);
+      xbt_os_walltimer_start(timer);
+      for (int r = 0; r < reps; r++)
+        scalar_reduce(in, expected, &count, types[t], ops[o]);
+      xbt_os_walltimer_stop(timer);
+      double scalar_time = xbt_os_timer_elapsed(timer);
+
+      fill(inout, count, types[t], 2);
+      xbt_os_walltimer_start(timer);
+      for (int r = 0; r < reps; r++)
+        MPI_Reduce_local(in, inout, count, types[t], ops[o]);
+      xbt_os_walltimer_stop(timer);
+      double kernel_time = xbt_os_timer_elapsed(timer);
+
+      if (memcmp(inout, expected, (size_t)count * type_size) == 0)
+        XBT_INFO("%s on %s: ok", op_names[o], type_names[t]);
+      else
+        XBT_ERROR("%s on %s: wrong result", op_names[o], type_names[t]);
+      XBT_VERB("%s on %s: %.3f ns per element (scalar loop: %.3f ns per element)", op_names[o], type_names[t],
+               kernel_time * 1e9 / ((double)reps * count), scalar_time * 1e9 / ((double)reps * count));
+    }
+  }
+
+  xbt_os_timer_free(timer);
+  free(in);
+  free(inout);
+  free(expected);
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,150 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Check and benchmark bcast, allreduce and alltoall on hierarchical platforms, to compare the topology-aware
+ * algorithms (--cfg=smpi/<coll>:topo) with the default ones. The collectives are then checked on a duplicate and on a
+ * split of MPI_COMM_WORLD, which are distinct objects on each rank.
+ *
+ * The simulated time of each collective is deterministic, and checked by the tesh file. Use
+ * --log=coll_topo.thres:verbose to display the wall-clock time of the simulation of each collective.
+ *
+ * Usage: coll-topo [count] */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <xbt/xbt_os_time.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(coll_topo, "Messages of the topology-aware collectives benchmark");
+
+static void report(const char* name, int count, double start, xbt_os_timer_t timer)
+{
+  double elapsed = MPI_Wtime() - start;
+  double max_elapsed;
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  if (rank == 0) {
+    xbt_os_walltimer_stop(timer);
+    XBT_INFO("%s of %d ints: %f", name, count, max_elapsed);
+    XBT_VERB("%s simulated in %f seconds", name, xbt_os_timer_elapsed(timer));
+  }
+}
+
+/* Runs the three collectives on comm, and returns the amount of wrong values */
+static int check_comm(MPI_Comm comm, int count, int* sbuf, int* rbuf)
+{
+  int rank;
+  int size;
+  int errors = 0;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  for (int i = 0; i < count; i++)
+    sbuf[i] = rank == size - 1 ? i : -1;
+  MPI_Bcast(sbuf, count, MPI_INT, size - 1, comm);
+  for (int i = 0; i < count; i++)
+    if (sbuf[i] != i)
+      errors++;
+
+  for (int i = 0; i < count; i++)
+    sbuf[i] = rank + i;
+  MPI_Allreduce(sbuf, rbuf, count, MPI_INT, MPI_SUM, comm);
+  for (int i = 0; i < count; i++)
+    if (rbuf[i] != size * (size - 1) / 2 + size * i)
+      errors++;
+
+  for (int i = 0; i < count * size; i++)
+    sbuf[i] = rank * count * size + i;
+  MPI_Alltoall(sbuf, count, MPI_INT, rbuf, count, MPI_INT, comm);
+  for (int src = 0; src < size; src++)
+    for (int i = 0; i < count; i++)
+      if (rbuf[src * count + i] != src * count * size + rank * count + i)
+        errors++;
+  return errors;
+}
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+  int count  = 1024;
+  int errors = 0;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (argc > 1)
+    count = atoi(argv[1]);
+
+  int* sbuf = malloc((size_t)count * size * sizeof(int));
+  int* rbuf = malloc((size_t)count * size * sizeof(int));
+  xbt_os_timer_t timer = xbt_os_timer_new();
+
+  /* The first call builds the sub-communicators of the topology-aware algorithms: do it once before timing anything */
+  MPI_Bcast(sbuf, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  for (int i = 0; i < count; i++)
+    sbuf[i] = rank == size - 1 ? i : -1;
+  MPI_Barrier(MPI_COMM_WORLD);
+  xbt_os_walltimer_start(timer);
+  double start = MPI_Wtime();
+  MPI_Bcast(sbuf, count, MPI_INT, size - 1, MPI_COMM_WORLD);
+  report("bcast", count, start, timer);
+  for (int i = 0; i < count; i++)
+    if (sbuf[i] != i)
+      errors++;
+
+  for (int i = 0; i < count; i++)
+    sbuf[i] = rank + i;
+  MPI_Barrier(MPI_COMM_WORLD);
+  xbt_os_walltimer_start(timer);
+  start = MPI_Wtime();
+  MPI_Allreduce(sbuf, rbuf, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  report("allreduce", count, start, timer);
+  for (int i = 0; i < count; i++)
+    if (rbuf[i] != size * (size - 1) / 2 + size * i)
+      errors++;
+
+  for (int i = 0; i < count * size; i++)
+    sbuf[i] = rank * count * size + i;
+  MPI_Barrier(MPI_COMM_WORLD);
+  xbt_os_walltimer_start(timer);
+  start = MPI_Wtime();
+  MPI_Alltoall(sbuf, count, MPI_INT, rbuf, count, MPI_INT, MPI_COMM_WORLD);
+  report("alltoall", count, start, timer);
+  for (int src = 0; src < size; src++)
+    for (int i = 0; i < count; i++)
+      if (rbuf[src * count + i] != src * count * size + rank * count + i)
+        errors++;
+
+  int total_errors;
+  MPI_Reduce(&errors, &total_errors, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (rank == 0)
+    XBT_INFO("%s", total_errors == 0 ? "All results are correct" : "Wrong results");
+
+  MPI_Comm dup;
+  MPI_Comm_dup(MPI_COMM_WORLD, &dup);
+  errors = check_comm(dup, count, sbuf, rbuf);
+  MPI_Comm_free(&dup);
+  MPI_Reduce(&errors, &total_errors, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (rank == 0)
+    XBT_INFO("%s on a duplicate of MPI_COMM_WORLD", total_errors == 0 ? "All results are correct" : "Wrong results");
+
+  MPI_Comm split;
+  MPI_Comm_split(MPI_COMM_WORLD, rank < size / 2, rank, &split);
+  errors = check_comm(split, count, sbuf, rbuf);
+  MPI_Comm_free(&split);
+  MPI_Reduce(&errors, &total_errors, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (rank == 0)
+    XBT_INFO("%s on halves of MPI_COMM_WORLD", total_errors == 0 ? "All results are correct" : "Wrong results");
+
+  xbt_os_timer_free(timer);
+  free(sbuf);
+  free(rbuf);
+  MPI_Finalize();
+  return 0;
+}
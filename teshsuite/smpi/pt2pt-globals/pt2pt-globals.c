@@ -0,0 +1,89 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Globals-heavy benchmark of the privatization: the ranks update large global arrays and exchange them in a ring,
+ * so that the messages are sent from and received into the privatized globals, with many context switches.
+ *
+ * Usage: pt2pt-globals [iterations]
+ *
+ * Use --log=globals.thres:verbose to display the wall-clock time of the exchanges. */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <xbt/xbt_os_time.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(globals, "Messages of the privatization benchmark");
+
+#define FIELD_SIZE 65536
+#define SMALL_SIZE 64
+
+static double field[FIELD_SIZE];
+static double halo[FIELD_SIZE];
+static int small_field[SMALL_SIZE];
+static int small_halo[SMALL_SIZE];
+static int errors = 0;
+
+static void check(int iteration, int rank, int prev)
+{
+  for (int i = 0; i < FIELD_SIZE; i++)
+    if (halo[i] != (double)(prev * FIELD_SIZE + i + iteration)) {
+      errors++;
+      break;
+    }
+  for (int i = 0; i < SMALL_SIZE; i++)
+    if (small_halo[i] != prev + iteration) {
+      errors++;
+      break;
+    }
+  if (errors == 1)
+    XBT_ERROR("Rank %d got wrong data from rank %d at iteration %d", rank, prev, iteration);
+}
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+  int iterations = 10;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (argc > 1)
+    iterations = atoi(argv[1]);
+  int next = (rank + 1) % size;
+  int prev = (rank + size - 1) % size;
+
+  xbt_os_timer_t timer = xbt_os_timer_new();
+  MPI_Barrier(MPI_COMM_WORLD);
+  xbt_os_walltimer_start(timer);
+  for (int iteration = 0; iteration < iterations; iteration++) {
+    for (int i = 0; i < FIELD_SIZE; i++)
+      field[i] = (double)(rank * FIELD_SIZE + i + iteration);
+    for (int i = 0; i < SMALL_SIZE; i++)
+      small_field[i] = rank + iteration;
+    /* The large message is sent in rendez-vous mode, the small one is detached */
+    MPI_Sendrecv(field, FIELD_SIZE, MPI_DOUBLE, next, 0, halo, FIELD_SIZE, MPI_DOUBLE, prev, 0, MPI_COMM_WORLD,
+                 MPI_STATUS_IGNORE);
+    MPI_Sendrecv(small_field, SMALL_SIZE, MPI_INT, next, 1, small_halo, SMALL_SIZE, MPI_INT, prev, 1, MPI_COMM_WORLD,
+                 MPI_STATUS_IGNORE);
+    check(iteration, rank, prev);
+  }
+  int total_errors;
+  MPI_Reduce(&errors, &total_errors, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  xbt_os_walltimer_stop(timer);
+
+  if (rank == 0) {
+    if (total_errors == 0)
+      XBT_INFO("%d ranks exchanged their globals %d times", size, iterations);
+    else
+      XBT_ERROR("%d errors detected", total_errors);
+    XBT_VERB("Wall-clock time: %f s", xbt_os_timer_elapsed(timer));
+  }
+  xbt_os_timer_free(timer);
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,69 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Message rate benchmark: the ranks are paired and exchange small messages in ping-pong.
+ *
+ * Usage: pt2pt-msgrate [iterations]
+ *
+ * The simulated time is deterministic, and checked by the tesh file. Use
+ * --log=msgrate.thres:verbose to display the amount of simulated messages per second of wall-clock time. */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <xbt/xbt_os_time.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(msgrate, "Messages of the message rate benchmark");
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+  int iterations = 1000;
+  int value      = 0;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (argc > 1)
+    iterations = atoi(argv[1]);
+  if (size % 2 != 0) {
+    if (rank == 0)
+      XBT_ERROR("This benchmark needs an even amount of ranks");
+    MPI_Finalize();
+    return EXIT_FAILURE;
+  }
+
+  xbt_os_timer_t timer = xbt_os_timer_new();
+  MPI_Barrier(MPI_COMM_WORLD);
+  xbt_os_walltimer_start(timer);
+  int peer = rank % 2 == 0 ? rank + 1 : rank - 1;
+  for (int i = 0; i < iterations; i++) {
+    if (rank % 2 == 0) {
+      value = i;
+      MPI_Send(&value, 1, MPI_INT, peer, 42, MPI_COMM_WORLD);
+      MPI_Recv(&value, 1, MPI_INT, peer, 42, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      if (value != i + 1)
+        XBT_ERROR("Rank %d received %d instead of %d", rank, value, i + 1);
+    } else {
+      MPI_Recv(&value, 1, MPI_INT, peer, 42, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      value++;
+      MPI_Send(&value, 1, MPI_INT, peer, 42, MPI_COMM_WORLD);
+    }
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  xbt_os_walltimer_stop(timer);
+
+  if (rank == 0) {
+    double messages = 2.0 * iterations * (size / 2);
+    XBT_INFO("%.0f messages exchanged by %d ranks", messages, size);
+    XBT_VERB("Wall-clock time: %f s (%.0f messages per second)", xbt_os_timer_elapsed(timer),
+             messages / xbt_os_timer_elapsed(timer));
+  }
+  xbt_os_timer_free(timer);
+  MPI_Finalize();
+  return 0;
+}
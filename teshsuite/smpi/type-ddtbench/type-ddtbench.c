@@ -0,0 +1,269 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Check and benchmark the packing of derived datatypes, on access patterns inspired from the DDTBench suite.
+ *
+ * For each pattern, MPI_Pack and MPI_Unpack are compared to the manual loop that an application would otherwise use,
+ * and the datatype is used to send the data to the other rank. Use --log=ddtbench.thres:verbose to display the time
+ * spent by both versions.
+ *
+ * Usage: type-ddtbench [repetitions] */
+
+#include <mpi.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xbt/xbt_os_time.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(ddtbench, "Messages of the derived datatypes benchmark");
+
+#define N 16 /* edge of the 3D grids */
+#define LAMMPS_BLOCKS 128
+#define PARTICLES 512
+
+typedef struct {
+  double pos[3];
+  int id;
+  double v;
+} particle_t;
+
+/* Copy len bytes between the application buffer and the packed one, and return the new position in the packed one */
+static size_t move(char* buf, size_t offset, char* packed, size_t position, size_t len, int pack)
+{
+  if (pack)
+    memcpy(packed + position, buf + offset, len);
+  else
+    memcpy(buf + offset, packed + position, len);
+  return position + len;
+}
+
+/* NAS MG: x face of a 3D grid of doubles, one element per row */
+static MPI_Datatype nas_mg_x_type(void)
+{
+  MPI_Datatype type;
+  MPI_Type_vector(N * N, 1, N, MPI_DOUBLE, &type);
+  return type;
+}
+
+static void nas_mg_x_manual(char* buf, char* packed, int pack)
+{
+  size_t position = 0;
+  for (int k = 0; k < N * N; k++)
+    position = move(buf, k * N * sizeof(double), packed, position, sizeof(double), pack);
+}
+
+/* NAS MG: y face of a 3D grid of doubles, one row per plane */
+static MPI_Datatype nas_mg_y_type(void)
+{
+  MPI_Datatype type;
+  MPI_Type_vector(N, N, N * N, MPI_DOUBLE, &type);
+  return type;
+}
+
+static void nas_mg_y_manual(char* buf, char* packed, int pack)
+{
+  size_t position = 0;
+  for (int z = 0; z < N; z++)
+    position = move(buf, z * N * N * sizeof(double), packed, position, N * sizeof(double), pack);
+}
+
+/* LAMMPS: irregular blocks of doubles */
+static MPI_Datatype lammps_type(void)
+{
+  int lengths[LAMMPS_BLOCKS];
+  int displacements[LAMMPS_BLOCKS];
+  for (int i = 0; i < LAMMPS_BLOCKS; i++) {
+    lengths[i]       = i % 4 + 1;
+    displacements[i] = i * 6;
+  }
+  MPI_Datatype type;
+  MPI_Type_indexed(LAMMPS_BLOCKS, lengths, displacements, MPI_DOUBLE, &type);
+  return type;
+}
+
+static void lammps_manual(char* buf, char* packed, int pack)
+{
+  size_t position = 0;
+  for (int i = 0; i < LAMMPS_BLOCKS; i++)
+    position = move(buf, i * 6 * sizeof(double), packed, position, (i % 4 + 1) * sizeof(double), pack);
+}
+
+/* MILC: x face of a 3D lattice of su3 vectors (6 floats), as a vector of vectors */
+static MPI_Datatype milc_type(void)
+{
+  MPI_Datatype plane;
+  MPI_Datatype type;
+  MPI_Type_vector(N, 6, 6 * N, MPI_FLOAT, &plane);
+  MPI_Type_create_hvector(N, 1, N * N * 6 * sizeof(float), plane, &type);
+  MPI_Type_free(&plane);
+  return type;
+}
+
+static void milc_manual(char* buf, char* packed, int pack)
+{
+  size_t position = 0;
+  for (int z = 0; z < N; z++)
+    for (int y = 0; y < N; y++)
+      position = move(buf, (z * N + y) * N * 6 * sizeof(float), packed, position, 6 * sizeof(float), pack);
+}
+
+/* FFT: transpose of a matrix of complex values, as a contiguous sequence of resized columns */
+static MPI_Datatype fft_type(void)
+{
+  MPI_Datatype column;
+  MPI_Datatype resized;
+  MPI_Datatype type;
+  MPI_Type_vector(N, 2, 2 * N, MPI_DOUBLE, &column);
+  MPI_Type_create_resized(column, 0, 2 * sizeof(double), &resized);
+  MPI_Type_contiguous(N, resized, &type);
+  MPI_Type_free(&column);
+  MPI_Type_free(&resized);
+  return type;
+}
+
+static void fft_manual(char* buf, char* packed, int pack)
+{
+  size_t position = 0;
+  for (int c = 0; c < N; c++)
+    for (int r = 0; r < N; r++)
+      position = move(buf, (r * N + c) * 2 * sizeof(double), packed, position, 2 * sizeof(double), pack);
+}
+
+/* Halo of particles: every other element of an array of structures */
+static MPI_Datatype particles_type(void)
+{
+  int lengths[3]                  = {3, 1, 1};
+  MPI_Aint displacements[3]       = {offsetof(particle_t, pos), offsetof(particle_t, id), offsetof(particle_t, v)};
+  MPI_Datatype types[3]           = {MPI_DOUBLE, MPI_INT, MPI_DOUBLE};
+  MPI_Datatype particle;
+  MPI_Datatype type;
+  MPI_Type_create_struct(3, lengths, displacements, types, &particle);
+  MPI_Type_vector(PARTICLES / 2, 1, 2, particle, &type);
+  MPI_Type_free(&particle);
+  return type;
+}
+
+static void particles_manual(char* buf, char* packed, int pack)
+{
+  size_t position = 0;
+  for (int i = 0; i < PARTICLES; i += 2) {
+    size_t offset = i * sizeof(particle_t);
+    position      = move(buf, offset + offsetof(particle_t, pos), packed, position, 3 * sizeof(double), pack);
+    position      = move(buf, offset + offsetof(particle_t, id), packed, position, sizeof(int), pack);
+    position      = move(buf, offset + offsetof(particle_t, v), packed, position, sizeof(double), pack);
+  }
+}
+
+typedef struct {
+  const char* name;
+  size_t buffer_size;
+  MPI_Datatype (*create)(void);
+  void (*manual)(char* buf, char* packed, int pack);
+} pattern_t;
+
+static const pattern_t patterns[] = {
+    {"NAS_MG_x", N * N * N * sizeof(double), nas_mg_x_type, nas_mg_x_manual},
+    {"NAS_MG_y", N * N * N * sizeof(double), nas_mg_y_type, nas_mg_y_manual},
+    {"LAMMPS", LAMMPS_BLOCKS * 6 * sizeof(double), lammps_type, lammps_manual},
+    {"MILC", N * N * N * 6 * sizeof(float), milc_type, milc_manual},
+    {"FFT", N * N * 2 * sizeof(double), fft_type, fft_manual},
+    {"particles", PARTICLES * sizeof(particle_t), particles_type, particles_manual},
+};
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int repetitions = 100;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (argc > 1)
+    repetitions = atoi(argv[1]);
+  xbt_os_timer_t timer = xbt_os_timer_new();
+
+  for (unsigned p = 0; p < sizeof patterns / sizeof patterns[0]; p++) {
+    const pattern_t* pattern = &patterns[p];
+    MPI_Datatype type        = pattern->create();
+    MPI_Type_commit(&type);
+    int packed_size;
+    MPI_Type_size(type, &packed_size);
+
+    char* buf      = calloc(1, pattern->buffer_size);
+    char* expected = calloc(1, pattern->buffer_size);
+    char* packed   = malloc(packed_size);
+    char* manual   = malloc(packed_size);
+    for (size_t i = 0; i < pattern->buffer_size; i++)
+      buf[i] = (char)(i * 7 + rank);
+
+    /* Pack */
+    int errors = 0;
+    pattern->manual(buf, manual, 1);
+    int position = 0;
+    MPI_Pack(buf, 1, type, packed, packed_size, &position, MPI_COMM_WORLD);
+    if (position != packed_size || memcmp(packed, manual, packed_size) != 0)
+      errors++;
+
+    /* Unpack to an empty buffer */
+    char* unpacked = calloc(1, pattern->buffer_size);
+    pattern->manual(expected, manual, 0);
+    position = 0;
+    MPI_Unpack(manual, packed_size, &position, unpacked, 1, type, MPI_COMM_WORLD);
+    if (memcmp(unpacked, expected, pattern->buffer_size) != 0)
+      errors++;
+
+    /* Exchange the data with the other rank */
+    memset(unpacked, 0, pattern->buffer_size);
+    MPI_Sendrecv(buf, 1, type, 1 - rank, 0, unpacked, 1, type, 1 - rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    for (size_t i = 0; i < pattern->buffer_size; i++)
+      buf[i] = (char)(i * 7 + 1 - rank);
+    memset(expected, 0, pattern->buffer_size);
+    pattern->manual(buf, manual, 1);
+    pattern->manual(expected, manual, 0);
+    if (memcmp(unpacked, expected, pattern->buffer_size) != 0)
+      errors++;
+
+    /* Time both versions */
+    xbt_os_walltimer_start(timer);
+    for (int r = 0; r < repetitions; r++) {
+      pattern->manual(buf, manual, 1);
+      pattern->manual(unpacked, manual, 0);
+    }
+    xbt_os_walltimer_stop(timer);
+    double manual_time = xbt_os_timer_elapsed(timer);
+    xbt_os_walltimer_start(timer);
+    for (int r = 0; r < repetitions; r++) {
+      position = 0;
+      MPI_Pack(buf, 1, type, packed, packed_size, &position, MPI_COMM_WORLD);
+      position = 0;
+      MPI_Unpack(packed, packed_size, &position, unpacked, 1, type, MPI_COMM_WORLD);
+    }
+    xbt_os_walltimer_stop(timer);
+    double mpi_time = xbt_os_timer_elapsed(timer);
+
+    if (rank == 0) {
+      if (errors == 0)
+        XBT_INFO("%s: ok (%d bytes)", pattern->name, packed_size);
+      else
+        XBT_ERROR("%s: %d errors", pattern->name, errors);
+      XBT_VERB("%s: %.3f us per pack/unpack (manual loops: %.3f us)", pattern->name, mpi_time * 1e6 / repetitions,
+               manual_time * 1e6 / repetitions);
+    } else if (errors != 0) {
+      XBT_ERROR("%s: %d errors", pattern->name, errors);
+    }
+
+    free(buf);
+    free(expected);
+    free(packed);
+    free(manual);
+    free(unpacked);
+    MPI_Type_free(&type);
+  }
+
+  xbt_os_timer_free(timer);
+  MPI_Finalize();
+  return 0;
+}
@@ -126,6 +126,7 @@ set(SMPI_SRC
   src/smpi/colls/allreduce/allreduce-smp-rsag-lr.cpp
   src/smpi/colls/allreduce/allreduce-smp-rsag-rab.cpp
   src/smpi/colls/allreduce/allreduce-smp-rsag.cpp
+  src/smpi/colls/allreduce/allreduce-topo.cpp
   src/smpi/colls/alltoall/alltoall-2dmesh.cpp
   src/smpi/colls/alltoall/alltoall-3dmesh.cpp
   src/smpi/colls/alltoall/alltoall-basic-linear.cpp
@@ -140,6 +141,7 @@ set(SMPI_SRC
   src/smpi/colls/alltoall/alltoall-ring-mpi-barrier.cpp
   src/smpi/colls/alltoall/alltoall-ring-one-barrier.cpp
   src/smpi/colls/alltoall/alltoall-ring.cpp
+  src/smpi/colls/alltoall/alltoall-topo.cpp
   src/smpi/colls/alltoallv/alltoallv-bruck.cpp
   src/smpi/colls/alltoallv/alltoallv-ompi-basic-linear.cpp
   src/smpi/colls/alltoallv/alltoallv-pair-light-barrier.cpp
@@ -170,6 +172,7 @@ set(SMPI_SRC
   src/smpi/colls/bcast/bcast-ompi-split-bintree.cpp
   src/smpi/colls/bcast/bcast-scatter-LR-allgather.cpp
   src/smpi/colls/bcast/bcast-scatter-rdb-allgather.cpp
+  src/smpi/colls/bcast/bcast-topo.cpp
   src/smpi/colls/coll_tuned_topo.cpp
   src/smpi/colls/colls_global.cpp
   src/smpi/colls/gather/gather-mvapich.cpp
@@ -195,6 +198,7 @@ set(SMPI_SRC
   src/smpi/colls/smpi_mvapich2_selector.cpp
   src/smpi/colls/smpi_nbc_impl.cpp
   src/smpi/colls/smpi_openmpi_selector.cpp
+  src/smpi/colls/smpi_table_selector.cpp
   src/smpi/include/smpi_actor.hpp
   src/smpi/include/smpi_coll.hpp
   src/smpi/include/smpi_comm.hpp
@@ -330,6 +334,8 @@ set(SURF_SRC
   src/kernel/resource/profile/Profile.cpp
   src/kernel/resource/profile/Profile.hpp
   src/kernel/resource/profile/ProfileBuilder.cpp
+  src/kernel/resource/profile/ProfileReader.cpp
+  src/kernel/resource/profile/ProfileReader.hpp
   src/kernel/resource/profile/StochasticDatedValue.cpp
   src/kernel/resource/profile/StochasticDatedValue.hpp
 
@@ -520,6 +526,7 @@ set(MC_SRC
   src/mc/explo/UdporChecker.cpp
   src/mc/explo/UdporChecker.hpp
 
+  src/mc/inspect/DwarfCache.cpp
   src/mc/inspect/DwarfExpression.cpp
   src/mc/inspect/DwarfExpression.hpp
   src/mc/inspect/Frame.cpp
@@ -586,6 +593,7 @@ set(MC_SRC
   src/mc/mc_forward.hpp
   src/mc/mc_private.hpp
   src/mc/mc_record.cpp
+  src/mc/mc_serialization.hpp
   src/mc/udpor_global.cpp
   src/mc/udpor_global.hpp
 
@@ -985,6 +993,7 @@ set(CMAKEFILES_TXT
   teshsuite/xbt/CMakeLists.txt
   tools/CMakeLists.txt
   tools/graphicator/CMakeLists.txt
+  tools/profile_converter/CMakeLists.txt
   tools/tesh/CMakeLists.txt
   )
 
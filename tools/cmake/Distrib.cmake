@@ -41,6 +41,14 @@ add_custom_target(simgrid_convert_TI_traces ALL
     COMMENT "Install ${CMAKE_BINARY_DIR}/bin/simgrid_convert_TI_traces"
     COMMAND ${CMAKE_COMMAND} -E copy ${CMAKE_HOME_DIRECTORY}/tools/simgrid_convert_TI_traces.py ${CMAKE_BINARY_DIR}/bin/simgrid_convert_TI_traces)
 
+install(PROGRAMS ${CMAKE_HOME_DIRECTORY}/tools/simgrid_tune_collectives.py
+  DESTINATION ${CMAKE_INSTALL_BINDIR}/
+  RENAME simgrid_tune_collectives)
+
+add_custom_target(simgrid_tune_collectives ALL
+    COMMENT "Install ${CMAKE_BINARY_DIR}/bin/simgrid_tune_collectives"
+    COMMAND ${CMAKE_COMMAND} -E copy ${CMAKE_HOME_DIRECTORY}/tools/simgrid_tune_collectives.py ${CMAKE_BINARY_DIR}/bin/simgrid_tune_collectives)
+
 # libraries
 install(TARGETS simgrid DESTINATION ${CMAKE_INSTALL_LIBDIR}/)
 
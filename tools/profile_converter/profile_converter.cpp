@@ -0,0 +1,45 @@
+/* Copyright (c) 2023. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Converts the deterministic profiles to the binary format that SimGrid streams from disk, or dumps such a binary
+ * profile back into the textual syntax. */
+
+#include "simgrid/s4u.hpp"
+#include "src/kernel/resource/profile/ProfileReader.hpp"
+
+#include <cstring>
+
+namespace profile = simgrid::kernel::profile;
+
+static void dump(const std::string& filename)
+{
+  auto file = profile::ProfileFile::open(filename);
+  profile::ProfileFile::Cursor cursor;
+  std::vector<profile::DatedValue> events;
+  double date = 0;
+  while (file->read_events(cursor, 4096, events) > 0) {
+    for (auto const& dv : events) {
+      date += dv.date_;
+      printf("%g %g\n", date, dv.value_);
+    }
+    events.clear();
+  }
+  if (file->get_repeat_delay() >= 0)
+    printf("LOOPAFTER %g\n", file->get_repeat_delay());
+}
+
+int main(int argc, char** argv)
+{
+  simgrid::s4u::Engine e(&argc, argv);
+  xbt_assert(argc == 3, "Usage: %s <profile> <binary_profile>\n       %s --dump <profile>", argv[0], argv[0]);
+
+  if (strcmp(argv[1], "--dump") == 0) {
+    dump(argv[2]);
+  } else {
+    profile::write_binary_profile(argv[1], argv[2]);
+  }
+  return 0;
+}
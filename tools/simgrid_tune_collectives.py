@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2023. The SimGrid Team. All rights reserved.
+
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the license (GNU LGPL) which comes with this package.
+
+'''
+This script computes the decision table used by the 'table' collective selector
+of SMPI (--cfg=smpi/coll-selector:table --cfg=smpi/coll-table:<file>).
+
+For each collective and each number of processes, it runs a benchmark (such as
+examples/smpi/coll_tuning) with the automatic selector of this collective,
+which times all the algorithms for each message size and records the fastest
+one. The simulations are independent, so they are run in parallel.
+
+The resulting table only keeps, for each collective and number of processes,
+the largest message size of each range of sizes where the same algorithm wins.
+At runtime, SMPI uses the entry of the largest number of processes that does not
+exceed the size of the communicator, and the first entry whose message size is
+not smaller than the actual message size.
+
+Example:
+  simgrid_tune_collectives -p cluster.xml -f hostfile -b ./smpi_coll_tuning \\
+      --np 4,16,64 --colls bcast,allreduce -j 8 -o decisions.txt
+'''
+
+import argparse
+import concurrent.futures
+import os
+import subprocess
+import sys
+import tempfile
+
+DEFAULT_COLLS = ['gather', 'allgather', 'alltoall', 'bcast', 'reduce', 'allreduce', 'reduce_scatter', 'scatter']
+
+
+def tune(args, coll, nprocs):
+    '''Runs the benchmark of one collective on nprocs processes, and returns the recorded decisions'''
+    with tempfile.TemporaryDirectory(prefix='simgrid_tune_') as tmpdir:
+        output = os.path.join(tmpdir, 'decisions.txt')
+        command = [args.smpirun, '-platform', args.platform, '-np', str(nprocs)]
+        if args.hostfile:
+            command += ['-hostfile', args.hostfile]
+        command += ['--cfg=smpi/{}:automatic'.format(coll), '--cfg=smpi/coll-table-output:' + output,
+                    '--cfg=smpi/simulate-computation:no', '--log=smpi_colls.thres:error', '--log=smpi_coll.thres:warning']
+        command += args.smpirun_args
+        command += [args.bench, coll, str(args.max_size)]
+        result = subprocess.run(command, cwd=tmpdir, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                                universal_newlines=True, check=False)
+        if result.returncode != 0:
+            tail = result.stderr.strip().split('\n')[-1:]
+            print('Tuning {} on {} processes failed: {}'.format(coll, nprocs, ''.join(tail)), file=sys.stderr)
+            return []
+        decisions = []
+        with open(output) as recorded:
+            for line in recorded:
+                fields = line.split()
+                if len(fields) >= 5 and fields[0] == coll:
+                    decisions.append((fields[0], int(fields[1]), int(fields[2]), fields[3], float(fields[4])))
+        return decisions
+
+
+def merge(decisions):
+    '''Keeps the fastest algorithm of each message size, and merges the consecutive sizes using the same algorithm'''
+    best = {}
+    for (coll, nprocs, size, algo, time) in decisions:
+        key = (coll, nprocs, size)
+        if key not in best or time < best[key][1]:
+            best[key] = (algo, time)
+
+    table = []
+    for (coll, nprocs, size) in sorted(best):
+        algo = best[(coll, nprocs, size)][0]
+        if table and table[-1][0] == coll and table[-1][1] == nprocs and table[-1][3] == algo:
+            table[-1] = (coll, nprocs, size, algo)
+        else:
+            table.append((coll, nprocs, size, algo))
+    return table
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compute the decision table of the SMPI table collective selector',
+                                     formatter_class=argparse.RawDescriptionHelpFormatter, epilog=__doc__)
+    parser.add_argument('-p', '--platform', required=True, help='platform file to tune the collectives for')
+    parser.add_argument('-f', '--hostfile', help='hostfile given to smpirun')
+    parser.add_argument('-b', '--bench', required=True,
+                        help='benchmark taking a collective name and a maximal message size (see examples/smpi/coll_tuning)')
+    parser.add_argument('--np', default='4,8,16', help='comma-separated numbers of processes (default: %(default)s)')
+    parser.add_argument('--colls', default=','.join(DEFAULT_COLLS),
+                        help='comma-separated collectives to tune (default: %(default)s)')
+    parser.add_argument('--max-size', type=int, default=1 << 20, help='largest message size, in bytes (default: %(default)s)')
+    parser.add_argument('--smpirun', default='smpirun', help='smpirun script to use (default: %(default)s)')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(), help='number of simulations run in parallel')
+    parser.add_argument('-o', '--output', default='coll_table.txt', help='decision table to write (default: %(default)s)')
+    parser.add_argument('smpirun_args', nargs=argparse.REMAINDER, help='additional arguments passed to smpirun')
+    args = parser.parse_args()
+    args.bench = os.path.abspath(args.bench)
+    args.platform = os.path.abspath(args.platform)
+    if args.hostfile:
+        args.hostfile = os.path.abspath(args.hostfile)
+    if os.sep in args.smpirun:
+        args.smpirun = os.path.abspath(args.smpirun)
+    if args.smpirun_args and args.smpirun_args[0] == '--':
+        args.smpirun_args = args.smpirun_args[1:]
+
+    colls = args.colls.split(',')
+    sizes = [int(n) for n in args.np.split(',')]
+    decisions = []
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        jobs = [executor.submit(tune, args, coll, nprocs) for coll in colls for nprocs in sizes]
+        for job in concurrent.futures.as_completed(jobs):
+            decisions += job.result()
+
+    table = merge(decisions)
+    with open(args.output, 'w') as out:
+        out.write('# Decision table for --cfg=smpi/coll-selector:table, computed on {}\n'.format(args.platform))
+        out.write('# <collective> <number of processes> <maximal message size> <algorithm>\n')
+        for (coll, nprocs, size, algo) in table:
+            out.write('{} {} {} {}\n'.format(coll, nprocs, size, algo))
+    print('Wrote {} decisions to {}'.format(len(table), args.output))
+
+
+if __name__ == '__main__':
+    main()